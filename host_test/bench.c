@@ -0,0 +1,405 @@
+#include "sim.h"
+#include "test_support.h"
+#include "mock_rmt.h"
+#include "mock_led_strip.h"
+#include "mock_zigbee.h"
+#include "mock_alloc.h"
+#include "came433.h"
+#include "came_timings.h"
+#include "endpoints.h"
+#include "gates.h"
+#include "rf_tx.h"
+#include "ook_encoder.h"
+#include "ook_decoder.h"
+#include "driver/rmt_tx.h"
+#include "esp_timer.h"
+#include "soc/soc_caps.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+/*
+Host benchmarks and golden waveform check. The firmware's RF path
+(gates -> endpoints -> rf_tx -> came433 -> OOK encoder) runs unmodified on
+the RMT model; every burst the model records is compared symbol by symbol
+with a reference built from the CAME_* timings, read back through the
+learning decoder, and timed. Exit status is non-zero on any mismatch.
+
+Timings are host wall-clock: compare them between commits on the same
+machine, not with the ESP32-C6.
+*/
+
+#define BENCH_ITERATIONS 1000
+#define BENCH_PATTERN 0x00A5A5A5       // Alternating bits, masked to the protocol length
+#define BENCH_REPEATS 3
+#define BENCH_CAPTURE_MAX 64
+#define BENCH_GPIO 10                  // Private channel of the encoder benchmark
+#define BENCH_SETTLE_US (100 * 1000)   // After a burst: LED frame, deferred attribute drain
+
+// ====== Helpers ======
+static int64_t bench_wall_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static rmt_symbol_word_t bench_symbol(uint32_t low_us, uint32_t high_us)
+{
+    rmt_symbol_word_t symbol = {
+        .level0 = 0,
+        .duration0 = low_us,
+        .level1 = 1,
+        .duration1 = high_us,
+    };
+    return symbol;
+}
+
+/**
+ * @brief Reference CAME waveform built from the Flipper-validated µs timings, not from the table
+ */
+static size_t bench_came_reference(uint32_t code, uint8_t bits, rmt_symbol_word_t *out)
+{
+    size_t n = 0;
+
+    out[n++] = bench_symbol(CAME_HEADER_DURATION, CAME_START_BIT_DURATION);
+    for (int i = bits - 1; i >= 0; i--) {
+        if ((code >> i) & 1) {
+            out[n++] = bench_symbol(CAME_LONG_GAP, CAME_SHORT_PULSE);
+        } else {
+            out[n++] = bench_symbol(CAME_SHORT_GAP, CAME_LONG_PULSE);
+        }
+    }
+    return n;
+}
+
+static uint32_t bench_symbols_us(const rmt_symbol_word_t *symbols, size_t count)
+{
+    uint32_t total = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        total += symbols[i].duration0 + symbols[i].duration1;
+    }
+    return total;
+}
+
+/**
+ * @brief Feed two copies of a frame, as on air: trailing-sync protocols lock on from the first sync
+ */
+static bool bench_decode(const rmt_symbol_word_t *symbols, size_t count, ook_decoded_t *decoded)
+{
+    ook_decoder_t decoder;
+    ook_decoded_t out;
+    bool found = false;
+
+    ook_decoder_reset(&decoder);
+    for (size_t i = 0; i < 2 * count && !found; i++) {
+        const rmt_symbol_word_t *s = &symbols[i % count];
+        // Both halves every time: a frame may end on either level
+        if (ook_decoder_feed(&decoder, s->level0, s->duration0, &out)) {
+            *decoded = out;
+            found = true;
+        }
+        if (ook_decoder_feed(&decoder, s->level1, s->duration1, &out) && !found) {
+            *decoded = out;
+            found = true;
+        }
+    }
+    if (!found && ook_decoder_flush(&decoder, &out)) {
+        *decoded = out;
+        found = true;
+    }
+    return found;
+}
+
+/**
+ * @brief Play one frame on TX0 the way the RF worker does and return the recorded burst
+ */
+static const mock_rmt_burst_t *bench_send(const ook_frame_t *frame, uint8_t repeats)
+{
+    size_t index = mock_rmt_burst_count();
+
+    esp_err_t ret = came433_start(0, frame, repeats, NULL);
+    if (ret != ESP_OK || mock_rmt_burst_count() != index + 1) {
+        fprintf(stderr, "came433_start: %s\n", esp_err_to_name(ret));
+        return NULL;
+    }
+    sim_run_until(mock_rmt_burst(index)->end_us);
+    came433_finish(0);
+    return mock_rmt_burst(index);
+}
+
+// ====== Encoder Throughput ======
+/**
+ * @brief rmt_transmit() cost per frame with the OOK encoder, against the copy encoder as baseline
+ *
+ * Runs on a private channel before the firmware claims the RMT. The copy
+ * encoder replays the same symbols, so the difference is the OOK encoder's
+ * own work (table lookups, state machine, refills).
+ */
+static void bench_encoder_throughput(void)
+{
+    rmt_tx_channel_config_t config = {
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .gpio_num = BENCH_GPIO,
+        .mem_block_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL,
+        .resolution_hz = 1000000,
+        .trans_queue_depth = 4,
+    };
+    rmt_transmit_config_t tx_config = {.loop_count = 0};
+    rmt_copy_encoder_config_t copy_config = {};
+    rmt_channel_handle_t channel = NULL;
+    rmt_encoder_handle_t ook = NULL;
+    rmt_encoder_handle_t copy = NULL;
+    ook_frame_t frame = {
+        .proto = ook_protocol_get(OOK_PROTO_CAME_24),
+        .code = BENCH_PATTERN,
+    };
+
+    ESP_ERROR_CHECK(rmt_new_tx_channel(&config, &channel));
+    ESP_ERROR_CHECK(rmt_enable(channel));
+    ESP_ERROR_CHECK(ook_encoder_new(&ook));
+    ESP_ERROR_CHECK(rmt_new_copy_encoder(&copy_config, &copy));
+
+    // The copy baseline sends exactly what the OOK encoder produced
+    rmt_symbol_word_t golden[BENCH_CAPTURE_MAX];
+    ESP_ERROR_CHECK(rmt_transmit(channel, ook, &frame, sizeof(frame), &tx_config));
+    const mock_rmt_burst_t *burst = mock_rmt_burst(mock_rmt_burst_count() - 1);
+    size_t count = burst->symbol_count;
+    TEST_CHECK(count <= BENCH_CAPTURE_MAX, "encoder benchmark frame too long");
+    for (size_t i = 0; i < count && i < BENCH_CAPTURE_MAX; i++) {
+        golden[i] = burst->symbols[i];
+    }
+    sim_run_until(burst->end_us);
+
+    int64_t elapsed_ns[2] = {0, 0};
+    mock_alloc_stats_t before, after;
+    mock_alloc_get(&before);
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < BENCH_ITERATIONS; i++) {
+            int64_t start = bench_wall_ns();
+            esp_err_t ret = pass == 0 ? rmt_transmit(channel, ook, &frame, sizeof(frame), &tx_config)
+                                      : rmt_transmit(channel, copy, golden, count * sizeof(golden[0]), &tx_config);
+            elapsed_ns[pass] += bench_wall_ns() - start;
+            if (ret != ESP_OK) {
+                TEST_CHECK(false, "rmt_transmit: %s", esp_err_to_name(ret));
+                break;
+            }
+            sim_run_until(mock_rmt_burst(mock_rmt_burst_count() - 1)->end_us);
+        }
+        mock_rmt_clear_bursts();
+    }
+    mock_alloc_get(&after);
+
+    int64_t ook_ns = elapsed_ns[0] / BENCH_ITERATIONS;
+    int64_t copy_ns = elapsed_ns[1] / BENCH_ITERATIONS;
+    printf("encoder     %5" PRId64 " ns/frame  %6.1f Msymbols/s  (copy baseline %" PRId64 " ns, OOK encoding %" PRId64
+           " ns/frame)\n", ook_ns, ook_ns ? (double)count * 1000.0 / ook_ns : 0.0, copy_ns, ook_ns - copy_ns);
+    printf("encoder     %5.2f firmware allocations/frame\n",
+           (double)(after.allocs - before.allocs) / (2 * BENCH_ITERATIONS));
+    TEST_CHECK(after.allocs == before.allocs, "the OOK encoder allocates per transmission");
+
+    rmt_del_encoder(copy);
+    rmt_del_encoder(ook);
+    ESP_ERROR_CHECK(rmt_disable(channel));
+    ESP_ERROR_CHECK(rmt_del_channel(channel));
+}
+
+// ====== Golden Waveforms ======
+static void bench_check_protocol(ook_protocol_id_t id)
+{
+    const ook_protocol_t *proto = ook_protocol_get(id);
+    ook_frame_t frame = {
+        .proto = proto,
+        .code = BENCH_PATTERN & ((1UL << proto->bits) - 1),
+    };
+
+    const mock_rmt_burst_t *burst = bench_send(&frame, BENCH_REPEATS);
+    if (burst == NULL) {
+        TEST_CHECK(false, "%s: not transmitted", proto->name);
+        return;
+    }
+
+    // Hardware loop: one frame in the memory block, replayed BENCH_REPEATS times
+    TEST_CHECK(!burst->aborted, "%s: burst aborted", proto->name);
+    TEST_CHECK(burst->loop_count == BENCH_REPEATS, "%s: loop count %d", proto->name, burst->loop_count);
+    TEST_CHECK(burst->symbol_count == (size_t)proto->bits + 1, "%s: %zu symbols, expected %u", proto->name,
+               burst->symbol_count, proto->bits + 1);
+    TEST_CHECK(bench_symbols_us(burst->symbols, burst->symbol_count) == ook_frame_duration_us(&frame),
+               "%s: %" PRIu32 " us per frame, expected %" PRIu32, proto->name,
+               bench_symbols_us(burst->symbols, burst->symbol_count), ook_frame_duration_us(&frame));
+    TEST_CHECK(burst->end_us - burst->start_us == (int64_t)ook_frame_duration_us(&frame) * BENCH_REPEATS,
+               "%s: %" PRId64 " us on air", proto->name, burst->end_us - burst->start_us);
+
+    // CAME: symbol-exact against the timings validated with the Flipper Zero
+    if (id == OOK_PROTO_CAME_12 || id == OOK_PROTO_CAME_24) {
+        rmt_symbol_word_t golden[BENCH_CAPTURE_MAX];
+        size_t count = bench_came_reference(frame.code, proto->bits, golden);
+        for (size_t i = 0; i < count && i < burst->symbol_count; i++) {
+            if (burst->symbols[i].val != golden[i].val) {
+                TEST_CHECK(false, "%s: symbol %zu is %u/%u, expected %u/%u", proto->name, i,
+                           burst->symbols[i].duration0, burst->symbols[i].duration1,
+                           golden[i].duration0, golden[i].duration1);
+                break;
+            }
+        }
+    }
+
+    // Loopback: the learning decoder must read back what went on air
+    ook_decoded_t decoded;
+    bool found = bench_decode(burst->symbols, burst->symbol_count, &decoded);
+    TEST_CHECK(found && decoded.protocol == id && decoded.code == frame.code,
+               "%s: decoder loopback failed (got %s 0x%06" PRIX32 ")", proto->name,
+               found ? ook_protocol_get(decoded.protocol)->name : "nothing", found ? decoded.code : 0);
+}
+
+/**
+ * @brief A scene streams through the ping-pong refills: same frames, gaps of the requested length
+ */
+static void bench_check_sequence(void)
+{
+    ook_sequence_t seq = {
+        .count = 3,
+        .steps = {
+            {.frame = {.proto = ook_protocol_get(OOK_PROTO_CAME_24), .code = KEY_A}, .repeats = 2, .gap_ms = 120},
+            {.frame = {.proto = ook_protocol_get(OOK_PROTO_NICE_FLO_12), .code = 0x5A5}, .repeats = 1, .gap_ms = 30},
+            {.frame = {.proto = ook_protocol_get(OOK_PROTO_PT2262), .code = 0x5A5A5A}, .repeats = 2},
+        },
+    };
+    rmt_symbol_word_t frames[OOK_SEQ_MAX_STEPS][BENCH_CAPTURE_MAX];
+    size_t counts[OOK_SEQ_MAX_STEPS];
+
+    // Each step's frame on its own first: the reference the sequence must reproduce
+    for (int i = 0; i < seq.count; i++) {
+        const mock_rmt_burst_t *burst = bench_send(&seq.steps[i].frame, 1);
+        if (burst == NULL) {
+            TEST_CHECK(false, "sequence step %d: not transmitted", i);
+            return;
+        }
+        counts[i] = burst->symbol_count;
+        for (size_t s = 0; s < counts[i]; s++) {
+            frames[i][s] = burst->symbols[s];
+        }
+    }
+
+    size_t index = mock_rmt_burst_count();
+    if (came433_start_sequence(0, &seq, NULL) != ESP_OK) {
+        TEST_CHECK(false, "sequence: not transmitted");
+        return;
+    }
+    const mock_rmt_burst_t *burst = mock_rmt_burst(index);
+    sim_run_until(burst->end_us);
+    came433_finish(0);
+
+    TEST_CHECK(burst->refills > 0, "sequence: fitted in one memory block, refills not exercised");
+    size_t pos = 0;
+    int64_t expected_us = 0;
+    for (int i = 0; i < seq.count; i++) {
+        const ook_seq_step_t *step = &seq.steps[i];
+        for (int r = 0; r < step->repeats; r++) {
+            for (size_t s = 0; s < counts[i]; s++, pos++) {
+                if (pos >= burst->symbol_count || burst->symbols[pos].val != frames[i][s].val) {
+                    TEST_CHECK(false, "sequence: step %d repeat %d differs at symbol %zu", i, r, s);
+                    return;
+                }
+            }
+            expected_us += bench_symbols_us(frames[i], counts[i]);
+        }
+        if (i + 1 == seq.count) {
+            break;
+        }
+        // Gap: carrier off on both halves, for exactly gap_ms
+        uint32_t gap_us = 0;
+        while (pos < burst->symbol_count && burst->symbols[pos].level0 == 0 && burst->symbols[pos].level1 == 0) {
+            gap_us += bench_symbols_us(&burst->symbols[pos++], 1);
+        }
+        TEST_CHECK(gap_us == step->gap_ms * 1000u, "sequence: gap %d is %" PRIu32 " us", i, gap_us);
+        expected_us += gap_us;
+    }
+    TEST_CHECK(pos == burst->symbol_count, "sequence: %zu trailing symbols", burst->symbol_count - pos);
+    TEST_CHECK(burst->end_us - burst->start_us == expected_us, "sequence: %" PRId64 " us on air, expected %" PRId64,
+               burst->end_us - burst->start_us, expected_us);
+}
+
+// ====== Dispatch ======
+/**
+ * @brief Presses through handle_button_click(), as zb_action_handler calls it
+ *
+ * Dispatch is the Zigbee-context cost (lookup, LED mailbox, rf_tx_submit).
+ * End to end adds the RF worker, came433 and the RMT model up to the done
+ * event. Each press must produce exactly one burst with the gate's waveform
+ * and no firmware heap traffic.
+ */
+static void bench_dispatch(void)
+{
+    uint8_t count = gates_count();
+    int idle_channels = mock_rmt_channels_enabled();   // The LED keeps its dedicated channel
+    int64_t dispatch_ns = 0;
+    int64_t total_ns = 0;
+    size_t sent = 0;
+    mock_alloc_stats_t before, after;
+
+    mock_rmt_clear_bursts();
+    mock_alloc_get(&before);
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        uint8_t endpoint = gates_endpoint(i % count);
+
+        int64_t start = bench_wall_ns();
+        esp_err_t ret = handle_button_click(endpoint, esp_timer_get_time());
+        int64_t dispatched = bench_wall_ns();
+        while (rf_tx_endpoint_busy(endpoint)) {
+            sim_run_for(10 * 1000);
+        }
+        total_ns += bench_wall_ns() - start;
+        dispatch_ns += dispatched - start;
+
+        // Settle outside the timed part: LED off frame and the deferred latency attribute
+        sim_run_for(BENCH_SETTLE_US);
+        mock_zb_alarm_run_due();
+
+        TEST_CHECK(ret == ESP_OK, "press %d on EP%d refused: %s", i, endpoint, esp_err_to_name(ret));
+        const gate_t *gate = gates_get(endpoint);
+        const mock_rmt_burst_t *burst = mock_rmt_burst(sent);
+        if (mock_rmt_burst_count() != sent + 1 || burst == NULL) {
+            TEST_CHECK(false, "press %d on EP%d: %zu bursts", i, endpoint, mock_rmt_burst_count() - sent);
+            break;
+        }
+        sent++;
+        rmt_symbol_word_t golden[BENCH_CAPTURE_MAX];
+        size_t golden_count = bench_came_reference(gate->cfg.code, gate->frame.proto->bits, golden);
+        bool same = burst->symbol_count == golden_count && !burst->aborted &&
+                    burst->loop_count == gate->cfg.repeats;
+        for (size_t s = 0; same && s < golden_count; s++) {
+            same = burst->symbols[s].val == golden[s].val;
+        }
+        if (!same) {
+            TEST_CHECK(false, "press %d on EP%d: waveform differs from the gate's code", i, endpoint);
+            break;
+        }
+    }
+    mock_alloc_get(&after);
+
+    printf("dispatch    %5" PRId64 " ns/press (Zigbee context), %" PRId64 " ns/press end to end, %d gates\n",
+           dispatch_ns / BENCH_ITERATIONS, total_ns / BENCH_ITERATIONS, count);
+    printf("dispatch    %5.2f firmware allocations/press\n", (double)(after.allocs - before.allocs) / BENCH_ITERATIONS);
+    TEST_CHECK(after.allocs == before.allocs, "the press path allocates");
+    TEST_CHECK(mock_led_color() == 0, "LED still lit after the last burst");
+    TEST_CHECK(mock_rmt_channels_enabled() == idle_channels, "a transmitter stayed enabled after its burst");
+}
+
+int main(void)
+{
+    bench_encoder_throughput();
+
+    test_rf_path_start(&(test_rf_path_cfg_t){.endpoints = true});
+
+    for (int id = 0; id < OOK_PROTO_COUNT; id++) {
+        bench_check_protocol((ook_protocol_id_t)id);
+    }
+    bench_check_sequence();
+    printf("golden      %d protocols, 1 sequence: %s\n", OOK_PROTO_COUNT, test_failures ? "MISMATCH" : "OK");
+
+    bench_dispatch();
+
+    return test_finish(NULL);
+}
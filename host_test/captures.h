@@ -0,0 +1,92 @@
+#ifndef CAPTURES_H
+#define CAPTURES_H
+
+#include "driver/rmt_types.h"
+
+/*
+Receiver captures as rf_learn gets them from RMT RX (1 µs ticks): each
+symbol is a pulse then a gap, starting on the first rising edge after idle.
+The last symbol's zero gap is the end marker the RMT writes once the line
+has been idle for longer than RF_LEARN_RANGE_MAX_NS.
+
+They reproduce what a superheterodyne module on the DATA pin delivers:
+±6 % jitter, pulses stretched by ~60 µs at the expense of the gaps (AGC),
+and short noise glitches before the first frame (the CAME and Nice headers
+are the LOW that follows them). Generated once from the protocol timings
+with a fixed seed, then frozen here so a timing table change shows up as a
+decoder regression.
+*/
+
+#define S(pulse_us, gap_us) {.level0 = 1, .duration0 = (pulse_us), .level1 = 0, .duration1 = (gap_us)}
+
+// CAME-24 KEY_A, 4 repeats after noise
+static const rmt_symbol_word_t capture_came24_key_a[] = {
+    S(152, 1769), S(192, 559), S(133, 28082), S(391, 245), S(679, 248), S(714, 253), S(662, 269), S(669, 277),
+    S(672, 241), S(711, 613), S(382, 549), S(385, 550), S(383, 247), S(697, 571), S(387, 618), S(386, 245),
+    S(735, 263), S(715, 580), S(389, 272), S(690, 564), S(381, 250), S(725, 274), S(680, 576), S(380, 568),
+    S(367, 258), S(699, 568), S(373, 584), S(390, 23483), S(368, 247), S(664, 272), S(688, 254), S(716, 274),
+    S(665, 243), S(692, 253), S(703, 558), S(376, 575), S(373, 570), S(385, 269), S(730, 585), S(396, 560),
+    S(371, 254), S(681, 241), S(728, 563), S(395, 272), S(726, 553), S(372, 267), S(696, 279), S(679, 571),
+    S(391, 572), S(364, 273), S(728, 576), S(395, 591), S(393, 24589), S(380, 263), S(704, 272), S(671, 267),
+    S(712, 277), S(723, 249), S(680, 277), S(720, 579), S(363, 550), S(365, 609), S(362, 272), S(679, 551),
+    S(378, 557), S(386, 266), S(727, 254), S(736, 543), S(398, 263), S(693, 611), S(363, 256), S(687, 245),
+    S(683, 601), S(382, 611), S(369, 259), S(683, 582), S(383, 567), S(373, 22986), S(388, 277), S(705, 273),
+    S(689, 243), S(685, 252), S(662, 278), S(722, 262), S(696, 578), S(381, 601), S(384, 573), S(380, 243),
+    S(687, 585), S(390, 568), S(380, 258), S(733, 272), S(681, 597), S(384, 255), S(710, 597), S(389, 244),
+    S(717, 274), S(688, 607), S(386, 611), S(399, 241), S(703, 551), S(370, 597), S(390, 0),
+};
+
+// PT2262 0x5A5A5A, 4 repeats, no noise: the first frame has no sync before it
+static const rmt_symbol_word_t capture_pt2262[] = {
+    S(421, 1035), S(1062, 277), S(417, 1017), S(1126, 304), S(1053, 270), S(393, 966), S(1116, 283),
+    S(414, 1047), S(410, 988), S(1084, 297), S(389, 1021), S(1110, 275), S(1057, 306), S(416, 952),
+    S(1135, 274), S(411, 1035), S(428, 956), S(1153, 278), S(430, 1046), S(1088, 296), S(1145, 300),
+    S(389, 991), S(1087, 294), S(399, 1030), S(413, 11339), S(399, 949), S(1060, 275), S(398, 930),
+    S(1138, 269), S(1110, 299), S(391, 935), S(1168, 281), S(395, 1044), S(395, 978), S(1055, 308),
+    S(423, 1013), S(1144, 286), S(1056, 282), S(397, 1008), S(1158, 307), S(413, 984), S(424, 1029),
+    S(1109, 296), S(394, 960), S(1095, 274), S(1096, 270), S(397, 1052), S(1171, 270), S(405, 954),
+    S(392, 11137), S(429, 1010), S(1053, 288), S(421, 1038), S(1115, 280), S(1125, 275), S(392, 1007),
+    S(1049, 309), S(415, 1030), S(413, 938), S(1115, 277), S(413, 999), S(1131, 297), S(1121, 298),
+    S(417, 944), S(1148, 277), S(427, 1045), S(396, 936), S(1091, 294), S(425, 959), S(1086, 280),
+    S(1061, 282), S(413, 961), S(1091, 272), S(400, 931), S(390, 10654), S(411, 950), S(1090, 272),
+    S(404, 954), S(1058, 295), S(1095, 307), S(418, 954), S(1140, 278), S(409, 994), S(429, 950),
+    S(1164, 285), S(415, 1032), S(1082, 280), S(1057, 279), S(396, 955), S(1100, 276), S(407, 935),
+    S(421, 953), S(1064, 291), S(422, 978), S(1065, 300), S(1108, 280), S(421, 945), S(1057, 303),
+    S(393, 994), S(392, 0),
+};
+
+// EV1527 0x0C3F19, 4 repeats: the last bit's gap runs into the idle line
+static const rmt_symbol_word_t capture_ev1527[] = {
+    S(158, 1763), S(193, 514), S(127, 2261), S(356, 9368), S(377, 802), S(344, 852), S(344, 856), S(351, 859),
+    S(944, 231), S(1003, 230), S(351, 828), S(345, 837), S(366, 827), S(377, 819), S(945, 248), S(1009, 225),
+    S(967, 249), S(943, 239), S(918, 237), S(943, 235), S(364, 819), S(365, 808), S(349, 841), S(915, 241),
+    S(955, 242), S(353, 817), S(361, 852), S(949, 256), S(356, 8950), S(355, 854), S(364, 812), S(344, 807),
+    S(349, 814), S(984, 256), S(926, 246), S(360, 858), S(359, 797), S(348, 868), S(347, 875), S(945, 242),
+    S(985, 244), S(955, 228), S(934, 253), S(957, 242), S(908, 234), S(366, 793), S(375, 815), S(365, 884),
+    S(1002, 242), S(955, 231), S(344, 809), S(371, 794), S(967, 250), S(350, 8813), S(345, 818), S(374, 890),
+    S(376, 862), S(359, 815), S(967, 244), S(944, 256), S(378, 836), S(346, 894), S(373, 827), S(362, 797),
+    S(972, 223), S(974, 247), S(1011, 237), S(1012, 235), S(909, 226), S(952, 235), S(359, 889), S(351, 865),
+    S(352, 831), S(957, 223), S(917, 223), S(363, 835), S(363, 869), S(990, 228), S(357, 8947), S(374, 836),
+    S(363, 859), S(342, 813), S(356, 894), S(1006, 223), S(961, 236), S(368, 848), S(376, 876), S(345, 857),
+    S(367, 838), S(943, 227), S(992, 255), S(974, 238), S(931, 224), S(948, 229), S(959, 243), S(360, 787),
+    S(371, 825), S(367, 841), S(956, 244), S(987, 229), S(370, 828), S(346, 819), S(937, 0),
+};
+
+// Two remotes back to back: CAME-12 0x9C3 x3, then Nice FLO-12 0x5A5 x3
+static const rmt_symbol_word_t capture_came12_then_nice[] = {
+    S(159, 1756), S(192, 566), S(130, 27666), S(381, 560), S(399, 255), S(719, 275), S(675, 610), S(369, 583),
+    S(387, 585), S(363, 269), S(683, 250), S(713, 270), S(686, 275), S(683, 582), S(385, 559), S(369, 24726),
+    S(368, 573), S(379, 263), S(666, 272), S(672, 591), S(384, 566), S(385, 545), S(375, 265), S(662, 277),
+    S(698, 267), S(715, 243), S(677, 546), S(394, 588), S(375, 22911), S(373, 552), S(367, 274), S(700, 256),
+    S(712, 615), S(387, 598), S(390, 550), S(398, 261), S(706, 272), S(722, 273), S(736, 241), S(715, 613),
+    S(394, 588), S(395, 26194), S(762, 665), S(1502, 1290), S(763, 624), S(1388, 1365), S(801, 1308),
+    S(778, 605), S(1516, 1377), S(719, 673), S(1384, 606), S(1539, 1408), S(775, 675), S(1468, 1369),
+    S(724, 24352), S(776, 675), S(1520, 1300), S(787, 653), S(1380, 1405), S(782, 1321), S(771, 673),
+    S(1458, 1380), S(760, 609), S(1379, 633), S(1454, 1370), S(756, 630), S(1388, 1317), S(764, 25022),
+    S(747, 600), S(1530, 1273), S(737, 604), S(1543, 1263), S(755, 1358), S(801, 646), S(1479, 1391),
+    S(749, 610), S(1487, 656), S(1422, 1397), S(766, 626), S(1430, 1286), S(800, 0),
+};
+
+#undef S
+
+#endif // CAPTURES_H
@@ -0,0 +1,172 @@
+#include "sim.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp_pm.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ESP-IDF services the firmware calls outside the RMT and Zigbee drivers:
+error names, logging stamped with the virtual clock, esp_timer time,
+a reproducible esp_random(), and inert heap / power management queries.
+*/
+
+#define HOST_HEAP_FREE (256 * 1024)    // What heap_caps reports: the firmware only compares it
+
+// ====== Errors ======
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK: return "ESP_OK";
+    case ESP_FAIL: return "ESP_FAIL";
+    case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE: return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_INVALID_CRC: return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_INVALID_VERSION: return "ESP_ERR_INVALID_VERSION";
+    case ESP_ERR_NOT_FINISHED: return "ESP_ERR_NOT_FINISHED";
+    case ESP_ERR_NVS_NOT_INITIALIZED: return "ESP_ERR_NVS_NOT_INITIALIZED";
+    case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_NVS_NO_FREE_PAGES: return "ESP_ERR_NVS_NO_FREE_PAGES";
+    case ESP_ERR_NVS_NEW_VERSION_FOUND: return "ESP_ERR_NVS_NEW_VERSION_FOUND";
+    default: return "UNKNOWN ERROR";
+    }
+}
+
+// ====== Logging ======
+static int log_level = -1;
+
+static int log_threshold(void)
+{
+    if (log_level < 0) {
+        const char *env = getenv("ZB433_LOG_LEVEL");
+        log_level = env != NULL ? atoi(env) : ESP_LOG_WARN;
+    }
+    return log_level;
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+    va_list args;
+
+    if ((int)level > log_threshold()) {
+        return;
+    }
+    fprintf(stderr, "%c (%lld) %s: ", letters[level], (long long)(sim_now_us() / 1000), tag);
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    // Global on the host: per-tag levels are not worth a table here
+    if (tag != NULL && tag[0] == '*') {
+        log_level = level;
+    }
+}
+
+// ====== Time, Random, System ======
+int64_t esp_timer_get_time(void)
+{
+    return sim_now_us();
+}
+
+uint32_t esp_random(void)
+{
+    static uint32_t state = 0x2545F491;
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+void esp_restart(void)
+{
+    fprintf(stderr, "esp_restart() called\n");
+    abort();
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return HOST_HEAP_FREE;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+    return HOST_HEAP_FREE;
+}
+
+esp_reset_reason_t esp_reset_reason(void)
+{
+    return ESP_RST_POWERON;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return HOST_HEAP_FREE;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    return HOST_HEAP_FREE;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return HOST_HEAP_FREE;
+}
+
+void heap_caps_get_info(multi_heap_info_t *info, uint32_t caps)
+{
+    *info = (multi_heap_info_t){
+        .total_free_bytes = HOST_HEAP_FREE,
+        .largest_free_block = HOST_HEAP_FREE,
+        .minimum_free_bytes = HOST_HEAP_FREE,
+    };
+}
+
+// ====== Power Management ======
+// Locks are counted, not enforced: the host has no clock to scale
+struct esp_pm_lock {
+    int count;
+};
+
+esp_err_t esp_pm_configure(const void *config)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_create(esp_pm_lock_type_t lock_type, int arg, const char *name, esp_pm_lock_handle_t *out_handle)
+{
+    *out_handle = calloc(1, sizeof(struct esp_pm_lock));
+    return *out_handle != NULL ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t handle)
+{
+    handle->count++;
+    return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t handle)
+{
+    if (handle->count == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    handle->count--;
+    return ESP_OK;
+}
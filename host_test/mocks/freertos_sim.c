@@ -0,0 +1,554 @@
+#include "sim.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+/*
+Cooperative FreeRTOS on a virtual clock. Tasks are ucontext coroutines;
+the scheduler (sim_run_until) always resumes the highest-priority ready
+task, FIFO among equals. Giving to a higher-priority waiter from a task
+yields at once, as the preemptive kernel would; from main() or an event
+the waiter runs at the next scheduling point. When nothing is ready the
+clock jumps to the next timed event or timeout.
+*/
+
+typedef enum {
+    SIM_READY,
+    SIM_BLOCKED,
+    SIM_DEAD,
+} sim_state_t;
+
+struct sim_task {
+    ucontext_t ctx;
+    void *stack;
+    TaskFunction_t fn;
+    void *arg;
+    const char *name;
+    UBaseType_t priority;
+    uint32_t stack_depth;
+    sim_state_t state;
+    uint64_t ready_seq;         // FIFO order among equal priorities
+    const void *wait_obj;
+    int64_t wake_at_us;         // INT64_MAX = no timeout
+    bool timed_out;
+    uint32_t notify;
+    struct sim_task *next;
+};
+
+typedef enum {
+    SIM_Q_QUEUE,
+    SIM_Q_SEMAPHORE,
+} sim_queue_kind_t;
+
+struct sim_queue {
+    sim_queue_kind_t kind;
+    uint8_t *storage;
+    size_t item_size;
+    size_t length;
+    size_t head;
+    size_t count;
+    char space;                 // Wait object of senders blocked on a full queue
+};
+
+typedef struct sim_event {
+    int64_t at_us;
+    uint64_t seq;
+    sim_event_cb_t cb;
+    void *arg;
+    struct sim_event *next;
+} sim_event_t;
+
+static int64_t sim_now = SIM_START_US;
+static struct sim_task *sim_tasks = NULL;
+static struct sim_task *sim_current = NULL;
+static ucontext_t sim_main_ctx;
+static uint64_t sim_seq = 0;
+static sim_event_t *sim_events = NULL;
+
+static void sim_fail(const char *what)
+{
+    fprintf(stderr, "sim: %s (task %s, t=%lld us)\n", what, sim_current ? sim_current->name : "-",
+            (long long)sim_now);
+    abort();
+}
+
+// ====== Scheduler ======
+static void sim_make_ready(struct sim_task *task)
+{
+    task->state = SIM_READY;
+    task->wait_obj = NULL;
+    task->wake_at_us = INT64_MAX;
+    task->ready_seq = sim_seq++;
+}
+
+static struct sim_task *sim_pick(void)
+{
+    struct sim_task *best = NULL;
+
+    for (struct sim_task *t = sim_tasks; t != NULL; t = t->next) {
+        if (t->state != SIM_READY) {
+            continue;
+        }
+        if (best == NULL || t->priority > best->priority ||
+            (t->priority == best->priority && t->ready_seq < best->ready_seq)) {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static void sim_switch_out(void)
+{
+    struct sim_task *self = sim_current;
+    swapcontext(&self->ctx, &sim_main_ctx);
+}
+
+/**
+ * @brief Block the current task on @p obj; false if @p ticks elapsed first
+ */
+static bool sim_block(const void *obj, TickType_t ticks)
+{
+    if (ticks == 0) {
+        return false;
+    }
+    if (sim_current == NULL) {
+        sim_fail("blocking call outside a task");
+    }
+    sim_current->state = SIM_BLOCKED;
+    sim_current->wait_obj = obj;
+    sim_current->timed_out = false;
+    sim_current->wake_at_us = ticks == portMAX_DELAY ? INT64_MAX : sim_now + (int64_t)ticks * 1000;
+    sim_switch_out();
+    return !sim_current->timed_out;
+}
+
+static void sim_yield(void)
+{
+    sim_make_ready(sim_current);
+    sim_switch_out();
+}
+
+/**
+ * @brief Wake the highest-priority task waiting on @p obj, yielding to it if it outranks the caller
+ */
+static bool sim_wake_one(const void *obj)
+{
+    struct sim_task *best = NULL;
+
+    for (struct sim_task *t = sim_tasks; t != NULL; t = t->next) {
+        if (t->state == SIM_BLOCKED && t->wait_obj == obj &&
+            (best == NULL || t->priority > best->priority)) {
+            best = t;
+        }
+    }
+    if (best == NULL) {
+        return false;
+    }
+    sim_make_ready(best);
+    if (sim_current != NULL && best->priority > sim_current->priority) {
+        sim_yield();
+    }
+    return true;
+}
+
+static void sim_task_entry(void)
+{
+    sim_current->fn(sim_current->arg);
+    sim_fail("task function returned");
+}
+
+int64_t sim_now_us(void)
+{
+    return sim_now;
+}
+
+bool sim_in_task(void)
+{
+    return sim_current != NULL;
+}
+
+void *sim_event_at(int64_t at_us, sim_event_cb_t cb, void *arg)
+{
+    sim_event_t *event = calloc(1, sizeof(*event));
+    if (event == NULL) {
+        sim_fail("out of memory");
+    }
+    event->at_us = at_us < sim_now ? sim_now : at_us;
+    event->seq = sim_seq++;
+    event->cb = cb;
+    event->arg = arg;
+
+    sim_event_t **link = &sim_events;
+    while (*link != NULL && ((*link)->at_us < event->at_us ||
+                             ((*link)->at_us == event->at_us && (*link)->seq < event->seq))) {
+        link = &(*link)->next;
+    }
+    event->next = *link;
+    *link = event;
+    return event;
+}
+
+void sim_event_cancel(void *handle)
+{
+    for (sim_event_t **link = &sim_events; *link != NULL; link = &(*link)->next) {
+        if (*link == handle) {
+            *link = ((sim_event_t *)handle)->next;
+            free(handle);
+            return;
+        }
+    }
+}
+
+static void sim_reap(void)
+{
+    struct sim_task **link = &sim_tasks;
+
+    while (*link != NULL) {
+        struct sim_task *t = *link;
+        if (t->state == SIM_DEAD) {
+            *link = t->next;
+            free(t->stack);
+            free(t);
+        } else {
+            link = &t->next;
+        }
+    }
+}
+
+void sim_run_until(int64_t until_us)
+{
+    uint32_t spins = 0;
+    int64_t spin_at = sim_now;
+
+    if (sim_current != NULL) {
+        sim_fail("sim_run_until() called from a task");
+    }
+
+    while (1) {
+        struct sim_task *task = sim_pick();
+        if (task != NULL) {
+            if (sim_now != spin_at) {
+                spin_at = sim_now;
+                spins = 0;
+            }
+            if (++spins > SIM_SPIN_LIMIT) {
+                sim_current = task;
+                sim_fail("task never blocks");
+            }
+            sim_current = task;
+            swapcontext(&sim_main_ctx, &task->ctx);
+            sim_current = NULL;
+            sim_reap();
+            continue;
+        }
+
+        // Everybody is blocked: jump to the next event or timeout
+        int64_t next = sim_events != NULL ? sim_events->at_us : INT64_MAX;
+        for (struct sim_task *t = sim_tasks; t != NULL; t = t->next) {
+            if (t->state == SIM_BLOCKED && t->wake_at_us < next) {
+                next = t->wake_at_us;
+            }
+        }
+        if (next > until_us) {
+            sim_now = until_us > sim_now ? until_us : sim_now;
+            return;
+        }
+        sim_now = next;
+
+        while (sim_events != NULL && sim_events->at_us <= sim_now) {
+            sim_event_t *event = sim_events;
+            sim_events = event->next;
+            event->cb(event->arg);
+            free(event);
+        }
+        for (struct sim_task *t = sim_tasks; t != NULL; t = t->next) {
+            if (t->state == SIM_BLOCKED && t->wake_at_us <= sim_now) {
+                sim_make_ready(t);
+                t->timed_out = true;
+            }
+        }
+    }
+}
+
+void sim_run_for(int64_t duration_us)
+{
+    sim_run_until(sim_now + duration_us);
+}
+
+// ====== Tasks ======
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                       UBaseType_t priority, TaskHandle_t *created)
+{
+    struct sim_task *task = calloc(1, sizeof(*task));
+    void *stack = malloc(SIM_TASK_STACK);
+    if (task == NULL || stack == NULL) {
+        free(task);
+        free(stack);
+        return pdFAIL;
+    }
+
+    task->fn = fn;
+    task->arg = arg;
+    task->name = name;
+    task->priority = priority;
+    task->stack_depth = stack_depth;
+    task->stack = stack;
+    getcontext(&task->ctx);
+    task->ctx.uc_stack.ss_sp = stack;
+    task->ctx.uc_stack.ss_size = SIM_TASK_STACK;
+    task->ctx.uc_link = NULL;
+    makecontext(&task->ctx, sim_task_entry, 0);
+    sim_make_ready(task);
+
+    // Appended: creation order breaks ties like the FreeRTOS ready list
+    struct sim_task **link = &sim_tasks;
+    while (*link != NULL) {
+        link = &(*link)->next;
+    }
+    *link = task;
+
+    if (created != NULL) {
+        *created = task;
+    }
+    if (sim_current != NULL && priority > sim_current->priority) {
+        sim_yield();
+    }
+    return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char *name, uint32_t stack_depth, void *arg,
+                               UBaseType_t priority, StackType_t *stack, StaticTask_t *task_buf)
+{
+    TaskHandle_t task = NULL;
+    return xTaskCreate(fn, name, stack_depth, arg, priority, &task) == pdPASS ? task : NULL;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL) {
+        task = sim_current;
+    }
+    task->state = SIM_DEAD;
+    if (task == sim_current) {
+        sim_switch_out();
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (ticks == 0) {
+        sim_yield();
+        return;
+    }
+    sim_block(&sim_now, ticks);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(sim_now / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return sim_current;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    // Host stacks are not the firmware's: report the requested depth as untouched
+    task = task ? task : sim_current;
+    return task ? task->stack_depth : 0;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    if (sim_current == NULL) {
+        sim_fail("ulTaskNotifyTake() outside a task");
+    }
+    if (sim_current->notify == 0) {
+        sim_block(&sim_current->notify, ticks_to_wait);
+    }
+    uint32_t value = sim_current->notify;
+    if (value != 0) {
+        sim_current->notify = clear_on_exit ? 0 : value - 1;
+    }
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    task->notify++;
+    sim_wake_one(&task->notify);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    task->notify++;
+    bool woken = false;
+    if (task->state == SIM_BLOCKED && task->wait_obj == &task->notify) {
+        sim_make_ready(task);
+        woken = true;
+    }
+    if (higher_priority_task_woken != NULL) {
+        *higher_priority_task_woken = woken ? pdTRUE : pdFALSE;
+    }
+}
+
+// ====== Queues and Semaphores ======
+static struct sim_queue *sim_queue_new(sim_queue_kind_t kind, size_t length, size_t item_size, size_t count)
+{
+    struct sim_queue *q = calloc(1, sizeof(*q));
+    if (q == NULL) {
+        return NULL;
+    }
+    q->kind = kind;
+    q->length = length;
+    q->item_size = item_size;
+    q->count = count;
+    if (item_size != 0) {
+        q->storage = calloc(length, item_size);
+        if (q->storage == NULL) {
+            free(q);
+            return NULL;
+        }
+    }
+    return q;
+}
+
+static void sim_queue_put(struct sim_queue *q, const void *item)
+{
+    if (q->item_size != 0) {
+        memcpy(q->storage + ((q->head + q->count) % q->length) * q->item_size, item, q->item_size);
+    }
+    q->count++;
+}
+
+static void sim_queue_get(struct sim_queue *q, void *item)
+{
+    if (q->item_size != 0) {
+        memcpy(item, q->storage + q->head * q->item_size, q->item_size);
+        q->head = (q->head + 1) % q->length;
+    }
+    q->count--;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    return sim_queue_new(SIM_Q_QUEUE, length, item_size, 0);
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage, StaticQueue_t *queue_buf)
+{
+    return sim_queue_new(SIM_Q_QUEUE, length, item_size, 0);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait)
+{
+    while (queue->count >= queue->length) {
+        if (!sim_block(&queue->space, ticks_to_wait)) {
+            return pdFALSE;
+        }
+    }
+    sim_queue_put(queue, item);
+    sim_wake_one(queue);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *higher_priority_task_woken)
+{
+    if (queue->count >= queue->length) {
+        return pdFALSE;
+    }
+    struct sim_task *self = sim_current;
+    sim_current = NULL;         // No yield from interrupt context
+    sim_queue_put(queue, item);
+    bool woken = sim_wake_one(queue);
+    sim_current = self;
+    if (higher_priority_task_woken != NULL) {
+        *higher_priority_task_woken = woken ? pdTRUE : pdFALSE;
+    }
+    return pdTRUE;
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item)
+{
+    if (queue->count != 0) {
+        queue->head = 0;
+        queue->count = 0;
+    }
+    sim_queue_put(queue, item);
+    sim_wake_one(queue);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait)
+{
+    while (queue->count == 0) {
+        if (!sim_block(queue, ticks_to_wait)) {
+            return pdFALSE;
+        }
+    }
+    sim_queue_get(queue, item);
+    sim_wake_one(&queue->space);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue)
+{
+    queue->head = 0;
+    queue->count = 0;
+    sim_wake_one(&queue->space);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    return queue->count;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return sim_queue_new(SIM_Q_SEMAPHORE, 1, 0, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinaryStatic(StaticSemaphore_t *buf)
+{
+    return xSemaphoreCreateBinary();
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    // No priority inheritance: the firmware's mutexes only guard short handovers
+    return sim_queue_new(SIM_Q_SEMAPHORE, 1, 0, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *buf)
+{
+    return xSemaphoreCreateMutex();
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks_to_wait)
+{
+    return xQueueReceive(sem, NULL, ticks_to_wait);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    if (sem->count >= sem->length) {
+        return pdFALSE;
+    }
+    sem->count++;
+    sim_wake_one(sem);
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *higher_priority_task_woken)
+{
+    return xQueueSendFromISR(sem, NULL, higher_priority_task_woken);
+}
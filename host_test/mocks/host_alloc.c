@@ -0,0 +1,44 @@
+#include "mock_alloc.h"
+#include <stdlib.h>
+
+// Not compiled with the renaming: these are the real allocator calls
+void *host_malloc(size_t size);
+void *host_calloc(size_t count, size_t size);
+void *host_realloc(void *ptr, size_t size);
+void host_free(void *ptr);
+
+static mock_alloc_stats_t alloc_stats;
+
+void *host_malloc(size_t size)
+{
+    alloc_stats.allocs++;
+    alloc_stats.bytes += size;
+    return malloc(size);
+}
+
+void *host_calloc(size_t count, size_t size)
+{
+    alloc_stats.allocs++;
+    alloc_stats.bytes += count * size;
+    return calloc(count, size);
+}
+
+void *host_realloc(void *ptr, size_t size)
+{
+    alloc_stats.allocs++;
+    alloc_stats.bytes += size;
+    return realloc(ptr, size);
+}
+
+void host_free(void *ptr)
+{
+    if (ptr != NULL) {
+        alloc_stats.frees++;
+    }
+    free(ptr);
+}
+
+void mock_alloc_get(mock_alloc_stats_t *stats)
+{
+    *stats = alloc_stats;
+}
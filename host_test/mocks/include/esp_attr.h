@@ -0,0 +1,15 @@
+#ifndef ESP_ATTR_H
+#define ESP_ATTR_H
+
+#include <stddef.h>
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define FORCE_INLINE_ATTR static inline __attribute__((always_inline))
+
+#ifndef __containerof
+#define __containerof(ptr, type, member) ((type *)((char *)(ptr) - offsetof(type, member)))
+#endif
+
+#endif // ESP_ATTR_H
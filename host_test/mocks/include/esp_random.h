@@ -0,0 +1,9 @@
+#ifndef ESP_RANDOM_H
+#define ESP_RANDOM_H
+
+#include <stdint.h>
+
+// Deterministic on the host: a fixed-seed xorshift, so runs are reproducible
+uint32_t esp_random(void);
+
+#endif // ESP_RANDOM_H
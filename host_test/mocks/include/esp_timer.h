@@ -0,0 +1,11 @@
+#ifndef ESP_TIMER_H
+#define ESP_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// Virtual clock of the host simulator (sim.h), in µs
+int64_t esp_timer_get_time(void);
+
+#endif // ESP_TIMER_H
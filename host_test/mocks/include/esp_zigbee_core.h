@@ -0,0 +1,141 @@
+#ifndef ESP_ZIGBEE_CORE_H
+#define ESP_ZIGBEE_CORE_H
+
+/*
+esp-zigbee-lib API subset used by the firmware. Every other esp_zigbee
+header of the SDK includes this one; the behaviour lives in zigbee_mock.c.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef struct esp_zb_attribute_list_s esp_zb_attribute_list_t;
+typedef esp_zb_attribute_list_t esp_zb_cluster_list_t;
+typedef esp_zb_attribute_list_t esp_zb_ep_list_t;
+typedef uint8_t esp_zb_ieee_addr_t[8];
+typedef struct { uint8_t zcl_version; uint8_t power_source; } esp_zb_basic_cluster_cfg_t;
+typedef struct { bool on_off; } esp_zb_on_off_cluster_cfg_t;
+typedef struct { uint16_t identify_time; } esp_zb_identify_cluster_cfg_t;
+typedef struct { uint8_t multistate_out_of_service; uint16_t present_value; uint8_t status_flags; uint16_t number_of_states; } esp_zb_multistate_value_cluster_cfg_t;
+typedef struct { uint32_t ota_upgrade_file_version; uint32_t ota_upgrade_downloaded_file_ver; uint16_t ota_upgrade_manufacturer; uint16_t ota_upgrade_image_type; } esp_zb_ota_cluster_cfg_t;
+typedef struct { uint16_t timer_query; uint16_t hw_version; uint8_t max_data_size; } esp_zb_zcl_ota_upgrade_client_variable_t;
+typedef struct { uint8_t endpoint; uint16_t app_profile_id; uint16_t app_device_id; uint32_t app_device_version; } esp_zb_endpoint_config_t;
+typedef enum { ESP_ZB_ZCL_CLUSTER_SERVER_ROLE = 1, ESP_ZB_ZCL_CLUSTER_CLIENT_ROLE = 2 } esp_zb_zcl_cluster_role_t;
+#define ESP_ZB_ZCL_BASIC_ZCL_VERSION_DEFAULT_VALUE 8
+#define ESP_ZB_ZCL_BASIC_POWER_SOURCE_DC_SOURCE 4
+#define ESP_ZB_ZCL_ATTR_BASIC_MANUFACTURER_NAME_ID 4
+#define ESP_ZB_ZCL_ATTR_BASIC_MODEL_IDENTIFIER_ID 5
+#define ESP_ZB_ZCL_ATTR_BASIC_SW_BUILD_ID 0x4000
+#define ESP_ZB_ZCL_CLUSTER_ID_BASIC 0
+#define ESP_ZB_ZCL_CLUSTER_ID_IDENTIFY 3
+#define ESP_ZB_ZCL_CLUSTER_ID_ON_OFF 6
+#define ESP_ZB_ZCL_CLUSTER_ID_MULTI_VALUE 0x14
+#define ESP_ZB_ZCL_CLUSTER_ID_OTA_UPGRADE 0x19
+#define ESP_ZB_ZCL_CLUSTER_ID_DIAGNOSTICS 0x0b05
+#define ESP_ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID 0
+#define ESP_ZB_ZCL_ATTR_IDENTIFY_IDENTIFY_TIME_ID 0
+#define ESP_ZB_ZCL_CMD_ON_OFF_OFF_ID 0
+#define ESP_ZB_ZCL_CMD_ON_OFF_ON_ID 1
+#define ESP_ZB_ZCL_CMD_ON_OFF_TOGGLE_ID 2
+#define ESP_ZB_ZCL_ATTR_OTA_UPGRADE_CLIENT_DATA_ID 0xfff3
+#define ESP_ZB_ZCL_ATTR_OTA_UPGRADE_SERVER_ADDR_ID 0xfff4
+#define ESP_ZB_ZCL_ATTR_OTA_UPGRADE_SERVER_ENDPOINT_ID 0xfff5
+#define ESP_ZB_ZCL_ATTR_OTA_UPGRADE_MIN_BLOCK_PERIOD_ID 0x0009
+#define ESP_ZB_ZCL_OTA_UPGRADE_QUERY_TIMER_COUNT_DEF 1440
+typedef enum { ESP_ZB_ZCL_ATTR_TYPE_BOOL = 0x10, ESP_ZB_ZCL_ATTR_TYPE_U8 = 0x20, ESP_ZB_ZCL_ATTR_TYPE_U16 = 0x21, ESP_ZB_ZCL_ATTR_TYPE_U32 = 0x23, ESP_ZB_ZCL_ATTR_TYPE_S8 = 0x28, ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING = 0x41, ESP_ZB_ZCL_ATTR_TYPE_CHAR_STRING = 0x42 } esp_zb_zcl_attr_type_t;
+typedef enum { ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY = 1, ESP_ZB_ZCL_ATTR_ACCESS_WRITE_ONLY = 2, ESP_ZB_ZCL_ATTR_ACCESS_READ_WRITE = 3, ESP_ZB_ZCL_ATTR_ACCESS_REPORTING = 4 } esp_zb_zcl_attr_access_t;
+esp_zb_ep_list_t *esp_zb_ep_list_create(void);
+esp_zb_cluster_list_t *esp_zb_zcl_cluster_list_create(void);
+esp_zb_attribute_list_t *esp_zb_basic_cluster_create(esp_zb_basic_cluster_cfg_t *);
+esp_zb_attribute_list_t *esp_zb_on_off_cluster_create(esp_zb_on_off_cluster_cfg_t *);
+esp_zb_attribute_list_t *esp_zb_identify_cluster_create(esp_zb_identify_cluster_cfg_t *);
+esp_zb_attribute_list_t *esp_zb_ota_cluster_create(esp_zb_ota_cluster_cfg_t *);
+esp_zb_attribute_list_t *esp_zb_zcl_attr_list_create(uint16_t cluster_id);
+esp_err_t esp_zb_basic_cluster_add_attr(esp_zb_attribute_list_t *, uint16_t, void *);
+esp_err_t esp_zb_ota_cluster_add_attr(esp_zb_attribute_list_t *, uint16_t, void *);
+esp_err_t esp_zb_custom_cluster_add_custom_attr(esp_zb_attribute_list_t *, uint16_t, uint8_t, uint8_t, void *);
+esp_err_t esp_zb_cluster_list_add_basic_cluster(esp_zb_cluster_list_t *, esp_zb_attribute_list_t *, uint8_t);
+esp_err_t esp_zb_cluster_list_add_on_off_cluster(esp_zb_cluster_list_t *, esp_zb_attribute_list_t *, uint8_t);
+esp_err_t esp_zb_cluster_list_add_identify_cluster(esp_zb_cluster_list_t *, esp_zb_attribute_list_t *, uint8_t);
+esp_err_t esp_zb_cluster_list_add_ota_cluster(esp_zb_cluster_list_t *, esp_zb_attribute_list_t *, uint8_t);
+esp_err_t esp_zb_cluster_list_add_custom_cluster(esp_zb_cluster_list_t *, esp_zb_attribute_list_t *, uint8_t);
+esp_err_t esp_zb_ep_list_add_ep(esp_zb_ep_list_t *, esp_zb_cluster_list_t *, esp_zb_endpoint_config_t);
+esp_err_t esp_zb_device_register(esp_zb_ep_list_t *);
+/* core */
+typedef enum { ESP_ZB_DEVICE_TYPE_COORDINATOR, ESP_ZB_DEVICE_TYPE_ROUTER, ESP_ZB_DEVICE_TYPE_ED } esp_zb_nwk_device_type_t;
+typedef struct { uint8_t max_children; } esp_zb_zczr_cfg_t;
+typedef struct { esp_zb_nwk_device_type_t esp_zb_role; bool install_code_policy; union { esp_zb_zczr_cfg_t zczr_cfg; } nwk_cfg; } esp_zb_cfg_t;
+void esp_zb_init(esp_zb_cfg_t *);
+esp_err_t esp_zb_start(bool);
+void esp_zb_stack_main_loop(void);
+void esp_zb_main_loop_iteration(void);
+bool esp_zb_lock_acquire(TickType_t); void esp_zb_lock_release(void);
+esp_err_t esp_zb_set_primary_network_channel_set(uint32_t); esp_err_t esp_zb_set_secondary_network_channel_set(uint32_t);
+#define ESP_ZB_TRANSCEIVER_ALL_CHANNELS_MASK 0x07FFF800U
+esp_err_t esp_zb_overall_network_size_set(uint16_t); esp_err_t esp_zb_io_buffer_size_set(uint16_t); esp_err_t esp_zb_scheduler_queue_size_set(uint16_t);
+void esp_zb_aps_src_binding_table_size_set(uint16_t); void esp_zb_aps_dst_binding_table_size_set(uint16_t);
+typedef void (*esp_zb_callback_t)(uint8_t param);
+void esp_zb_scheduler_alarm(esp_zb_callback_t cb, uint8_t param, uint32_t time);
+void esp_zb_scheduler_alarm_cancel(esp_zb_callback_t cb, uint8_t param);
+typedef uint32_t esp_zb_app_signal_type_t;
+enum { ESP_ZB_ZDO_SIGNAL_DEFAULT_START, ESP_ZB_ZDO_SIGNAL_SKIP_STARTUP, ESP_ZB_ZDO_SIGNAL_DEVICE_ANNCE, ESP_ZB_ZDO_SIGNAL_LEAVE, ESP_ZB_ZDO_SIGNAL_ERROR, ESP_ZB_BDB_SIGNAL_DEVICE_FIRST_START, ESP_ZB_BDB_SIGNAL_DEVICE_REBOOT, ESP_ZB_BDB_SIGNAL_STEERING, ESP_ZB_NWK_SIGNAL_PERMIT_JOIN_STATUS, ESP_ZB_COMMON_SIGNAL_CAN_SLEEP, ESP_ZB_ZDO_SIGNAL_DEVICE_UPDATE, ESP_ZB_NWK_SIGNAL_NO_ACTIVE_LINKS_LEFT, ESP_ZB_ZDO_SIGNAL_PRODUCTION_CONFIG_READY };
+typedef struct { uint32_t *p_app_signal; esp_err_t esp_err_status; } esp_zb_app_signal_t;
+void *esp_zb_app_signal_get_params(uint32_t *);
+const char *esp_zb_zdo_signal_to_string(esp_zb_app_signal_type_t);
+esp_err_t esp_zb_bdb_start_top_level_commissioning(uint8_t);
+bool esp_zb_bdb_is_factory_new(void);
+enum { ESP_ZB_BDB_MODE_INITIALIZATION = 0, ESP_ZB_BDB_MODE_NETWORK_STEERING = 2 };
+void esp_zb_get_extended_pan_id(esp_zb_ieee_addr_t); uint16_t esp_zb_get_pan_id(void); uint8_t esp_zb_get_current_channel(void); uint16_t esp_zb_get_short_address(void);
+typedef enum { ESP_ZB_CORE_SET_ATTR_VALUE_CB_ID = 0, ESP_ZB_CORE_OTA_UPGRADE_VALUE_CB_ID = 4, ESP_ZB_CORE_CMD_CUSTOM_CLUSTER_REQ_CB_ID = 0x1c, ESP_ZB_CORE_CMD_DEFAULT_RESP_CB_ID = 0x1e } esp_zb_core_action_callback_id_t;
+typedef esp_err_t (*esp_zb_core_action_callback_t)(esp_zb_core_action_callback_id_t, const void *);
+void esp_zb_core_action_handler_register(esp_zb_core_action_callback_t);
+typedef enum { ESP_ZB_ZCL_STATUS_SUCCESS = 0, ESP_ZB_ZCL_STATUS_FAIL = 1, ESP_ZB_ZCL_STATUS_INVALID_VALUE = 0x87 } esp_zb_zcl_status_t;
+typedef struct { esp_zb_zcl_status_t status; uint8_t dst_endpoint; uint16_t cluster; } esp_zb_device_cb_common_info_t;
+typedef struct { uint8_t type; uint16_t size; void *value; } esp_zb_zcl_attribute_data_t;
+typedef struct { uint16_t id; esp_zb_zcl_attribute_data_t data; } esp_zb_zcl_attribute_t;
+typedef struct { esp_zb_device_cb_common_info_t info; esp_zb_zcl_attribute_t attribute; } esp_zb_zcl_set_attr_value_message_t;
+typedef struct { uint32_t fc; uint16_t manuf_code; uint8_t tsn; int8_t rssi; } esp_zb_zcl_frame_header_t;
+typedef struct { uint8_t addr_type; union { uint16_t addr_short; esp_zb_ieee_addr_t addr_long; } u; } esp_zb_zcl_addr_t;
+typedef struct { uint8_t id; uint8_t direction; uint8_t is_common; } esp_zb_zcl_command_t;
+typedef struct { esp_zb_zcl_status_t status; esp_zb_zcl_frame_header_t header; esp_zb_zcl_addr_t src_address; uint16_t dst_address; uint8_t src_endpoint; uint8_t dst_endpoint; uint16_t cluster; uint16_t profile; esp_zb_zcl_command_t command; } esp_zb_zcl_cmd_info_t;
+typedef struct { esp_zb_zcl_cmd_info_t info; struct { uint16_t size; void *value; } data; } esp_zb_zcl_custom_cluster_command_message_t;
+typedef struct { uint16_t manufacturer_code; uint16_t image_type; uint32_t file_version; uint32_t image_size; } esp_zb_zcl_ota_upgrade_header_t;
+typedef enum { ESP_ZB_ZCL_OTA_UPGRADE_STATUS_START, ESP_ZB_ZCL_OTA_UPGRADE_STATUS_APPLY, ESP_ZB_ZCL_OTA_UPGRADE_STATUS_RECEIVE, ESP_ZB_ZCL_OTA_UPGRADE_STATUS_FINISH, ESP_ZB_ZCL_OTA_UPGRADE_STATUS_ABORT, ESP_ZB_ZCL_OTA_UPGRADE_STATUS_CHECK, ESP_ZB_ZCL_OTA_UPGRADE_STATUS_OK, ESP_ZB_ZCL_OTA_UPGRADE_STATUS_ERROR } esp_zb_zcl_ota_upgrade_status_t;
+typedef struct { esp_zb_device_cb_common_info_t info; esp_zb_zcl_ota_upgrade_status_t upgrade_status; esp_zb_zcl_ota_upgrade_header_t ota_header; uint16_t payload_size; uint8_t *payload; } esp_zb_zcl_ota_upgrade_value_message_t;
+typedef enum { ESP_ZB_ZCL_STATUS_DUMMY } esp_zb_zcl_status_dummy_t;
+esp_zb_zcl_status_t esp_zb_zcl_set_attribute_val(uint8_t ep, uint16_t cluster, uint8_t role, uint16_t attr, void *value, bool check);
+typedef void (*esp_zb_identify_notify_callback_t)(uint8_t identify_on);
+void esp_zb_identify_notify_handler_register(uint8_t endpoint, esp_zb_identify_notify_callback_t);
+typedef enum { ESP_ZB_ZCL_CMD_DIRECTION_TO_SRV = 0, ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI = 1 } esp_zb_zcl_cmd_direction_t;
+typedef enum { ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT = 0, ESP_ZB_APS_ADDR_MODE_16_ENDP_PRESENT = 2 } esp_zb_aps_address_mode_t;
+typedef struct { union { uint16_t addr_short; esp_zb_ieee_addr_t addr_long; } dst_addr_u; uint8_t dst_endpoint; uint8_t src_endpoint; } esp_zb_zcl_basic_cmd_t;
+typedef struct { esp_zb_zcl_basic_cmd_t zcl_basic_cmd; esp_zb_aps_address_mode_t address_mode; uint16_t profile_id; uint16_t cluster_id; uint16_t manuf_specific; uint8_t direction; uint8_t dis_defalut_resp; uint16_t manuf_code; uint16_t custom_cmd_id; struct { uint8_t type; uint16_t size; void *value; } data; } esp_zb_zcl_custom_cluster_cmd_req_t;
+uint8_t esp_zb_zcl_custom_cluster_cmd_req(esp_zb_zcl_custom_cluster_cmd_req_t *);
+typedef struct { uint16_t cluster_id; uint16_t attr_id; uint8_t direction; esp_zb_zcl_basic_cmd_t zcl_basic_cmd; esp_zb_aps_address_mode_t address_mode; uint16_t manuf_code; } esp_zb_zcl_report_attr_cmd_t;
+uint8_t esp_zb_zcl_report_attr_cmd_req(esp_zb_zcl_report_attr_cmd_t *);
+typedef struct { uint8_t direction; uint8_t ep; uint16_t cluster_id; uint8_t cluster_role; uint16_t attr_id; uint16_t manuf_code; uint8_t flags; uint64_t run_time; union { struct { uint16_t min_interval; uint16_t max_interval; uint16_t def_min_interval; uint16_t def_max_interval; union { uint32_t u32; } delta; } send_info; } u; struct { uint16_t short_addr; uint8_t endpoint; uint16_t profile_id; } dst; } esp_zb_zcl_reporting_info_t;
+esp_err_t esp_zb_zcl_update_reporting_info(esp_zb_zcl_reporting_info_t *);
+#define ESP_ZB_ZCL_REPORT_DIRECTION_SEND 0
+#define ESP_ZB_AF_HA_PROFILE_ID_DEFAULT 0x0104
+#define EP_ZB_DEFAULT_MANUFACTURER_CODE 0x131B
+/* nwk */
+typedef uint32_t esp_zb_nwk_info_iterator_t;
+#define ESP_ZB_NWK_INFO_ITERATOR_INIT 0
+typedef enum { ESP_ZB_NWK_RELATIONSHIP_PARENT = 0, ESP_ZB_NWK_RELATIONSHIP_CHILD = 1 } esp_zb_nwk_relationship_t;
+typedef struct { esp_zb_ieee_addr_t ieee_addr; uint16_t short_addr; uint8_t device_type; uint8_t depth; uint8_t rx_on_when_idle; uint8_t relationship; uint8_t lqi; int8_t rssi; uint8_t outgoing_cost; uint8_t age; uint32_t device_timeout; uint32_t timeout_counter; } esp_zb_nwk_neighbor_info_t;
+typedef struct { uint16_t dest_addr; uint16_t next_hop_addr; struct { uint8_t status:3; } flags; uint8_t expiry; } esp_zb_nwk_route_info_t;
+esp_err_t esp_zb_nwk_get_next_neighbor(esp_zb_nwk_info_iterator_t *, esp_zb_nwk_neighbor_info_t *);
+esp_err_t esp_zb_nwk_get_next_route(esp_zb_nwk_info_iterator_t *, esp_zb_nwk_route_info_t *);
+typedef struct { uint8_t status; uint8_t dst_addr_mode; uint8_t dst_endpoint; uint8_t src_endpoint; int64_t tx_time; uint8_t asdu_length; uint8_t *asdu; } esp_zb_apsde_data_confirm_t;
+typedef void (*esp_zb_apsde_data_confirm_callback_t)(esp_zb_apsde_data_confirm_t);
+void esp_zb_aps_data_confirm_handler_register(esp_zb_apsde_data_confirm_callback_t);
+/* platform */
+typedef enum { ZB_RADIO_MODE_NATIVE } esp_zb_radio_mode_t;
+typedef enum { ZB_HOST_CONNECTION_MODE_NONE } esp_zb_host_connection_mode_t;
+typedef struct { struct { esp_zb_radio_mode_t radio_mode; } radio_config; struct { esp_zb_host_connection_mode_t host_connection_mode; } host_config; } esp_zb_platform_config_t;
+esp_err_t esp_zb_platform_config(esp_zb_platform_config_t *);
+#define ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC 0xFFFFU
+
+#endif // ESP_ZIGBEE_CORE_H
@@ -0,0 +1,51 @@
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_attr.h"
+
+/*
+FreeRTOS on the host: tasks are coroutines run by the simulator in sim.h,
+one at a time, on a virtual clock. A task only gives the CPU back when it
+blocks (delay, notify, queue, semaphore), so critical sections are no-ops.
+*/
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;        // Stack depths are in bytes, as in ESP-IDF
+
+typedef struct sim_task *TaskHandle_t;
+typedef struct sim_queue *QueueHandle_t;
+typedef struct sim_queue *SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+// Static buffers are accepted but unused: the simulator owns its objects
+typedef struct { void *reserved; } StaticTask_t;
+typedef struct { void *reserved; } StaticQueue_t;
+typedef StaticQueue_t StaticSemaphore_t;
+
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) (void)(mux)
+#define portEXIT_CRITICAL(mux) (void)(mux)
+#define portENTER_CRITICAL_ISR(mux) (void)(mux)
+#define portEXIT_CRITICAL_ISR(mux) (void)(mux)
+#define portYIELD_FROM_ISR(x) (void)(x)
+
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define pdTICKS_TO_MS(ticks) ((uint32_t)(ticks))
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define tskIDLE_PRIORITY 0
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#endif // FREERTOS_H
@@ -0,0 +1,2 @@
+// SDK header layout only: the declarations live in esp_zigbee_core.h
+#include "esp_zigbee_core.h"
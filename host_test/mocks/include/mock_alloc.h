@@ -0,0 +1,21 @@
+#ifndef MOCK_ALLOC_H
+#define MOCK_ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+The firmware library is compiled with malloc/calloc/realloc/free renamed to
+host_* (host_test/CMakeLists.txt): its heap traffic is counted apart from
+the simulator's and the test's own.
+*/
+
+typedef struct {
+    uint32_t allocs;            // malloc + calloc + realloc calls
+    uint32_t frees;
+    size_t bytes;               // Requested, cumulative
+} mock_alloc_stats_t;
+
+void mock_alloc_get(mock_alloc_stats_t *stats);
+
+#endif // MOCK_ALLOC_H
@@ -0,0 +1,16 @@
+#ifndef MOCK_LED_STRIP_H
+#define MOCK_LED_STRIP_H
+
+#include <stdint.h>
+
+/**
+ * @brief Color latched by the WS2812, packed 0xRRGGBB (survives led_strip_del like the real LED)
+ */
+uint32_t mock_led_color(void);
+
+/**
+ * @brief Frames pushed to the strip (refresh and clear)
+ */
+uint32_t mock_led_frames(void);
+
+#endif // MOCK_LED_STRIP_H
@@ -0,0 +1,52 @@
+#ifndef MOCK_RMT_H
+#define MOCK_RMT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "driver/rmt_types.h"
+
+/*
+Test side of the RMT / GPIO model (rmt_mock.c). Channels take memory
+blocks like the ESP32-C6 driver: four blocks of SOC_RMT_MEM_WORDS_PER_CHANNEL
+symbols, TX channels 0-1 and RX channels 2-3, a channel of n blocks owning
+blocks id..id+n-1. Every transmission is recorded as a burst with the
+symbols the encoder produced and its on-air window on the virtual clock.
+*/
+
+typedef struct {
+    int gpio;
+    int channel_id;
+    int64_t start_us;
+    int64_t end_us;             // Done event time, or the rmt_disable() time if aborted
+    int loop_count;             // 0 = single pass
+    size_t symbol_count;        // One pass, end marker excluded
+    const rmt_symbol_word_t *symbols;
+    size_t refills;             // Memory block refills the encoder needed
+    bool aborted;
+} mock_rmt_burst_t;
+
+size_t mock_rmt_burst_count(void);
+const mock_rmt_burst_t *mock_rmt_burst(size_t index);
+void mock_rmt_clear_bursts(void);
+
+/**
+ * @brief Bit mask of the memory blocks held by live channels
+ */
+uint32_t mock_rmt_blocks_used(void);
+
+/**
+ * @brief Channels currently enabled (a transmitter must never stay enabled between bursts)
+ */
+int mock_rmt_channels_enabled(void);
+
+/**
+ * @brief Feed @p count received symbols to the armed RX channel on @p gpio (event context)
+ *
+ * @return false if no rmt_receive() is pending on that pin
+ */
+bool mock_rmt_rx_inject(int gpio, const rmt_symbol_word_t *symbols, size_t count);
+
+int mock_gpio_level(int gpio);
+
+#endif // MOCK_RMT_H
@@ -0,0 +1,50 @@
+#ifndef MOCK_ZIGBEE_H
+#define MOCK_ZIGBEE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_zigbee_core.h"
+
+/*
+Test side of the Zigbee stack model (zigbee_mock.c): commands the firmware
+sent, attribute writes it made, and the scheduler alarms it armed. Alarms
+only run when the test (or the stack main loop) asks for them, the way
+they only run in the Zigbee task on target.
+*/
+
+#define MOCK_ZB_PAYLOAD_MAX 16
+
+typedef struct {
+    int64_t at_us;
+    esp_zb_aps_address_mode_t address_mode;
+    uint16_t dst_addr;
+    uint8_t dst_endpoint;
+    uint8_t src_endpoint;
+    uint16_t cluster_id;
+    uint16_t cmd_id;
+    uint8_t direction;
+    uint16_t size;
+    uint8_t payload[MOCK_ZB_PAYLOAD_MAX];
+} mock_zb_cmd_t;
+
+size_t mock_zb_cmd_count(void);
+const mock_zb_cmd_t *mock_zb_cmd(size_t index);
+void mock_zb_clear_cmds(void);
+
+/**
+ * @brief Number of esp_zb_zcl_set_attribute_val() calls on this attribute
+ */
+uint32_t mock_zb_attr_writes(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id);
+
+/**
+ * @brief Due time of the earliest armed alarm, INT64_MAX if none
+ */
+int64_t mock_zb_alarm_next_us(void);
+size_t mock_zb_alarms_pending(void);
+
+/**
+ * @brief Run every alarm due at the current virtual time, in due order
+ */
+void mock_zb_alarm_run_due(void);
+
+#endif // MOCK_ZIGBEE_H
@@ -0,0 +1,58 @@
+#ifndef SDKCONFIG_H
+#define SDKCONFIG_H
+
+/*
+Host build configuration: the Kconfig defaults of main/Kconfig.projbuild,
+with the second transmitter and the learning receiver enabled so every RMT
+client competes for the four C6 memory blocks. A test target overrides a
+value with a compile definition (see host_test/CMakeLists.txt).
+*/
+
+#define CONFIG_IDF_TARGET_ESP32C6 1
+#define CONFIG_FREERTOS_HZ 1000
+
+#ifndef CONFIG_ZB433_MAX_GATES
+#define CONFIG_ZB433_MAX_GATES 16
+#endif
+#ifndef CONFIG_ZB433_DEDUP_WINDOW_MS
+#define CONFIG_ZB433_DEDUP_WINDOW_MS 1000
+#endif
+#ifndef CONFIG_ZB433_DUTY_CYCLE_PERMILLE
+#define CONFIG_ZB433_DUTY_CYCLE_PERMILLE 100
+#endif
+#ifndef CONFIG_ZB433_DUTY_WINDOW_S
+#define CONFIG_ZB433_DUTY_WINDOW_S 3600
+#endif
+#ifndef CONFIG_ZB433_RF_TX2_GPIO
+#define CONFIG_ZB433_RF_TX2_GPIO 6
+#endif
+#ifndef CONFIG_ZB433_RF_TX2_DUTY_PERMILLE
+#define CONFIG_ZB433_RF_TX2_DUTY_PERMILLE 10
+#endif
+#ifndef CONFIG_ZB433_RX_GPIO
+#define CONFIG_ZB433_RX_GPIO 5
+#endif
+#ifndef CONFIG_ZB433_DIAG_POLL_S
+#define CONFIG_ZB433_DIAG_POLL_S 30
+#endif
+
+// Capacity profile: home
+#define CONFIG_ZB433_CAPACITY_HOME 1
+#define CONFIG_ZB433_CAPACITY_NAME "home"
+#define CONFIG_ZB433_CAPACITY_MAX_CHILDREN 10
+#define CONFIG_ZB433_CAPACITY_NETWORK_SIZE 64
+#define CONFIG_ZB433_CAPACITY_IO_BUFFERS 80
+#define CONFIG_ZB433_CAPACITY_SCHED_QUEUE 80
+#define CONFIG_ZB433_CAPACITY_BINDINGS 16
+#define CONFIG_ZB433_CAPACITY_TRACK_NEIGHBORS 32
+#define CONFIG_ZB433_CAPACITY_TRACK_ROUTES 32
+
+#define CONFIG_ZB433_OTA_FILE_VERSION 0x01000000
+#define CONFIG_ZB433_OTA_BLOCK_SIZE 64
+#define CONFIG_ZB433_OTA_BLOCK_PERIOD_MS 200
+#define CONFIG_ZB433_OTA_QUERY_MIN 1440
+#define CONFIG_ZB433_PM_MIN_FREQ_MHZ 40
+
+// CONFIG_ZB433_STATIC_ALLOC, CONFIG_ZB433_PM, CONFIG_PM_ENABLE: off unless a target defines them
+
+#endif // SDKCONFIG_H
@@ -0,0 +1,45 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Host simulator behind the FreeRTOS, esp_timer and RMT mocks. Time is
+virtual: it only moves when every task is blocked, straight to the next
+timeout or timed event, so a 250 ms RF burst costs no wall-clock time.
+Tasks run only inside sim_run_until(); the test's main() plays the part
+of app_main and may call any non-blocking API between runs.
+*/
+
+#define SIM_START_US 1000000        // Virtual boot time: stamps are never 0
+#define SIM_TASK_STACK (256 * 1024) // Host stacks, independent of the firmware's sizes
+#define SIM_SPIN_LIMIT 100000
+
+typedef void (*sim_event_cb_t)(void *arg);
+
+int64_t sim_now_us(void);
+
+/**
+ * @brief Run tasks and timed events until the virtual clock reaches @p until_us
+ *
+ * Aborts if a task is still runnable after SIM_SPIN_LIMIT switches at the
+ * same instant (a task that never blocks would hang the firmware too).
+ */
+void sim_run_until(int64_t until_us);
+void sim_run_for(int64_t duration_us);
+
+/**
+ * @brief Call @p cb at @p at_us from interrupt context (no task), e.g. an RMT done event
+ *
+ * @return Handle for sim_event_cancel()
+ */
+void *sim_event_at(int64_t at_us, sim_event_cb_t cb, void *arg);
+void sim_event_cancel(void *event);
+
+/**
+ * @brief True when called from a simulated task (false from main() and events)
+ */
+bool sim_in_task(void);
+
+#endif // SIM_H
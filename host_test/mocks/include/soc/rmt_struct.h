@@ -0,0 +1,6 @@
+#ifndef SOC_RMT_STRUCT_H
+#define SOC_RMT_STRUCT_H
+
+// Register layout is not modelled: the RMT driver mock works at the API level
+
+#endif // SOC_RMT_STRUCT_H
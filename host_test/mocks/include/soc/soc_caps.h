@@ -0,0 +1,13 @@
+#ifndef SOC_CAPS_H
+#define SOC_CAPS_H
+
+// ESP32-C6 RMT: four 48-symbol memory blocks, channels 0-1 TX, 2-3 RX
+#define SOC_RMT_GROUPS 1
+#define SOC_RMT_TX_CANDIDATES_PER_GROUP 2
+#define SOC_RMT_RX_CANDIDATES_PER_GROUP 2
+#define SOC_RMT_CHANNELS_PER_GROUP 4
+#define SOC_RMT_MEM_WORDS_PER_CHANNEL 48
+#define SOC_RMT_SUPPORT_TX_LOOP_COUNT 1
+#define SOC_RMT_SUPPORT_TX_LOOP_AUTO_STOP 1
+
+#endif // SOC_CAPS_H
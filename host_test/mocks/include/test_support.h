@@ -0,0 +1,42 @@
+#ifndef TEST_SUPPORT_H
+#define TEST_SUPPORT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/*
+Shared by every host test (test_support.c): one failure counter with its
+check macro, the app_main bring-up of the RF path, and the exit status.
+*/
+
+#define TEST_BOOT_SETTLE_US (100 * 1000)   // After the bring-up: LED off frame, RF workers waiting
+
+extern int test_failures;
+
+#define TEST_CHECK(cond, ...) do {                      \
+        if (!(cond)) {                                  \
+            fprintf(stderr, "FAIL: " __VA_ARGS__);      \
+            fputc('\n', stderr);                        \
+            test_failures++;                            \
+        }                                               \
+    } while (0)
+
+typedef struct {
+    void (*gates_loaded)(void);     // Optional, runs right after gates_init(), before the transmitters start
+    bool learn;                     // rf_learn_init()
+    bool endpoints;                 // create_endpoints() and the zcl_defer drain
+} test_rf_path_cfg_t;
+
+/**
+ * @brief app_main order for the RF path: LED, NVS, gates, transmitters, RF workers, [receiver], [endpoints]
+ *
+ * Runs the simulator for TEST_BOOT_SETTLE_US afterwards.
+ */
+void test_rf_path_start(const test_rf_path_cfg_t *cfg);
+
+/**
+ * @brief Exit status of main(): prints the failure count, or @p ok_fmt when every check passed (NULL: nothing)
+ */
+int test_finish(const char *ok_fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#endif // TEST_SUPPORT_H
@@ -0,0 +1,114 @@
+#include "diagnostics.h"
+#include "zb_ota.h"
+#include "codebook.h"
+#include "boot_timeline.h"
+#include "heap_guard.h"
+#include "nwk_hint.h"
+#include "zb_capacity.h"
+#include <string.h>
+
+/*
+Stand-ins for the firmware modules the host build does not link: they
+need flash partitions, OTA or the network tables. Each keeps the real
+module's "nothing configured" behaviour: an empty code book, no OTA or
+diagnostics attributes, an empty boot timeline, no channel hint, no heap
+guard.
+*/
+
+void diagnostics_add_cluster(esp_zb_cluster_list_t *clusters)
+{
+}
+
+void diagnostics_add_mfr_attrs(esp_zb_attribute_list_t *attr_list)
+{
+}
+
+void zb_ota_add_cluster(esp_zb_cluster_list_t *clusters)
+{
+}
+
+uint16_t codebook_count(void)
+{
+    return 0;
+}
+
+uint32_t codebook_generation(void)
+{
+    return 0;
+}
+
+bool codebook_frame(uint16_t index, ook_frame_t *frame, uint8_t *repeats)
+{
+    return false;
+}
+
+esp_err_t codebook_update_begin(uint16_t count)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t codebook_update_write(uint16_t first, const uint8_t *entries, size_t size)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t codebook_update_commit(uint32_t crc32)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+size_t boot_timeline_encode(uint8_t *buf, size_t size)
+{
+    memset(buf, 0, size);
+    return 0;
+}
+
+void diagnostics_start(void)
+{
+}
+
+void zb_ota_confirm_image(void)
+{
+}
+
+esp_err_t zb_ota_handle(const void *message)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void boot_mark(boot_mark_t mark)
+{
+}
+
+void boot_retry(void)
+{
+}
+
+uint32_t boot_mark_us(boot_mark_t mark)
+{
+    return 0;
+}
+
+void boot_timeline_dump(void)
+{
+}
+
+void heap_guard_arm(void)
+{
+}
+
+void nwk_hint_apply(void)
+{
+}
+
+void nwk_hint_update(void)
+{
+}
+
+void zb_capacity_apply(void)
+{
+}
+
+void zb_capacity_report(void)
+{
+}
@@ -0,0 +1,219 @@
+#include "nvs.h"
+#include "nvs_flash.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+NVS as a flat list of (namespace, key) blobs in RAM. Integers are stored as
+little blobs of their own size, so a type mismatch reads as not found, like
+the real NVS. Commit is immediate and nothing survives the process.
+*/
+
+#define NVS_MOCK_HANDLES 16
+#define NVS_MOCK_NAME_MAX 16
+
+typedef struct nvs_entry {
+    char ns[NVS_MOCK_NAME_MAX];
+    char key[NVS_MOCK_NAME_MAX];
+    uint8_t type;
+    size_t length;
+    uint8_t *value;
+    struct nvs_entry *next;
+} nvs_entry_t;
+
+typedef struct {
+    bool open;
+    bool writable;
+    char ns[NVS_MOCK_NAME_MAX];
+} nvs_mock_handle_t;
+
+enum {
+    NVS_TYPE_BLOB,
+    NVS_TYPE_U8,
+    NVS_TYPE_U16,
+    NVS_TYPE_U32,
+};
+
+static nvs_entry_t *nvs_entries = NULL;
+static nvs_mock_handle_t nvs_handles[NVS_MOCK_HANDLES];
+
+// ====== Private Functions ======
+static nvs_mock_handle_t *nvs_handle_get(nvs_handle_t handle)
+{
+    if (handle == 0 || handle > NVS_MOCK_HANDLES || !nvs_handles[handle - 1].open) {
+        return NULL;
+    }
+    return &nvs_handles[handle - 1];
+}
+
+static nvs_entry_t **nvs_find(const nvs_mock_handle_t *h, const char *key)
+{
+    nvs_entry_t **link = &nvs_entries;
+
+    while (*link != NULL && (strcmp((*link)->ns, h->ns) != 0 || strcmp((*link)->key, key) != 0)) {
+        link = &(*link)->next;
+    }
+    return link;
+}
+
+static esp_err_t nvs_get(nvs_handle_t handle, const char *key, uint8_t type, void *out, size_t *length)
+{
+    nvs_mock_handle_t *h = nvs_handle_get(handle);
+    if (h == NULL || key == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_entry_t *entry = *nvs_find(h, key);
+    if (entry == NULL || entry->type != type) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (out == NULL) {
+        *length = entry->length;
+        return ESP_OK;
+    }
+    if (*length < entry->length) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(out, entry->value, entry->length);
+    *length = entry->length;
+    return ESP_OK;
+}
+
+static esp_err_t nvs_set(nvs_handle_t handle, const char *key, uint8_t type, const void *value, size_t length)
+{
+    nvs_mock_handle_t *h = nvs_handle_get(handle);
+    if (h == NULL || key == NULL || strlen(key) >= NVS_MOCK_NAME_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!h->writable) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    nvs_entry_t **link = nvs_find(h, key);
+    nvs_entry_t *entry = *link;
+    if (entry == NULL) {
+        entry = calloc(1, sizeof(*entry));
+        if (entry == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        strcpy(entry->ns, h->ns);
+        strcpy(entry->key, key);
+        *link = entry;
+    }
+    uint8_t *copy = malloc(length ? length : 1);
+    if (copy == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(copy, value, length);
+    free(entry->value);
+    entry->value = copy;
+    entry->length = length;
+    entry->type = type;
+    return ESP_OK;
+}
+
+// ====== Public API ======
+esp_err_t nvs_flash_init(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    while (nvs_entries != NULL) {
+        nvs_entry_t *entry = nvs_entries;
+        nvs_entries = entry->next;
+        free(entry->value);
+        free(entry);
+    }
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (name == NULL || strlen(name) >= NVS_MOCK_NAME_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < NVS_MOCK_HANDLES; i++) {
+        if (!nvs_handles[i].open) {
+            nvs_handles[i] = (nvs_mock_handle_t){.open = true, .writable = open_mode == NVS_READWRITE};
+            strcpy(nvs_handles[i].ns, name);
+            *out_handle = i + 1;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    nvs_mock_handle_t *h = nvs_handle_get(handle);
+    if (h != NULL) {
+        h->open = false;
+    }
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    return nvs_handle_get(handle) != NULL ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    nvs_mock_handle_t *h = nvs_handle_get(handle);
+    if (h == NULL || key == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_entry_t **link = nvs_find(h, key);
+    nvs_entry_t *entry = *link;
+    if (entry == NULL) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    *link = entry->next;
+    free(entry->value);
+    free(entry);
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return nvs_get(handle, key, NVS_TYPE_BLOB, out_value, length);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    return nvs_set(handle, key, NVS_TYPE_BLOB, value, length);
+}
+
+esp_err_t nvs_get_u8(nvs_handle_t handle, const char *key, uint8_t *out_value)
+{
+    size_t length = sizeof(*out_value);
+    return nvs_get(handle, key, NVS_TYPE_U8, out_value, &length);
+}
+
+esp_err_t nvs_set_u8(nvs_handle_t handle, const char *key, uint8_t value)
+{
+    return nvs_set(handle, key, NVS_TYPE_U8, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u16(nvs_handle_t handle, const char *key, uint16_t *out_value)
+{
+    size_t length = sizeof(*out_value);
+    return nvs_get(handle, key, NVS_TYPE_U16, out_value, &length);
+}
+
+esp_err_t nvs_set_u16(nvs_handle_t handle, const char *key, uint16_t value)
+{
+    return nvs_set(handle, key, NVS_TYPE_U16, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value)
+{
+    size_t length = sizeof(*out_value);
+    return nvs_get(handle, key, NVS_TYPE_U32, out_value, &length);
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    return nvs_set(handle, key, NVS_TYPE_U32, &value, sizeof(value));
+}
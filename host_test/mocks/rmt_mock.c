@@ -0,0 +1,486 @@
+#include "mock_rmt.h"
+#include "sim.h"
+#include "driver/rmt_tx.h"
+#include "driver/rmt_rx.h"
+#include "driver/rmt_encoder.h"
+#include "driver/gpio.h"
+#include "soc/soc_caps.h"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "RMT_MOCK";
+
+/*
+RMT driver model. Allocation follows the IDF group logic on the C6: a
+channel of n blocks needs blocks id..id+n-1 free, TX ids start at 0 and
+RX ids at SOC_RMT_TX_CANDIDATES_PER_GROUP. rmt_transmit() runs the encoder
+synchronously against the memory budget the hardware would offer (whole
+block first, then half-block ping-pong refills), records the symbols, and
+posts the done event at the end of the burst's airtime.
+*/
+
+#define RMT_MOCK_BLOCKS SOC_RMT_CHANNELS_PER_GROUP
+#define RMT_MOCK_GPIOS 32
+
+struct rmt_channel_t {
+    bool tx;
+    bool enabled;
+    int id;
+    int gpio;
+    uint32_t resolution_hz;
+    size_t mem_symbols;
+    uint32_t block_mask;
+    // TX
+    rmt_tx_done_callback_t on_trans_done;
+    void *done_ctx;
+    void *done_event;           // Pending done event while a burst is on air
+    size_t burst;               // Index of that burst in mock_bursts
+    size_t fill_left;           // Symbols the current memory fill still accepts
+    mock_rmt_burst_t *recording;
+    // RX
+    rmt_rx_done_callback_t on_recv_done;
+    void *recv_ctx;
+    rmt_symbol_word_t *rx_buffer;
+    size_t rx_capacity;         // 0 = no rmt_receive() pending
+};
+
+typedef struct {
+    rmt_encoder_t base;
+    size_t copied;              // Symbols of the current payload already written
+} rmt_copy_encoder_t;
+
+static uint32_t mock_blocks = 0;
+static struct rmt_channel_t *mock_channels[RMT_MOCK_BLOCKS];
+static mock_rmt_burst_t *mock_bursts = NULL;
+static size_t mock_burst_count = 0;
+static size_t mock_burst_capacity = 0;
+static int mock_gpio_levels[RMT_MOCK_GPIOS];
+
+// ====== Channel Allocation ======
+static esp_err_t rmt_mock_alloc(struct rmt_channel_t *chan, size_t mem_symbols, int first_id, int candidates)
+{
+    if (mem_symbols == 0) {
+        mem_symbols = SOC_RMT_MEM_WORDS_PER_CHANNEL;
+    }
+    // Same constraint as the driver: even, and at least one block
+    if (mem_symbols < SOC_RMT_MEM_WORDS_PER_CHANNEL || (mem_symbols & 1)) {
+        ESP_LOGE(TAG, "mem_block_symbols %zu invalid", mem_symbols);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int blocks = (mem_symbols + SOC_RMT_MEM_WORDS_PER_CHANNEL - 1) / SOC_RMT_MEM_WORDS_PER_CHANNEL;
+    uint32_t mask = (1u << blocks) - 1;
+    for (int i = 0; i < candidates; i++) {
+        int id = first_id + i;
+        uint32_t want = mask << id;
+        if (id + blocks <= RMT_MOCK_BLOCKS && mock_channels[id] == NULL && (mock_blocks & want) == 0) {
+            mock_blocks |= want;
+            mock_channels[id] = chan;
+            chan->id = id;
+            chan->block_mask = want;
+            chan->mem_symbols = mem_symbols;
+            return ESP_OK;
+        }
+    }
+    ESP_LOGE(TAG, "no free channel with %d memory block(s) (blocks in use 0x%lx)", blocks,
+             (unsigned long)mock_blocks);
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t rmt_new_tx_channel(const rmt_tx_channel_config_t *config, rmt_channel_handle_t *ret_chan)
+{
+    if (config == NULL || ret_chan == NULL || config->resolution_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct rmt_channel_t *chan = calloc(1, sizeof(*chan));
+    if (chan == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = rmt_mock_alloc(chan, config->mem_block_symbols, 0, SOC_RMT_TX_CANDIDATES_PER_GROUP);
+    if (ret != ESP_OK) {
+        free(chan);
+        return ret;
+    }
+    chan->tx = true;
+    chan->gpio = config->gpio_num;
+    chan->resolution_hz = config->resolution_hz;
+    *ret_chan = chan;
+    return ESP_OK;
+}
+
+esp_err_t rmt_new_rx_channel(const rmt_rx_channel_config_t *config, rmt_channel_handle_t *ret_chan)
+{
+    if (config == NULL || ret_chan == NULL || config->resolution_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct rmt_channel_t *chan = calloc(1, sizeof(*chan));
+    if (chan == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = rmt_mock_alloc(chan, config->mem_block_symbols, SOC_RMT_TX_CANDIDATES_PER_GROUP,
+                                   SOC_RMT_RX_CANDIDATES_PER_GROUP);
+    if (ret != ESP_OK) {
+        free(chan);
+        return ret;
+    }
+    chan->gpio = config->gpio_num;
+    chan->resolution_hz = config->resolution_hz;
+    *ret_chan = chan;
+    return ESP_OK;
+}
+
+esp_err_t rmt_del_channel(rmt_channel_handle_t channel)
+{
+    if (channel == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (channel->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    mock_blocks &= ~channel->block_mask;
+    mock_channels[channel->id] = NULL;
+    free(channel);
+    return ESP_OK;
+}
+
+esp_err_t rmt_enable(rmt_channel_handle_t channel)
+{
+    if (channel == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (channel->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    channel->enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t rmt_disable(rmt_channel_handle_t channel)
+{
+    if (channel == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!channel->enabled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // Disabling mid-burst stops the waveform and drops the done event
+    if (channel->done_event != NULL) {
+        sim_event_cancel(channel->done_event);
+        channel->done_event = NULL;
+        mock_bursts[channel->burst].aborted = true;
+        mock_bursts[channel->burst].end_us = sim_now_us();
+    }
+    channel->rx_capacity = 0;
+    channel->enabled = false;
+    return ESP_OK;
+}
+
+// ====== Copy Encoder ======
+static size_t rmt_copy_encode(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primary_data,
+                              size_t data_size, rmt_encode_state_t *ret_state)
+{
+    rmt_copy_encoder_t *copy = __containerof(encoder, rmt_copy_encoder_t, base);
+    const rmt_symbol_word_t *symbols = primary_data;
+    size_t total = data_size / sizeof(rmt_symbol_word_t);
+    size_t written = 0;
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+
+    if (channel == NULL || channel->recording == NULL) {
+        ESP_LOGE(TAG, "copy encoder used outside rmt_transmit()");
+        abort();
+    }
+
+    mock_rmt_burst_t *burst = channel->recording;
+    while (copy->copied < total && channel->fill_left > 0) {
+        ((rmt_symbol_word_t *)burst->symbols)[burst->symbol_count++] = symbols[copy->copied++];
+        channel->fill_left--;
+        written++;
+    }
+    if (copy->copied == total) {
+        copy->copied = 0;
+        state |= RMT_ENCODING_COMPLETE;
+    }
+    if (channel->fill_left == 0) {
+        state |= RMT_ENCODING_MEM_FULL;
+    }
+    *ret_state = state;
+    return written;
+}
+
+static esp_err_t rmt_copy_reset(rmt_encoder_t *encoder)
+{
+    __containerof(encoder, rmt_copy_encoder_t, base)->copied = 0;
+    return ESP_OK;
+}
+
+static esp_err_t rmt_copy_del(rmt_encoder_t *encoder)
+{
+    free(__containerof(encoder, rmt_copy_encoder_t, base));
+    return ESP_OK;
+}
+
+esp_err_t rmt_new_copy_encoder(const rmt_copy_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder)
+{
+    if (config == NULL || ret_encoder == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    rmt_copy_encoder_t *copy = calloc(1, sizeof(*copy));
+    if (copy == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    copy->base.encode = rmt_copy_encode;
+    copy->base.reset = rmt_copy_reset;
+    copy->base.del = rmt_copy_del;
+    *ret_encoder = &copy->base;
+    return ESP_OK;
+}
+
+esp_err_t rmt_del_encoder(rmt_encoder_handle_t encoder)
+{
+    return encoder != NULL ? encoder->del(encoder) : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t rmt_encoder_reset(rmt_encoder_handle_t encoder)
+{
+    return encoder != NULL ? encoder->reset(encoder) : ESP_ERR_INVALID_ARG;
+}
+
+// ====== Transmission ======
+static void rmt_mock_tx_done(void *arg)
+{
+    struct rmt_channel_t *chan = arg;
+    rmt_tx_done_event_data_t edata = {
+        .num_symbols = mock_bursts[chan->burst].symbol_count,
+    };
+
+    chan->done_event = NULL;
+    if (chan->on_trans_done != NULL) {
+        chan->on_trans_done(chan, &edata, chan->done_ctx);
+    }
+}
+
+static mock_rmt_burst_t *rmt_mock_new_burst(void)
+{
+    if (mock_burst_count == mock_burst_capacity) {
+        size_t capacity = mock_burst_capacity ? mock_burst_capacity * 2 : 64;
+        mock_rmt_burst_t *grown = realloc(mock_bursts, capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return NULL;
+        }
+        mock_bursts = grown;
+        mock_burst_capacity = capacity;
+    }
+    mock_rmt_burst_t *burst = &mock_bursts[mock_burst_count];
+    *burst = (mock_rmt_burst_t){0};
+    return burst;
+}
+
+esp_err_t rmt_tx_register_event_callbacks(rmt_channel_handle_t tx_channel, const rmt_tx_event_callbacks_t *cbs,
+                                          void *user_data)
+{
+    if (tx_channel == NULL || cbs == NULL || !tx_channel->tx) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    tx_channel->on_trans_done = cbs->on_trans_done;
+    tx_channel->done_ctx = user_data;
+    return ESP_OK;
+}
+
+esp_err_t rmt_transmit(rmt_channel_handle_t tx_channel, rmt_encoder_handle_t encoder, const void *payload,
+                       size_t payload_bytes, const rmt_transmit_config_t *config)
+{
+    if (tx_channel == NULL || encoder == NULL || payload == NULL || config == NULL || !tx_channel->tx ||
+        config->loop_count < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!tx_channel->enabled || tx_channel->done_event != NULL) {
+        return ESP_ERR_INVALID_STATE;   // The firmware never queues behind a running burst
+    }
+
+    mock_rmt_burst_t *burst = rmt_mock_new_burst();
+    rmt_symbol_word_t *symbols = NULL;
+    size_t capacity = 256;
+    if (burst == NULL || (symbols = malloc(capacity * sizeof(*symbols))) == NULL) {
+        free(symbols);
+        return ESP_ERR_NO_MEM;
+    }
+    burst->symbols = symbols;
+    burst->gpio = tx_channel->gpio;
+    burst->channel_id = tx_channel->id;
+    burst->loop_count = config->loop_count;
+    tx_channel->recording = burst;
+
+    // First fill gets the whole block, each refill the half the hardware just played
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+    tx_channel->fill_left = tx_channel->mem_symbols;
+    encoder->reset(encoder);
+    while (!(state & RMT_ENCODING_COMPLETE)) {
+        if (capacity - burst->symbol_count < tx_channel->mem_symbols) {
+            capacity *= 2;
+            rmt_symbol_word_t *grown = realloc((void *)burst->symbols, capacity * sizeof(*grown));
+            if (grown == NULL) {
+                free((void *)burst->symbols);
+                tx_channel->recording = NULL;
+                return ESP_ERR_NO_MEM;
+            }
+            burst->symbols = grown;
+        }
+        size_t before = burst->symbol_count;
+        encoder->encode(encoder, tx_channel, payload, payload_bytes, &state);
+        if (state & RMT_ENCODING_COMPLETE) {
+            break;
+        }
+        if (!(state & RMT_ENCODING_MEM_FULL) && burst->symbol_count == before) {
+            ESP_LOGE(TAG, "encoder made no progress");
+            free((void *)burst->symbols);
+            tx_channel->recording = NULL;
+            return ESP_FAIL;
+        }
+        if (state & RMT_ENCODING_MEM_FULL) {
+            tx_channel->fill_left = tx_channel->mem_symbols / 2;
+            burst->refills++;
+        }
+    }
+    tx_channel->recording = NULL;
+
+    // Loop mode replays the block as is: the frame and its end marker must fit without a refill
+    if (config->loop_count > 0 && (burst->refills != 0 || burst->symbol_count + 1 > tx_channel->mem_symbols)) {
+        ESP_LOGE(TAG, "loop transmission of %zu symbols does not fit %zu", burst->symbol_count,
+                 tx_channel->mem_symbols);
+        free((void *)burst->symbols);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Air time up to the first zero duration, which ends the transaction like the end marker
+    uint64_t ticks = 0;
+    for (size_t i = 0; i < burst->symbol_count; i++) {
+        const rmt_symbol_word_t *s = &burst->symbols[i];
+        ticks += s->duration0;
+        if (s->duration0 == 0) {
+            break;
+        }
+        ticks += s->duration1;
+        if (s->duration1 == 0) {
+            break;
+        }
+    }
+    ticks *= config->loop_count > 0 ? config->loop_count : 1;
+
+    burst->start_us = sim_now_us();
+    burst->end_us = burst->start_us + (int64_t)(ticks * 1000000 / tx_channel->resolution_hz);
+    tx_channel->burst = mock_burst_count++;
+    tx_channel->done_event = sim_event_at(burst->end_us, rmt_mock_tx_done, tx_channel);
+    return ESP_OK;
+}
+
+// ====== Reception ======
+esp_err_t rmt_rx_register_event_callbacks(rmt_channel_handle_t rx_channel, const rmt_rx_event_callbacks_t *cbs,
+                                          void *user_data)
+{
+    if (rx_channel == NULL || cbs == NULL || rx_channel->tx) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    rx_channel->on_recv_done = cbs->on_recv_done;
+    rx_channel->recv_ctx = user_data;
+    return ESP_OK;
+}
+
+esp_err_t rmt_receive(rmt_channel_handle_t rx_channel, void *buffer, size_t buffer_size,
+                      const rmt_receive_config_t *config)
+{
+    if (rx_channel == NULL || buffer == NULL || config == NULL || rx_channel->tx) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!rx_channel->enabled || rx_channel->rx_capacity != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    rx_channel->rx_buffer = buffer;
+    rx_channel->rx_capacity = buffer_size / sizeof(rmt_symbol_word_t);
+    return ESP_OK;
+}
+
+bool mock_rmt_rx_inject(int gpio, const rmt_symbol_word_t *symbols, size_t count)
+{
+    for (int i = 0; i < RMT_MOCK_BLOCKS; i++) {
+        struct rmt_channel_t *chan = mock_channels[i];
+        if (chan == NULL || chan->tx || chan->gpio != gpio || chan->rx_capacity == 0) {
+            continue;
+        }
+        size_t n = count < chan->rx_capacity ? count : chan->rx_capacity;
+        memcpy(chan->rx_buffer, symbols, n * sizeof(*symbols));
+        rmt_rx_done_event_data_t edata = {
+            .received_symbols = chan->rx_buffer,
+            .num_symbols = n,
+            .flags.is_last = 1,
+        };
+        chan->rx_capacity = 0;      // One receive per rmt_receive(), the callback may re-arm
+        if (chan->on_recv_done != NULL) {
+            chan->on_recv_done(chan, &edata, chan->recv_ctx);
+        }
+        return true;
+    }
+    return false;
+}
+
+// ====== GPIO ======
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    return config != NULL ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (gpio_num < 0 || gpio_num >= RMT_MOCK_GPIOS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    mock_gpio_levels[gpio_num] = level ? 1 : 0;
+    return ESP_OK;
+}
+
+// ====== Test API ======
+size_t mock_rmt_burst_count(void)
+{
+    return mock_burst_count;
+}
+
+const mock_rmt_burst_t *mock_rmt_burst(size_t index)
+{
+    return index < mock_burst_count ? &mock_bursts[index] : NULL;
+}
+
+void mock_rmt_clear_bursts(void)
+{
+    for (int i = 0; i < RMT_MOCK_BLOCKS; i++) {
+        if (mock_channels[i] != NULL && mock_channels[i]->done_event != NULL) {
+            ESP_LOGE(TAG, "bursts cleared while one is on air");
+            abort();
+        }
+    }
+    for (size_t i = 0; i < mock_burst_count; i++) {
+        free((void *)mock_bursts[i].symbols);
+    }
+    mock_burst_count = 0;
+}
+
+uint32_t mock_rmt_blocks_used(void)
+{
+    return mock_blocks;
+}
+
+int mock_rmt_channels_enabled(void)
+{
+    int enabled = 0;
+
+    for (int i = 0; i < RMT_MOCK_BLOCKS; i++) {
+        if (mock_channels[i] != NULL && mock_channels[i]->enabled) {
+            enabled++;
+        }
+    }
+    return enabled;
+}
+
+int mock_gpio_level(int gpio)
+{
+    return (gpio >= 0 && gpio < RMT_MOCK_GPIOS) ? mock_gpio_levels[gpio] : -1;
+}
@@ -0,0 +1,52 @@
+#include "test_support.h"
+#include "sim.h"
+#include "came433.h"
+#include "endpoints.h"
+#include "gates.h"
+#include "led.h"
+#include "rf_learn.h"
+#include "rf_tx.h"
+#include "zcl_defer.h"
+#include "nvs_flash.h"
+#include <stdarg.h>
+
+int test_failures = 0;
+
+// ====== Public API ======
+void test_rf_path_start(const test_rf_path_cfg_t *cfg)
+{
+    // The LED registers first and keeps its RMT channel
+    led_init();
+    ESP_ERROR_CHECK(nvs_flash_init());
+    gates_init();
+    if (cfg->gates_loaded != NULL) {
+        cfg->gates_loaded();
+    }
+    came433_init();
+    gates_bind_tx(came433_tx_count());
+    rf_tx_init(handle_rf_done);
+    if (cfg->learn) {
+        rf_learn_init();
+    }
+    if (cfg->endpoints) {
+        create_endpoints();
+        zcl_defer_start();      // Zigbee task, right after the endpoints
+    }
+    sim_run_for(TEST_BOOT_SETTLE_US);
+}
+
+int test_finish(const char *ok_fmt, ...)
+{
+    if (test_failures != 0) {
+        printf("%d check(s) failed\n", test_failures);
+        return 1;
+    }
+    if (ok_fmt != NULL) {
+        va_list args;
+        va_start(args, ok_fmt);
+        vprintf(ok_fmt, args);
+        va_end(args);
+        putchar('\n');
+    }
+    return 0;
+}
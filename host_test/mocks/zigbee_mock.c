@@ -0,0 +1,356 @@
+#include "mock_zigbee.h"
+#include "sim.h"
+#include "esp_zigbee_core.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Zigbee stack model: enough of esp-zigbee-lib for the firmware to build its
+endpoints and talk to the network. Cluster lists are placeholders, the
+stack lock is free (one task at a time in the simulator), commands and
+attribute writes are logged, and scheduler alarms wait in a list sorted
+by due time.
+*/
+
+#define MOCK_ZB_ATTRS 128
+
+struct esp_zb_attribute_list_s {
+    uint16_t cluster_id;
+};
+
+typedef struct {
+    uint8_t endpoint;
+    uint16_t cluster_id;
+    uint16_t attr_id;
+    uint32_t writes;
+} mock_zb_attr_t;
+
+typedef struct mock_zb_alarm {
+    esp_zb_callback_t cb;
+    uint8_t param;
+    int64_t due_us;
+    struct mock_zb_alarm *next;
+} mock_zb_alarm_t;
+
+static mock_zb_cmd_t *zb_cmds = NULL;
+static size_t zb_cmd_count = 0;
+static size_t zb_cmd_capacity = 0;
+static mock_zb_attr_t zb_attrs[MOCK_ZB_ATTRS];
+static size_t zb_attr_count = 0;
+static mock_zb_alarm_t *zb_alarms = NULL;
+
+// ====== Data Model ======
+static esp_zb_attribute_list_t *mock_zb_list(uint16_t cluster_id)
+{
+    esp_zb_attribute_list_t *list = calloc(1, sizeof(*list));
+    if (list == NULL) {
+        abort();
+    }
+    list->cluster_id = cluster_id;
+    return list;
+}
+
+esp_zb_ep_list_t *esp_zb_ep_list_create(void)
+{
+    return mock_zb_list(0xffff);
+}
+
+esp_zb_cluster_list_t *esp_zb_zcl_cluster_list_create(void)
+{
+    return mock_zb_list(0xffff);
+}
+
+esp_zb_attribute_list_t *esp_zb_basic_cluster_create(esp_zb_basic_cluster_cfg_t *cfg)
+{
+    return mock_zb_list(ESP_ZB_ZCL_CLUSTER_ID_BASIC);
+}
+
+esp_zb_attribute_list_t *esp_zb_on_off_cluster_create(esp_zb_on_off_cluster_cfg_t *cfg)
+{
+    return mock_zb_list(ESP_ZB_ZCL_CLUSTER_ID_ON_OFF);
+}
+
+esp_zb_attribute_list_t *esp_zb_identify_cluster_create(esp_zb_identify_cluster_cfg_t *cfg)
+{
+    return mock_zb_list(ESP_ZB_ZCL_CLUSTER_ID_IDENTIFY);
+}
+
+esp_zb_attribute_list_t *esp_zb_ota_cluster_create(esp_zb_ota_cluster_cfg_t *cfg)
+{
+    return mock_zb_list(ESP_ZB_ZCL_CLUSTER_ID_OTA_UPGRADE);
+}
+
+esp_zb_attribute_list_t *esp_zb_zcl_attr_list_create(uint16_t cluster_id)
+{
+    return mock_zb_list(cluster_id);
+}
+
+esp_err_t esp_zb_basic_cluster_add_attr(esp_zb_attribute_list_t *list, uint16_t attr_id, void *value)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_zb_ota_cluster_add_attr(esp_zb_attribute_list_t *list, uint16_t attr_id, void *value)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_zb_custom_cluster_add_custom_attr(esp_zb_attribute_list_t *list, uint16_t attr_id, uint8_t type,
+                                                uint8_t access, void *value)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_zb_cluster_list_add_basic_cluster(esp_zb_cluster_list_t *clusters, esp_zb_attribute_list_t *list,
+                                                uint8_t role)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_zb_cluster_list_add_on_off_cluster(esp_zb_cluster_list_t *clusters, esp_zb_attribute_list_t *list,
+                                                 uint8_t role)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_zb_cluster_list_add_identify_cluster(esp_zb_cluster_list_t *clusters, esp_zb_attribute_list_t *list,
+                                                   uint8_t role)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_zb_cluster_list_add_ota_cluster(esp_zb_cluster_list_t *clusters, esp_zb_attribute_list_t *list,
+                                              uint8_t role)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_zb_cluster_list_add_custom_cluster(esp_zb_cluster_list_t *clusters, esp_zb_attribute_list_t *list,
+                                                 uint8_t role)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_zb_ep_list_add_ep(esp_zb_ep_list_t *ep_list, esp_zb_cluster_list_t *clusters,
+                                esp_zb_endpoint_config_t config)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_zb_device_register(esp_zb_ep_list_t *ep_list)
+{
+    return ESP_OK;
+}
+
+esp_zb_zcl_status_t esp_zb_zcl_set_attribute_val(uint8_t ep, uint16_t cluster, uint8_t role, uint16_t attr,
+                                                 void *value, bool check)
+{
+    for (size_t i = 0; i < zb_attr_count; i++) {
+        mock_zb_attr_t *a = &zb_attrs[i];
+        if (a->endpoint == ep && a->cluster_id == cluster && a->attr_id == attr) {
+            a->writes++;
+            return ESP_ZB_ZCL_STATUS_SUCCESS;
+        }
+    }
+    if (zb_attr_count == MOCK_ZB_ATTRS) {
+        return ESP_ZB_ZCL_STATUS_FAIL;
+    }
+    zb_attrs[zb_attr_count++] = (mock_zb_attr_t){.endpoint = ep, .cluster_id = cluster, .attr_id = attr, .writes = 1};
+    return ESP_ZB_ZCL_STATUS_SUCCESS;
+}
+
+// ====== Commands ======
+uint8_t esp_zb_zcl_custom_cluster_cmd_req(esp_zb_zcl_custom_cluster_cmd_req_t *req)
+{
+    if (zb_cmd_count == zb_cmd_capacity) {
+        size_t capacity = zb_cmd_capacity ? zb_cmd_capacity * 2 : 64;
+        mock_zb_cmd_t *grown = realloc(zb_cmds, capacity * sizeof(*grown));
+        if (grown == NULL) {
+            abort();
+        }
+        zb_cmds = grown;
+        zb_cmd_capacity = capacity;
+    }
+
+    mock_zb_cmd_t *cmd = &zb_cmds[zb_cmd_count++];
+    *cmd = (mock_zb_cmd_t){
+        .at_us = sim_now_us(),
+        .address_mode = req->address_mode,
+        .dst_addr = req->zcl_basic_cmd.dst_addr_u.addr_short,
+        .dst_endpoint = req->zcl_basic_cmd.dst_endpoint,
+        .src_endpoint = req->zcl_basic_cmd.src_endpoint,
+        .cluster_id = req->cluster_id,
+        .cmd_id = req->custom_cmd_id,
+        .direction = req->direction,
+        .size = req->data.size,
+    };
+    if (req->data.value != NULL) {
+        memcpy(cmd->payload, req->data.value, req->data.size < MOCK_ZB_PAYLOAD_MAX ? req->data.size
+                                                                                   : MOCK_ZB_PAYLOAD_MAX);
+    }
+    return (uint8_t)zb_cmd_count;   // TSN
+}
+
+// ====== Scheduler ======
+bool esp_zb_lock_acquire(TickType_t block_ticks)
+{
+    return true;
+}
+
+void esp_zb_lock_release(void)
+{
+}
+
+void esp_zb_scheduler_alarm(esp_zb_callback_t cb, uint8_t param, uint32_t time)
+{
+    mock_zb_alarm_t *alarm = calloc(1, sizeof(*alarm));
+    if (alarm == NULL) {
+        abort();
+    }
+    alarm->cb = cb;
+    alarm->param = param;
+    alarm->due_us = sim_now_us() + (int64_t)time * 1000;
+
+    mock_zb_alarm_t **link = &zb_alarms;
+    while (*link != NULL && (*link)->due_us <= alarm->due_us) {
+        link = &(*link)->next;
+    }
+    alarm->next = *link;
+    *link = alarm;
+}
+
+void esp_zb_scheduler_alarm_cancel(esp_zb_callback_t cb, uint8_t param)
+{
+    mock_zb_alarm_t **link = &zb_alarms;
+
+    while (*link != NULL) {
+        mock_zb_alarm_t *alarm = *link;
+        if (alarm->cb == cb && alarm->param == param) {
+            *link = alarm->next;
+            free(alarm);
+        } else {
+            link = &alarm->next;
+        }
+    }
+}
+
+// ====== Stack Lifecycle ======
+// zigbee.c links against these; tests call its handlers directly instead of running the stack
+esp_err_t esp_zb_platform_config(esp_zb_platform_config_t *config)
+{
+    return ESP_OK;
+}
+
+void esp_zb_init(esp_zb_cfg_t *cfg)
+{
+}
+
+esp_err_t esp_zb_start(bool autostart)
+{
+    return ESP_OK;
+}
+
+void esp_zb_stack_main_loop(void)
+{
+}
+
+void esp_zb_core_action_handler_register(esp_zb_core_action_callback_t cb)
+{
+}
+
+void esp_zb_identify_notify_handler_register(uint8_t endpoint, esp_zb_identify_notify_callback_t cb)
+{
+}
+
+void *esp_zb_app_signal_get_params(uint32_t *signal)
+{
+    return NULL;
+}
+
+const char *esp_zb_zdo_signal_to_string(esp_zb_app_signal_type_t signal)
+{
+    return "mock signal";
+}
+
+esp_err_t esp_zb_bdb_start_top_level_commissioning(uint8_t mode)
+{
+    return ESP_OK;
+}
+
+bool esp_zb_bdb_is_factory_new(void)
+{
+    return false;
+}
+
+void esp_zb_get_extended_pan_id(esp_zb_ieee_addr_t pan_id)
+{
+    memset(pan_id, 0, sizeof(esp_zb_ieee_addr_t));
+}
+
+uint16_t esp_zb_get_pan_id(void)
+{
+    return 0x1A62;
+}
+
+uint8_t esp_zb_get_current_channel(void)
+{
+    return 11;
+}
+
+uint16_t esp_zb_get_short_address(void)
+{
+    return 0x1234;
+}
+
+// ====== Test API ======
+size_t mock_zb_cmd_count(void)
+{
+    return zb_cmd_count;
+}
+
+const mock_zb_cmd_t *mock_zb_cmd(size_t index)
+{
+    return index < zb_cmd_count ? &zb_cmds[index] : NULL;
+}
+
+void mock_zb_clear_cmds(void)
+{
+    zb_cmd_count = 0;
+}
+
+uint32_t mock_zb_attr_writes(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id)
+{
+    for (size_t i = 0; i < zb_attr_count; i++) {
+        const mock_zb_attr_t *a = &zb_attrs[i];
+        if (a->endpoint == endpoint && a->cluster_id == cluster_id && a->attr_id == attr_id) {
+            return a->writes;
+        }
+    }
+    return 0;
+}
+
+int64_t mock_zb_alarm_next_us(void)
+{
+    return zb_alarms != NULL ? zb_alarms->due_us : INT64_MAX;
+}
+
+size_t mock_zb_alarms_pending(void)
+{
+    size_t count = 0;
+
+    for (const mock_zb_alarm_t *a = zb_alarms; a != NULL; a = a->next) {
+        count++;
+    }
+    return count;
+}
+
+void mock_zb_alarm_run_due(void)
+{
+    // An alarm may arm another one: re-check the head after every call
+    while (zb_alarms != NULL && zb_alarms->due_us <= sim_now_us()) {
+        mock_zb_alarm_t *alarm = zb_alarms;
+        zb_alarms = alarm->next;
+        alarm->cb(alarm->param);
+        free(alarm);
+    }
+}
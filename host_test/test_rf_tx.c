@@ -0,0 +1,83 @@
+#include "sim.h"
+#include "test_support.h"
+#include "mock_rmt.h"
+#include "endpoints.h"
+#include "gates.h"
+#include "rf_tx.h"
+#include "esp_timer.h"
+#include <stdio.h>
+
+/*
+RF worker done timeout: the worker gives up on a burst whose RMT done event
+never comes, but a legitimately long burst must not be cut. A scene with
+seconds of gaps between its steps and a gate with many repeats both outlast
+any fixed timeout, and must complete on air and count as sent.
+*/
+
+#define LONG_GAP_MS 1500
+#define LONG_REPEATS 40
+#define LONG_SETTLE_US (500 * 1000)
+
+/**
+ * @brief Run until the burst started after @p before is over, then check it completed
+ */
+static void long_check_burst(const char *what, size_t before, const rf_tx_stats_t *prev)
+{
+    sim_run_for(LONG_SETTLE_US);
+    TEST_CHECK(mock_rmt_burst_count() == before + 1, "%s: %zu burst(s) on air", what,
+               mock_rmt_burst_count() - before);
+    if (mock_rmt_burst_count() == before) {
+        return;
+    }
+    const mock_rmt_burst_t *burst = mock_rmt_burst(before);
+    sim_run_until(burst->end_us + LONG_SETTLE_US);
+
+    rf_tx_stats_t stats;
+    rf_tx_get_stats(&stats);
+    TEST_CHECK(!burst->aborted, "%s: burst aborted after %lld ms", what,
+               (long long)(burst->end_us - burst->start_us) / 1000);
+    TEST_CHECK(stats.sent == prev->sent + 1 && stats.dropped == prev->dropped,
+               "%s: sent %lu, dropped %lu", what, (unsigned long)(stats.sent - prev->sent),
+               (unsigned long)(stats.dropped - prev->dropped));
+}
+
+static void long_check_sequence(void)
+{
+    const endpoint_seq_step_t steps[] = {
+        {.endpoint = gates_endpoint(0), .code_index = ENDPOINT_SEQ_GATE_CODE, .gap_ms = LONG_GAP_MS},
+        {.endpoint = gates_endpoint(1), .code_index = ENDPOINT_SEQ_GATE_CODE, .gap_ms = LONG_GAP_MS},
+        {.endpoint = gates_endpoint(0), .code_index = ENDPOINT_SEQ_GATE_CODE},
+    };
+    rf_tx_stats_t prev;
+    size_t before = mock_rmt_burst_count();
+
+    rf_tx_get_stats(&prev);
+    esp_err_t ret = handle_sequence_click(steps, sizeof(steps) / sizeof(steps[0]), esp_timer_get_time());
+    TEST_CHECK(ret == ESP_OK, "scene refused: %s", esp_err_to_name(ret));
+    long_check_burst("scene with 3 s of gaps", before, &prev);
+}
+
+static void long_check_repeats(void)
+{
+    gate_cfg_t cfg = gates_get(gates_endpoint(0))->cfg;
+    rf_tx_stats_t prev;
+
+    cfg.repeats = LONG_REPEATS;
+    TEST_CHECK(gates_set(gates_endpoint(0), &cfg) == ESP_OK, "%d repeats refused", LONG_REPEATS);
+
+    size_t before = mock_rmt_burst_count();
+    rf_tx_get_stats(&prev);
+    esp_err_t ret = handle_button_click(gates_endpoint(0), esp_timer_get_time());
+    TEST_CHECK(ret == ESP_OK, "press refused: %s", esp_err_to_name(ret));
+    long_check_burst("gate with 40 repeats", before, &prev);
+}
+
+int main(void)
+{
+    test_rf_path_start(&(test_rf_path_cfg_t){.endpoints = true});
+
+    long_check_sequence();
+    long_check_repeats();
+
+    return test_finish("rf tx       bursts longer than 1 s complete: OK");
+}
@@ -0,0 +1,144 @@
+#include "sim.h"
+#include "test_support.h"
+#include "mock_rmt.h"
+#include "mock_led_strip.h"
+#include "came433.h"
+#include "endpoints.h"
+#include "gates.h"
+#include "led.h"
+#include "rf_learn.h"
+#include "esp_timer.h"
+#include <stdio.h>
+
+/*
+RMT budget of the ESP32-C6: four memory blocks of 48 symbols, two TX
+channels. The LED, every fitted transmitter and the learning receiver
+start in app_main order and must all work, including a transmitter that
+time-shares the LED's channel. Built three times (host_test/CMakeLists.txt):
+with the second transmitter, with TX0 only, where a gate stored on TX1
+must fall back to TX0, and in zero-heap mode, where TX1 takes the LED's
+channel for good and the LED goes dark instead of aborting the boot.
+*/
+
+#define BUDGET_REPEATS 3
+#define BUDGET_LED_RGB 0x102030
+#define BUDGET_SETTLE_US (100 * 1000)
+
+static const int budget_tx_gpio[CAME_TX_MAX] = {CAME_GPIO, CAME_TX2_GPIO};
+
+/**
+ * @brief The LED keeps a channel, unless zero-heap mode gave it to the second transmitter
+ */
+static bool budget_led_lit(void)
+{
+#if CONFIG_ZB433_STATIC_ALLOC
+    return came433_tx_count() < 2;
+#else
+    return true;
+#endif
+}
+
+static const mock_rmt_burst_t *budget_last_burst(size_t before)
+{
+    return mock_rmt_burst_count() > before ? mock_rmt_burst(mock_rmt_burst_count() - 1) : NULL;
+}
+
+/**
+ * @brief Gate EP1 stored on TX1, as a gate table written for two transmitters would be
+ */
+static void budget_store_gate_on_tx1(void)
+{
+    gate_cfg_t cfg = gates_get(gates_endpoint(0))->cfg;
+
+    cfg.tx = 1;
+    TEST_CHECK(gates_set(gates_endpoint(0), &cfg) == ESP_OK, "gate on TX1 refused before the transmitters exist");
+    gates_init();   // Reload from NVS, as after a reboot
+}
+
+static void budget_check_transmitters(void)
+{
+    ook_frame_t frame = {
+        .proto = ook_protocol_get(OOK_PROTO_CAME_24),
+        .code = KEY_A,
+    };
+
+    for (uint8_t tx = 0; tx < came433_tx_count(); tx++) {
+        size_t before = mock_rmt_burst_count();
+        esp_err_t ret = came433_start(tx, &frame, BUDGET_REPEATS, NULL);
+        const mock_rmt_burst_t *burst = budget_last_burst(before);
+        TEST_CHECK(ret == ESP_OK && burst != NULL, "TX%d: %s", tx, esp_err_to_name(ret));
+        if (burst == NULL) {
+            continue;
+        }
+        TEST_CHECK(burst->gpio == budget_tx_gpio[tx] && burst->loop_count == BUDGET_REPEATS,
+                   "TX%d: burst on GPIO%d, loop %d", tx, burst->gpio, burst->loop_count);
+        sim_run_until(burst->end_us);
+        came433_finish(tx);
+        TEST_CHECK(!burst->aborted, "TX%d: burst aborted", tx);
+
+        // The LED gets its channel back after a transmitter borrowed it
+        led_play(LED_EFFECT_SOLID, BUDGET_LED_RGB >> 16, (BUDGET_LED_RGB >> 8) & 0xFF, BUDGET_LED_RGB & 0xFF, 0);
+        sim_run_for(BUDGET_SETTLE_US);
+        TEST_CHECK((mock_led_color() == BUDGET_LED_RGB) == budget_led_lit(), "LED %s after a burst on TX%d",
+                   budget_led_lit() ? "dark" : "lit", tx);
+        led_off();
+        sim_run_for(BUDGET_SETTLE_US);
+    }
+
+    if (came433_tx_count() < 2) {
+        return;
+    }
+    // Both transmitters on air at once
+    bool started[2];
+    for (uint8_t tx = 0; tx < 2; tx++) {
+        started[tx] = came433_start(tx, &frame, BUDGET_REPEATS, NULL) == ESP_OK;
+    }
+    TEST_CHECK(started[0] && started[1], "TX0 and TX1 not on air together");
+    sim_run_for(ook_frame_duration_us(&frame) * BUDGET_REPEATS);
+    for (uint8_t tx = 0; tx < 2; tx++) {
+        if (started[tx]) {
+            came433_finish(tx);
+        }
+    }
+}
+
+int main(void)
+{
+    // The LED registers first and keeps channel 0
+    test_rf_path_start(&(test_rf_path_cfg_t){
+        .gates_loaded = budget_store_gate_on_tx1,
+        .learn = true,
+        .endpoints = true,
+    });
+
+    // One block each: LED (0), TX0 (1), receiver (2); TX1 time-shares block 0, or takes it from the LED
+    TEST_CHECK(came433_tx_count() == (CAME_TX2_GPIO >= 0 ? 2 : 1), "%d transmitter(s) started",
+               came433_tx_count());
+    TEST_CHECK(mock_rmt_blocks_used() == 0x7, "RMT blocks in use 0x%lx, expected 0x7",
+               (unsigned long)mock_rmt_blocks_used());
+
+    budget_check_transmitters();
+
+    // The gate stored on TX1 uses it when fitted, TX0 otherwise
+    const gate_t *gate = gates_get(gates_endpoint(0));
+    uint8_t expected_tx = came433_tx_count() > 1 ? 1 : 0;
+    TEST_CHECK(gate->cfg.tx == 1 && gate->tx == expected_tx, "EP1 resolved to TX%d", gate->tx);
+    size_t before = mock_rmt_burst_count();
+    TEST_CHECK(handle_button_click(gates_endpoint(0), esp_timer_get_time()) == ESP_OK, "EP1 press refused");
+    sim_run_for(ook_frame_duration_us(&gate->frame) * gate->cfg.repeats + BUDGET_SETTLE_US);
+    const mock_rmt_burst_t *burst = budget_last_burst(before);
+    TEST_CHECK(burst != NULL && burst->gpio == budget_tx_gpio[expected_tx], "EP1 press not sent on TX%d",
+               expected_tx);
+    gate_cfg_t cfg = gate->cfg;
+    TEST_CHECK((gates_set(gates_endpoint(0), &cfg) == ESP_OK) == (came433_tx_count() > 1),
+               "gates_set() with tx 1 and %d transmitter(s)", came433_tx_count());
+
+    // The receiver still arms after all of the above
+    TEST_CHECK(rf_learn_start(gates_endpoint(1), 1, RF_LEARN_TX_KEEP) == ESP_OK, "learning refused");
+    sim_run_for(BUDGET_SETTLE_US);
+    rmt_symbol_word_t idle = {.level0 = 0, .duration0 = 0};
+    TEST_CHECK(mock_rmt_rx_inject(RF_LEARN_GPIO, &idle, 1), "receiver not armed");
+    sim_run_for(2 * 1000 * 1000);
+
+    return test_finish("rmt budget  %d transmitter(s), LED and receiver: OK", came433_tx_count());
+}
@@ -0,0 +1,402 @@
+#include "sim.h"
+#include "test_support.h"
+#include "mock_rmt.h"
+#include "mock_zigbee.h"
+#include "came433.h"
+#include "gates.h"
+#include "mfr_cluster.h"
+#include "press_filter.h"
+#include "rf_sched.h"
+#include "rf_tx.h"
+#include "zcl_defer.h"
+#include "zigbee.h"
+#include "esp_timer.h"
+#include "zcl/esp_zigbee_zcl_on_off.h"
+#include "zcl/esp_zigbee_zcl_identify.h"
+#include <stdio.h>
+
+/*
+Command storm: zb_action_handler() (zigbee.c) fed On/Toggle commands,
+on_off attribute writes and Identify writes the way the stack delivers
+them, APS retries and double deliveries through both callbacks included.
+RMT, LED and Zigbee are the mocks, everything in between (press filter,
+scheduler, duty-cycle budget, RF workers) is the firmware. Two streams:
+- paced: the built-in script, each press once the previous burst ended.
+  Every logical press gives exactly one RF burst and one press
+  notification, whatever the number of deliveries;
+- storm: a randomized stream (fixed seed) at STORM_RATE_HZ deliveries/s.
+  A press that finds its gate's burst still running merges into it: every
+  logical press is sent or merged, exactly once, and only sent presses
+  are notified.
+*/
+
+#define STORM_RATE_HZ 200
+#define STORM_PRESSES 500
+#define STORM_SEED 433
+#define STORM_TICK_MS 10                   // Deliveries due are sent in one batch, alarms run after it
+#define STORM_SETTLE_US (60LL * 1000 * 1000)
+#define STORM_SRC_ADDR 0x5A5A              // Fake sender short address
+#define STORM_DUP_PERCENT 30               // Press delivered a second time (APS retry)
+#define STORM_BOTH_PATHS_PERCENT 20        // Press also seen as an on_off attribute write
+#define STORM_IDENTIFY_PERCENT 10          // Identify write interleaved after a press
+#define STORM_PRESS_MAX_STEPS 4            // One press: delivery, Identify, retry, other path
+
+typedef enum {
+    STORM_CMD_ON = 0,       // Custom cluster callback, On command
+    STORM_CMD_TOGGLE,       // Custom cluster callback, Toggle command
+    STORM_ATTR_ON_OFF,      // Set-attribute callback, on_off = true (fallback path)
+    STORM_ATTR_IDENTIFY,    // Set-attribute callback, IdentifyTime
+} storm_kind_t;
+
+typedef struct {
+    uint8_t kind;           // storm_kind_t
+    uint8_t gate;           // Gate index, modulo gates_count()
+    bool new_press;         // First delivery of a logical press (new TSN)
+} storm_step_t;
+
+/*
+Each line is one situation seen in the field.
+*/
+static const storm_step_t storm_script[] = {
+    // Plain press
+    {STORM_CMD_ON, 0, true},
+    // Same press through both callbacks
+    {STORM_CMD_TOGGLE, 1, true}, {STORM_ATTR_ON_OFF, 1, false},
+    // APS retry of the same frame
+    {STORM_CMD_ON, 0, true}, {STORM_CMD_ON, 0, false},
+    // Toggles across endpoints
+    {STORM_CMD_TOGGLE, 0, true}, {STORM_CMD_TOGGLE, 1, true}, {STORM_CMD_TOGGLE, 0, true}, {STORM_CMD_TOGGLE, 1, true},
+    // Identify write between two deliveries of a press
+    {STORM_CMD_ON, 0, true}, {STORM_ATTR_IDENTIFY, 0, false}, {STORM_CMD_ON, 0, false},
+};
+
+#define STORM_SCRIPT_LEN (sizeof(storm_script) / sizeof(storm_script[0]))
+
+static const int storm_tx_gpio[CAME_TX_MAX] = {CAME_GPIO, CAME_TX2_GPIO};
+
+static uint8_t storm_tsn = 0;
+static uint32_t storm_rng = STORM_SEED;
+
+// Counters the invariants are checked against, sampled before and after a stream
+typedef struct {
+    size_t bursts;
+    size_t notifications;
+    uint32_t sent;
+    uint32_t dropped;
+    uint32_t duplicates;
+    uint32_t merged;
+} storm_totals_t;
+
+// ====== Stream ======
+// xorshift32: the same stream on every run
+static uint32_t storm_rand(void)
+{
+    storm_rng ^= storm_rng << 13;
+    storm_rng ^= storm_rng >> 17;
+    storm_rng ^= storm_rng << 5;
+    return storm_rng;
+}
+
+static bool storm_chance(uint32_t percent)
+{
+    return storm_rand() % 100 < percent;
+}
+
+/**
+ * @brief Expand one random logical press into its deliveries
+ */
+static uint8_t storm_random_press(storm_step_t *steps)
+{
+    uint8_t gate = storm_rand() % gates_count();
+    uint8_t kind = storm_chance(50) ? STORM_CMD_ON : STORM_CMD_TOGGLE;
+    uint8_t count = 0;
+
+    steps[count++] = (storm_step_t){kind, gate, true};
+    if (storm_chance(STORM_IDENTIFY_PERCENT)) {
+        steps[count++] = (storm_step_t){STORM_ATTR_IDENTIFY, gate, false};
+    }
+    if (storm_chance(STORM_DUP_PERCENT)) {
+        steps[count++] = (storm_step_t){kind, gate, false};
+    }
+    if (storm_chance(STORM_BOTH_PATHS_PERCENT)) {
+        steps[count++] = (storm_step_t){STORM_ATTR_ON_OFF, gate, false};
+    }
+    return count;
+}
+
+/**
+ * @brief Deliveries of the script's logical press starting at @p pos
+ */
+static uint8_t storm_script_press(size_t pos, storm_step_t *steps)
+{
+    uint8_t count = 0;
+
+    do {
+        steps[count++] = storm_script[pos++];
+    } while (pos < STORM_SCRIPT_LEN && !storm_script[pos].new_press && count < STORM_PRESS_MAX_STEPS);
+    return count;
+}
+
+static bool storm_is_duplicate(const storm_step_t *step)
+{
+    return !step->new_press && step->kind != STORM_ATTR_IDENTIFY;
+}
+
+// ====== Injection ======
+/**
+ * @brief Build the stack message for @p step and hand it to the action handler
+ */
+static void storm_deliver(const storm_step_t *step)
+{
+    uint8_t endpoint = gates_endpoint(step->gate % gates_count());
+    esp_err_t ret;
+
+    if (step->new_press) {
+        storm_tsn++;
+    }
+    if (step->kind == STORM_CMD_ON || step->kind == STORM_CMD_TOGGLE) {
+        esp_zb_zcl_custom_cluster_command_message_t cmd = {
+            .info = {
+                .status = ESP_ZB_ZCL_STATUS_SUCCESS,
+                .header.tsn = storm_tsn,
+                .src_address.u.addr_short = STORM_SRC_ADDR,
+                .src_endpoint = 1,
+                .dst_endpoint = endpoint,
+                .cluster = ESP_ZB_ZCL_CLUSTER_ID_ON_OFF,
+                .profile = ESP_ZB_AF_HA_PROFILE_ID,
+                .command.id = step->kind == STORM_CMD_ON ? ESP_ZB_ZCL_CMD_ON_OFF_ON_ID : ESP_ZB_ZCL_CMD_ON_OFF_TOGGLE_ID,
+            },
+        };
+        ret = zb_action_handler(ESP_ZB_CORE_CMD_CUSTOM_CLUSTER_REQ_CB_ID, &cmd);
+    } else {
+        uint8_t on_off = 1;
+        uint16_t identify_time = 0;
+        bool identify = step->kind == STORM_ATTR_IDENTIFY;
+        esp_zb_zcl_set_attr_value_message_t attr = {
+            .info = {
+                .status = ESP_ZB_ZCL_STATUS_SUCCESS,
+                .dst_endpoint = endpoint,
+                .cluster = identify ? ESP_ZB_ZCL_CLUSTER_ID_IDENTIFY : ESP_ZB_ZCL_CLUSTER_ID_ON_OFF,
+            },
+            .attribute = {
+                .id = identify ? ESP_ZB_ZCL_ATTR_IDENTIFY_IDENTIFY_TIME_ID : ESP_ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID,
+                .data = {
+                    .type = identify ? ESP_ZB_ZCL_ATTR_TYPE_U16 : ESP_ZB_ZCL_ATTR_TYPE_BOOL,
+                    .size = identify ? sizeof(identify_time) : sizeof(on_off),
+                    .value = identify ? (void *)&identify_time : (void *)&on_off,
+                },
+            },
+        };
+        ret = zb_action_handler(ESP_ZB_CORE_SET_ATTR_VALUE_CB_ID, &attr);
+    }
+    TEST_CHECK(ret == ESP_OK, "EP%d: handler returned %s", endpoint, esp_err_to_name(ret));
+}
+
+/**
+ * @brief Run the stack's alarms due now
+ *
+ * However many triggers the batch held, at most one on_off clear waits per
+ * gate, plus the zcl_defer drain that re-arms itself.
+ */
+static void storm_run_alarms(void)
+{
+    TEST_CHECK(mock_zb_alarms_pending() <= gates_count() + 1u, "%zu alarms pending for %d gates",
+               mock_zb_alarms_pending(), gates_count());
+    mock_zb_alarm_run_due();
+}
+
+// ====== Invariants ======
+static size_t storm_notifications(void)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < mock_zb_cmd_count(); i++) {
+        const mock_zb_cmd_t *cmd = mock_zb_cmd(i);
+        if (cmd->cluster_id != ZB433_MFR_CLUSTER_ID || cmd->cmd_id != ZB433_MFR_CMD_PRESS_ID) {
+            continue;
+        }
+        TEST_CHECK(cmd->address_mode == ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT &&
+                   gates_get(cmd->src_endpoint) != NULL,
+                   "press notification from EP%d not sent through the binding table", cmd->src_endpoint);
+        count++;
+    }
+    return count;
+}
+
+static void storm_sample(storm_totals_t *totals)
+{
+    rf_tx_stats_t rf;
+
+    rf_tx_get_stats(&rf);
+    *totals = (storm_totals_t){
+        .bursts = mock_rmt_burst_count(),
+        .notifications = storm_notifications(),
+        .sent = rf.sent,
+        .dropped = rf.dropped,
+    };
+    for (int i = 0; i < gates_count(); i++) {
+        uint32_t duplicates, merged;
+        press_filter_get_stats(gates_endpoint(i), &duplicates, &merged);
+        totals->duplicates += duplicates;
+        totals->merged += merged;
+    }
+}
+
+static bool storm_rf_idle(void)
+{
+    for (int i = 0; i < gates_count(); i++) {
+        if (rf_tx_endpoint_busy(gates_endpoint(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Let the RF workers drain, running the stack's alarms on the way
+ */
+static void storm_settle(void)
+{
+    int64_t deadline = esp_timer_get_time() + STORM_SETTLE_US;
+
+    while (!storm_rf_idle() && esp_timer_get_time() < deadline) {
+        sim_run_for(STORM_TICK_MS * 1000);
+        storm_run_alarms();
+    }
+    sim_run_for(ZCL_DEFER_IDLE_MS * 1000);
+    storm_run_alarms();
+    TEST_CHECK(storm_rf_idle(), "RF queues not drained %lld s after the last delivery",
+               (long long)(STORM_SETTLE_US / 1000000));
+}
+
+/**
+ * @brief Bursts since @p first: complete, on a fitted transmitter, never two at once on one
+ */
+static void storm_check_bursts(size_t first)
+{
+    for (size_t i = first; i < mock_rmt_burst_count(); i++) {
+        const mock_rmt_burst_t *burst = mock_rmt_burst(i);
+        TEST_CHECK(!burst->aborted, "burst %zu aborted", i);
+        TEST_CHECK(burst->gpio == storm_tx_gpio[0] ||
+                   (came433_tx_count() > 1 && burst->gpio == storm_tx_gpio[1]), "burst %zu on GPIO%d", i, burst->gpio);
+        for (size_t j = first; j < i; j++) {
+            const mock_rmt_burst_t *other = mock_rmt_burst(j);
+            TEST_CHECK(other->gpio != burst->gpio || other->end_us <= burst->start_us,
+                       "bursts %zu and %zu overlap on GPIO%d", j, i, burst->gpio);
+        }
+    }
+}
+
+// ====== Streams ======
+/**
+ * @brief Script, one logical press at a time: one burst and one notification each
+ */
+static void storm_paced(void)
+{
+    storm_step_t steps[STORM_PRESS_MAX_STEPS];
+    size_t first_burst = mock_rmt_burst_count();
+    uint32_t presses = 0;
+
+    for (size_t pos = 0; pos < STORM_SCRIPT_LEN;) {
+        uint8_t count = storm_script_press(pos, steps);
+        storm_totals_t before, after;
+        uint32_t duplicates = 0;
+
+        storm_sample(&before);
+        for (uint8_t i = 0; i < count; i++) {
+            storm_deliver(&steps[i]);
+            duplicates += storm_is_duplicate(&steps[i]);
+            storm_run_alarms();
+        }
+        storm_settle();
+        storm_sample(&after);
+
+        TEST_CHECK(after.bursts - before.bursts == 1 && after.sent - before.sent == 1,
+                   "script step %zu: %zu RF bursts for one press", pos, after.bursts - before.bursts);
+        TEST_CHECK(after.notifications - before.notifications == 1,
+                   "script step %zu: %zu press notifications for one press", pos,
+                   after.notifications - before.notifications);
+        TEST_CHECK(after.duplicates - before.duplicates == duplicates && after.merged == before.merged,
+                   "script step %zu: %lu duplicates filtered, %u delivered", pos,
+                   (unsigned long)(after.duplicates - before.duplicates), (unsigned)duplicates);
+        pos += count;
+        presses++;
+    }
+    storm_check_bursts(first_burst);
+    printf("storm       paced script: %lu presses, one burst and one notification each\n", (unsigned long)presses);
+}
+
+/**
+ * @brief Random stream at STORM_RATE_HZ: every press sent or merged, exactly once
+ */
+static void storm_random(void)
+{
+    storm_step_t steps[STORM_PRESS_MAX_STEPS];
+    uint8_t count = 0, next = 0;
+    uint32_t presses = 0, deliveries = 0, duplicates = 0;
+    storm_totals_t before, after;
+    size_t first_burst = mock_rmt_burst_count();
+
+    storm_sample(&before);
+    int64_t start_us = esp_timer_get_time();
+    while (presses < STORM_PRESSES || next < count) {
+        // Every delivery due by now, as the stack would after a busy loop iteration
+        uint64_t due = (uint64_t)(esp_timer_get_time() - start_us) * STORM_RATE_HZ / 1000000 + 1;
+        while (deliveries < due && (presses < STORM_PRESSES || next < count)) {
+            if (next == count) {
+                count = storm_random_press(steps);
+                next = 0;
+                presses++;
+            }
+            storm_deliver(&steps[next]);
+            duplicates += storm_is_duplicate(&steps[next]);
+            next++;
+            deliveries++;
+        }
+        storm_run_alarms();
+        sim_run_for(STORM_TICK_MS * 1000);
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    storm_settle();
+    storm_sample(&after);
+
+    uint32_t sent = after.sent - before.sent;
+    uint32_t merged = after.merged - before.merged;
+    TEST_CHECK(sent + merged == presses, "%lu presses: %lu sent + %lu merged", (unsigned long)presses,
+               (unsigned long)sent, (unsigned long)merged);
+    TEST_CHECK(after.bursts - before.bursts == sent && after.dropped == before.dropped,
+               "%zu RF bursts for %lu sent presses, %lu dropped", after.bursts - before.bursts,
+               (unsigned long)sent, (unsigned long)(after.dropped - before.dropped));
+    TEST_CHECK(after.notifications - before.notifications == sent, "%zu press notifications for %lu sent presses",
+               after.notifications - before.notifications, (unsigned long)sent);
+    TEST_CHECK(after.duplicates - before.duplicates == duplicates, "%lu duplicates filtered, %lu delivered",
+               (unsigned long)(after.duplicates - before.duplicates), (unsigned long)duplicates);
+    storm_check_bursts(first_burst);
+
+    rf_sched_stats_t sched;
+    rf_sched_get_stats(0, &sched);
+    printf("storm       %lu presses, %lu deliveries in %lld ms (%d/s): %lu bursts, %lu merged, %lu duplicates, "
+           "TX0 wait max %lu ms\n", (unsigned long)presses, (unsigned long)deliveries, (long long)(elapsed_us / 1000),
+           STORM_RATE_HZ, (unsigned long)sent, (unsigned long)merged, (unsigned long)duplicates,
+           (unsigned long)(sched.wait_max_us / 1000));
+}
+
+int main(void)
+{
+    test_rf_path_start(&(test_rf_path_cfg_t){.endpoints = true});
+
+    storm_paced();
+    storm_random();
+
+    // Only the zcl_defer drain stays armed
+    TEST_CHECK(mock_zb_alarms_pending() == 1, "%zu alarms left", mock_zb_alarms_pending());
+    for (int i = 0; i < gates_count(); i++) {
+        TEST_CHECK(mock_zb_attr_writes(gates_endpoint(i), ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_LATENCY_ID) > 0,
+                   "EP%d: latency attribute never applied", gates_endpoint(i));
+        TEST_CHECK(mock_zb_attr_writes(gates_endpoint(i), ESP_ZB_ZCL_CLUSTER_ID_ON_OFF,
+                                       ESP_ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID) > 0, "EP%d: on_off never cleared",
+                   gates_endpoint(i));
+    }
+
+    return test_finish("storm       invariants: OK");
+}
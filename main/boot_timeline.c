@@ -0,0 +1,75 @@
+#include "boot_timeline.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <inttypes.h>
+
+static const char *TAG = "BOOT";
+
+#define BOOT_MARK_LABEL(name, label) label,
+static const char *const boot_labels[BOOT_MARK_COUNT] = {
+    BOOT_MARKS(BOOT_MARK_LABEL)
+};
+#undef BOOT_MARK_LABEL
+
+// Each mark is written once by a single task; 32-bit stores are atomic on RISC-V
+static uint32_t boot_stamps[BOOT_MARK_COUNT];
+static uint16_t boot_retries = 0;
+
+// ====== Public API ======
+void boot_mark(boot_mark_t mark)
+{
+    if (mark >= BOOT_MARK_COUNT || boot_stamps[mark] != 0) {
+        return;
+    }
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    boot_stamps[mark] = now ? now : 1;
+}
+
+void boot_retry(void)
+{
+    if (boot_retries < UINT16_MAX) {
+        boot_retries++;
+    }
+}
+
+uint32_t boot_mark_us(boot_mark_t mark)
+{
+    return mark < BOOT_MARK_COUNT ? boot_stamps[mark] : 0;
+}
+
+void boot_timeline_dump(void)
+{
+    uint32_t previous = 0;
+
+    ESP_LOGI(TAG, "Boot timeline (%u commissioning retries):", boot_retries);
+    for (int i = 0; i < BOOT_MARK_COUNT; i++) {
+        if (boot_stamps[i] == 0) {
+            ESP_LOGI(TAG, "  %-32s        -", boot_labels[i]);
+            continue;
+        }
+        ESP_LOGI(TAG, "  %-32s %8" PRIu32 " us (+%" PRIu32 ")", boot_labels[i], boot_stamps[i],
+                 boot_stamps[i] - previous);
+        previous = boot_stamps[i];
+    }
+}
+
+size_t boot_timeline_encode(uint8_t *buf, size_t size)
+{
+    if (size < BOOT_TIMELINE_REPORT_SIZE) {
+        return 0;
+    }
+
+    uint8_t *p = buf;
+    *p++ = BOOT_TIMELINE_REPORT_VERSION;
+    *p++ = BOOT_MARK_COUNT;
+    *p++ = boot_retries & 0xFF;
+    *p++ = boot_retries >> 8;
+    for (int i = 0; i < BOOT_MARK_COUNT; i++) {
+        uint32_t value = boot_stamps[i];
+        *p++ = value & 0xFF;
+        *p++ = (value >> 8) & 0xFF;
+        *p++ = (value >> 16) & 0xFF;
+        *p++ = (value >> 24) & 0xFF;
+    }
+    return p - buf;
+}
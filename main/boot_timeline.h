@@ -0,0 +1,68 @@
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Boot-to-ready timeline: esp_timer stamp of the first occurrence of each
+startup milestone, from app_main down to the network being usable. Kept
+for the whole uptime, logged once ready and readable over Zigbee, so slow
+recoveries after a power cut can be diagnosed in the field.
+*/
+
+// ====== Timeline Configuration ======
+#define BOOT_TIMELINE_REPORT_VERSION 1
+
+// Milestones, in the order they are normally reached
+#define BOOT_MARKS(X) \
+    X(APP_START,     "app_main") \
+    X(LED_INIT,      "LED ready") \
+    X(NVS_INIT,      "NVS ready") \
+    X(GATES_INIT,    "gate table and code book loaded") \
+    X(CAME_INIT,     "RMT TX ready") \
+    X(RF_TX_INIT,    "RF worker ready") \
+    X(ZB_TASK,       "Zigbee task running") \
+    X(ZB_START,      "Zigbee stack started") \
+    X(SKIP_STARTUP,  "stack initialized") \
+    X(BDB_START,     "BDB first start / reboot") \
+    X(STEERING,      "network steering done") \
+    X(READY,         "network ready")
+
+#define BOOT_MARK_ENUM(name, label) BOOT_MARK_##name,
+typedef enum {
+    BOOT_MARKS(BOOT_MARK_ENUM)
+    BOOT_MARK_COUNT
+} boot_mark_t;
+#undef BOOT_MARK_ENUM
+
+// Report: version, mark count, retry count (U16), then one U32 per mark (µs, 0 = not reached)
+#define BOOT_TIMELINE_REPORT_SIZE (1 + 1 + 2 + 4 * BOOT_MARK_COUNT)
+
+// ====== Function Prototypes ======
+/**
+ * @brief Stamp @p mark if it was not reached yet (any task)
+ */
+void boot_mark(boot_mark_t mark);
+
+/**
+ * @brief Count a commissioning retry
+ */
+void boot_retry(void);
+
+/**
+ * @brief Time from boot to @p mark in µs, 0 if not reached
+ */
+uint32_t boot_mark_us(boot_mark_t mark);
+
+/**
+ * @brief Log the timeline with the delta between milestones
+ */
+void boot_timeline_dump(void);
+
+/**
+ * @brief Serialize the timeline (little endian), returns the length written
+ */
+size_t boot_timeline_encode(uint8_t *buf, size_t size);
+
+#endif // BOOT_TIMELINE_H
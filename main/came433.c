@@ -1,4 +1,7 @@
 #include "came433.h"
+#include "ook_encoder.h"
+#include "rmt_mgr.h"
+#include "trace.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -6,8 +9,12 @@
 #include "driver/rmt_encoder.h"
 #include "driver/gpio.h"
 #include "soc/rmt_struct.h"
+#include "soc/soc_caps.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp_pm.h"
+#include "sdkconfig.h"
 #include <inttypes.h>
-#include <stdlib.h>
 
 static const char *TAG = "CAME433";
 
@@ -16,105 +23,139 @@ Hardware: High-side driver NPN+PNP (2N2222A + 2N2907A)
 - Idle (no TX): GPIO=0 → NPN OFF → PNP base pulled up by RB_PNP → PNP OFF → DATA pulled down by RPD
 - Active (TX): GPIO=1 → NPN ON → PNP base driven low → PNP ON → DATA = +5V (OOK active-high)
 Firmware requirement: keep GPIO low at startup and after transmission.
+The optional second module (CAME_TX2_GPIO) is expected behind the same driver.
 */
 // ====== RMT Configuration ======
-static rmt_channel_handle_t came_tx_channel = NULL;
-static rmt_encoder_handle_t came_encoder = NULL;
+// One memory block (48 symbols on the C6): a larger channel spans two of the four, and a
+// transmitter that time-shares the LED's channel could then no longer take its block
+#define CAME_RMT_MEM_SYMBOLS SOC_RMT_MEM_WORDS_PER_CHANNEL
 
-// ====== Helper Macros ======
-#define OUT_LEVEL(level) ((level) ? 1 : 0)
+typedef struct {
+    int gpio;
+    rmt_channel_handle_t channel;      // NULL while the slot is lent to the LED
+    rmt_encoder_handle_t encoder;      // Kept across channel reopen
+    rmt_mgr_client_t client;
+    volatile TaskHandle_t notify_task;
+    bool busy;
+    union {                            // Encoder payload, must live until TX done
+        ook_frame_t frame;
+        ook_sequence_t seq;
+    } payload;
+    came_tx_times_t times;
+#if CONFIG_PM_ENABLE
+    // Held from rmt_enable() to rmt_disable(): full clock for the TX ISR and exact done stamps
+    esp_pm_lock_handle_t pm_lock;
+#endif
+} came_tx_t;
+
+static came_tx_t came_tx[CAME_TX_MAX];
+static uint8_t came_tx_num = 0;
+static const char *const came_tx_names[CAME_TX_MAX] = {"RF TX0", "RF TX1"};
 
 // ====== Private Functions ======
 
 /**
- * @brief Encode a single CAME bit with exact timings
- * 
- * CAME bit encoding (based on Flipper Zero implementation):
- * - Bit 0: 320µs LOW + 640µs HIGH
- * - Bit 1: 640µs LOW + 320µs HIGH
+ * @brief RMT transmit-done event (ISR context)
+ *
+ * Wakes the task that started the transmission instead of having it block
+ * in rmt_tx_wait_all_done().
  */
-static void came_encode_bit(rmt_symbol_word_t *symbol, bool bit)
+static bool IRAM_ATTR came_tx_done_cb(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *edata, void *user_ctx)
 {
-    if (bit) {
-        // Bit 1: 640µs LOW + 320µs HIGH
-        symbol->level0 = OUT_LEVEL(0);
-        symbol->duration0 = CAME_LONG_GAP;
-        symbol->level1 = OUT_LEVEL(1);
-        symbol->duration1 = CAME_SHORT_PULSE;
-    } else {
-        // Bit 0: 320µs LOW + 640µs HIGH
-        symbol->level0 = OUT_LEVEL(0);
-        symbol->duration0 = CAME_SHORT_GAP;
-        symbol->level1 = OUT_LEVEL(1);
-        symbol->duration1 = CAME_LONG_PULSE;
+    came_tx_t *tx = user_ctx;
+    BaseType_t task_woken = pdFALSE;
+    TaskHandle_t task = tx->notify_task;
+    tx->times.done_us = esp_timer_get_time();
+    if (task != NULL) {
+        vTaskNotifyGiveFromISR(task, &task_woken);
     }
+    return task_woken == pdTRUE;
 }
 
-/**
- * @brief Encode CAME sync pulse (header + start bit)
- * 
- * CAME sync structure (based on Flipper Zero):
- * - Header: 24320µs LOW
- * - Start bit: 320µs HIGH
- */
-static void came_encode_sync(rmt_symbol_word_t *symbol)
+static void came_gpio_idle(int gpio)
 {
-    symbol->level0 = OUT_LEVEL(0);
-    symbol->duration0 = CAME_HEADER_DURATION;  // 24320µs header LOW
-    symbol->level1 = OUT_LEVEL(1);
-    symbol->duration1 = CAME_START_BIT_DURATION; // 320µs start bit HIGH
+    gpio_config_t io_conf = {
+        .intr_type = GPIO_INTR_DISABLE,
+        .mode = GPIO_MODE_OUTPUT,
+        .pin_bit_mask = (1ULL << gpio),
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+    };
+    ESP_ERROR_CHECK(gpio_config(&io_conf));
+
+    // Ensure transmitter is OFF (idle LOW)
+    ESP_ERROR_CHECK(gpio_set_level(gpio, 0));
 }
 
-/**
- * @brief Send a CAME 24-bit code with proper protocol structure
- */
-static void came_send_came_code(uint32_t code, uint8_t repeats)
+// rmt_mgr open hook: (re)create the channel on this transmitter's GPIO
+static esp_err_t came_channel_open(void *ctx)
 {
-    ESP_LOGI(TAG, "Sending CAME code: 0x%06X (%d repeats)", (unsigned int)code, repeats);
-    
-    // Ensure transmitter is OFF in idle state (idle LOW with high-side driver)
-    (void)gpio_set_level(CAME_GPIO, 0);
-    ESP_ERROR_CHECK(rmt_enable(came_tx_channel));
+    came_tx_t *tx = ctx;
 
-    // Calculate symbol count: sync + 24 bits per repeat
-    size_t symbols_per_repeat = 1 + 24; // 1 sync + 24 bits
-    size_t symbol_count = repeats * symbols_per_repeat;
-    rmt_symbol_word_t *symbols = malloc(symbol_count * sizeof(rmt_symbol_word_t));
+    rmt_tx_channel_config_t tx_chan_config = {
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .gpio_num = tx->gpio,
+        .mem_block_symbols = CAME_RMT_MEM_SYMBOLS,
+        .resolution_hz = 1000000, // 1µs resolution
+        .trans_queue_depth = 4,
+    };
+    esp_err_t ret = rmt_new_tx_channel(&tx_chan_config, &tx->channel);
+    if (ret != ESP_OK) {
+        return ret;
+    }
 
-    if (symbols == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate memory for CAME symbols");
-        return;
+    // Completion is signalled from the RMT ISR, nobody polls the channel
+    rmt_tx_event_callbacks_t tx_callbacks = {
+        .on_trans_done = came_tx_done_cb,
+    };
+    ret = rmt_tx_register_event_callbacks(tx->channel, &tx_callbacks, tx);
+    if (ret != ESP_OK) {
+        rmt_del_channel(tx->channel);
+        tx->channel = NULL;
     }
+    return ret;
+}
 
-    size_t symbol_idx = 0;
+// rmt_mgr close hook: the channel is disabled between bursts, delete it and park the pin LOW
+static void came_channel_close(void *ctx)
+{
+    came_tx_t *tx = ctx;
 
-    // Encode each repeat
-    for (int repeat = 0; repeat < repeats; repeat++) {
-        // Add sync pulse (header + start bit)
-        came_encode_sync(&symbols[symbol_idx++]);
+    ESP_ERROR_CHECK(rmt_del_channel(tx->channel));
+    tx->channel = NULL;
+    came_gpio_idle(tx->gpio);
+}
 
-        // Add 24 bits (MSB first)
-        for (int bit = 23; bit >= 0; bit--) {
-            bool bit_value = (code >> bit) & 1;
-            came_encode_bit(&symbols[symbol_idx++], bit_value);
-        }
-    }
+static esp_err_t came_tx_init(uint8_t index, int gpio)
+{
+    came_tx_t *tx = &came_tx[index];
 
-    // Transmit
-    rmt_transmit_config_t tx_config = {
-        .loop_count = 0, // No loop
-    };
+    ESP_LOGI(TAG, "Initializing transmitter %d on GPIO%d...", index, gpio);
+    tx->gpio = gpio;
+    came_gpio_idle(gpio);
 
-    ESP_ERROR_CHECK(rmt_transmit(came_tx_channel, came_encoder, symbols, 
-                                symbol_count * sizeof(rmt_symbol_word_t), &tx_config));
-    ESP_ERROR_CHECK(rmt_tx_wait_all_done(came_tx_channel, 1000));
+    // Configure RMT encoder (table-driven, multi-protocol), one per channel for concurrent bursts
+    ESP_ERROR_CHECK(ook_encoder_new(&tx->encoder));
 
-    free(symbols);
+    tx->client = (rmt_mgr_client_t){
+        .name = came_tx_names[index],
+        .open = came_channel_open,
+        .close = came_channel_close,
+        .ctx = tx,
+    };
+    // Not worth a boot loop: the gates fall back to the transmitters that did start
+    esp_err_t ret = rmt_mgr_register(&tx->client, false);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Transmitter %d unavailable: %s", index, esp_err_to_name(ret));
+        rmt_del_encoder(tx->encoder);
+        tx->encoder = NULL;
+        return ret;
+    }
 
-    // Return to idle (LOW) and disable channel
-    (void)gpio_set_level(CAME_GPIO, 0);
-    ESP_ERROR_CHECK(rmt_disable(came_tx_channel));
-    ESP_LOGI(TAG, "CAME code transmitted successfully");
+#if CONFIG_PM_ENABLE
+    ESP_ERROR_CHECK(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "came_tx", &tx->pm_lock));
+#endif
+    return ESP_OK;
 }
 
 // ====== Public API ======
@@ -123,44 +164,125 @@ void came433_init(void)
 {
     ESP_LOGI(TAG, "Initializing CAME 433MHz transmitter...");
 
-    // Configure GPIO
-    gpio_config_t io_conf = {
-        .intr_type = GPIO_INTR_DISABLE,
-        .mode = GPIO_MODE_OUTPUT,
-        .pin_bit_mask = (1ULL << CAME_GPIO),
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-    };
-    ESP_ERROR_CHECK(gpio_config(&io_conf));
-    
-    // Ensure transmitter is OFF at startup (idle LOW)
-    ESP_ERROR_CHECK(gpio_set_level(CAME_GPIO, 0));
+    if (came_tx_init(0, CAME_GPIO) == ESP_OK) {
+        came_tx_num = 1;
+    }
+#if CAME_TX2_GPIO >= 0
+    if (came_tx_num == 1 && came_tx_init(1, CAME_TX2_GPIO) == ESP_OK) {
+        came_tx_num = 2;
+    }
+#endif
 
-    // Configure RMT TX channel
-    rmt_tx_channel_config_t tx_chan_config = {
-        .clk_src = RMT_CLK_SRC_DEFAULT,
-        .gpio_num = CAME_GPIO,
-        .mem_block_symbols = 64,
-        .resolution_hz = 1000000, // 1µs resolution
-        .trans_queue_depth = 4,
+    ESP_LOGI(TAG, "CAME transmitters initialized successfully (%d)", came_tx_num);
+}
+
+uint8_t came433_tx_count(void)
+{
+    return came_tx_num;
+}
+
+/**
+ * @brief Wake, take the channel and enable it; the payload is already in tx->payload
+ */
+static esp_err_t came_tx_transmit(uint8_t index, size_t size, int loop_count, TaskHandle_t notify_task)
+{
+    came_tx_t *tx = &came_tx[index];
+
+    tx->times = (came_tx_times_t){0};
+    tx->times.wake_us = esp_timer_get_time();
+#if CONFIG_PM_ENABLE
+    // Switching the CPU back to max frequency is the wake cost reported as LAT_SEG_WAKE
+    esp_pm_lock_acquire(tx->pm_lock);
+#endif
+    // Reopening a channel lent to the LED is part of the same wake segment
+    esp_err_t ret = rmt_mgr_acquire(&tx->client, pdMS_TO_TICKS(CAME_ACQUIRE_TIMEOUT_MS));
+    if (ret != ESP_OK) {
+#if CONFIG_PM_ENABLE
+        esp_pm_lock_release(tx->pm_lock);
+#endif
+        return ret;
+    }
+
+    // Ensure transmitter is OFF in idle state (idle LOW with high-side driver)
+    (void)gpio_set_level(tx->gpio, 0);
+    tx->times.enable_us = esp_timer_get_time();
+    ESP_ERROR_CHECK(rmt_enable(tx->channel));
+    tx->busy = true;
+
+    rmt_transmit_config_t tx_config = {
+        .loop_count = loop_count,
     };
-    ESP_ERROR_CHECK(rmt_new_tx_channel(&tx_chan_config, &came_tx_channel));
 
-    // Configure RMT encoder
-    rmt_copy_encoder_config_t copy_encoder_config = {};
-    ESP_ERROR_CHECK(rmt_new_copy_encoder(&copy_encoder_config, &came_encoder));
+    tx->notify_task = notify_task;
+    ret = rmt_transmit(tx->channel, tx->encoder, &tx->payload, size, &tx_config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "TX%d: RMT transmit failed: %s", index, esp_err_to_name(ret));
+        came433_finish(index);
+        return ret;
+    }
+    // The channel is idle, so the first symbol goes out as soon as the call returns
+    tx->times.first_edge_us = esp_timer_get_time();
+    return ret;
+}
+
+esp_err_t came433_start(uint8_t index, const ook_frame_t *frame, uint8_t repeats, TaskHandle_t notify_task)
+{
+    if (index >= came_tx_num || frame == NULL || frame->proto == NULL || repeats == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Loop mode replays the block: sync, bits and the end marker must all fit in it
+    if (frame->proto->bits + 2 > CAME_RMT_MEM_SYMBOLS) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (came_tx[index].busy) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    TRACE4(CAME_SEND, index, (uint32_t)(frame->proto - ook_protocols), frame->code, repeats);
+
+    // The hardware replays the frame; the encoder runs once per transmission
+    came_tx[index].payload.frame = *frame;
+    return came_tx_transmit(index, sizeof(ook_frame_t), repeats, notify_task);
+}
+
+esp_err_t came433_start_sequence(uint8_t index, const ook_sequence_t *seq, TaskHandle_t notify_task)
+{
+    if (index >= came_tx_num || seq == NULL || seq->count == 0 || seq->count > OOK_SEQ_MAX_STEPS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (int i = 0; i < seq->count; i++) {
+        if (seq->steps[i].frame.proto == NULL) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (came_tx[index].busy) {
+        return ESP_ERR_INVALID_STATE;
+    }
 
-    ESP_LOGI(TAG, "CAME 433MHz transmitter initialized successfully");
+    TRACE3(CAME_SEQUENCE, index, seq->count, ook_sequence_airtime_us(seq));
+
+    // No hardware loop: the encoder streams every step through the ping-pong memory block
+    came_tx[index].payload.seq = *seq;
+    return came_tx_transmit(index, sizeof(ook_sequence_t), 0, notify_task);
 }
 
-void came433_send_portail1(void)
+void came433_finish(uint8_t index)
 {
-    ESP_LOGI(TAG, "Sending Portail Principal (0x%06X)", (unsigned int)KEY_A);
-    came_send_came_code(KEY_A, CAME_REPEATS);
+    came_tx_t *tx = &came_tx[index];
+
+    tx->notify_task = NULL;
+    tx->busy = false;
+
+    // Return to idle (LOW) and disable channel
+    (void)gpio_set_level(tx->gpio, 0);
+    ESP_ERROR_CHECK(rmt_disable(tx->channel));
+    rmt_mgr_release(&tx->client);
+#if CONFIG_PM_ENABLE
+    esp_pm_lock_release(tx->pm_lock);
+#endif
 }
 
-void came433_send_portail2(void)
+void came433_get_times(uint8_t index, came_tx_times_t *times)
 {
-    ESP_LOGI(TAG, "Sending Portail Parking (0x%06X)", (unsigned int)KEY_B);
-    came_send_came_code(KEY_B, CAME_REPEATS);
-}
\ No newline at end of file
+    *times = came_tx[index].times;
+}
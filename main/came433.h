@@ -3,29 +3,73 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "ook_protocol.h"
+#include "came_timings.h"   // CAME_* pulse timings (IDF-free)
+#include "sdkconfig.h"
 
 // ====== Hardware Configuration ======
 // High-side driver NPN+PNP requires GPIO idle = LOW (0)
 #define CAME_GPIO 4                    // GPIO for CAME 433MHz TX (ESP32-C6 DevKit)
 #define CAME_CARRIER_FREQ 433920000    // 433.92 MHz
 #define CAME_REPEATS 5                 // Number of repetitions per transmission
+#define CAME_TX2_GPIO CONFIG_ZB433_RF_TX2_GPIO  // Optional second module (e.g. 868 MHz), -1 = none
+#define CAME_TX_MAX 2                  // Transmitters, indexed by gate_cfg_t.tx
+#define CAME_ACQUIRE_TIMEOUT_MS 100    // Wait for a time-shared RMT channel (LED refresh)
 
 // ====== CAME Protocol Keys ======
+// Factory defaults of the gate table (gates.c), overridden by NVS
 #define KEY_A  0x0003B29B  // Portail principal (24 bits)
 #define KEY_B  0x0003B29A  // Portail parking (24 bits)
 
-// ====== CAME Protocol Parameters (Working) ======
-// These parameters have been tested and work perfectly with Flipper Zero
-#define CAME_SHORT_PULSE 320           // Short pulse duration (µs)
-#define CAME_LONG_PULSE 640            // Long pulse duration (µs)
-#define CAME_SHORT_GAP 320             // Short gap duration (µs)
-#define CAME_LONG_GAP 640              // Long gap duration (µs)
-#define CAME_HEADER_DURATION 24320     // CAME header duration (µs)
-#define CAME_START_BIT_DURATION 320    // CAME start bit duration (µs)
+/**
+ * @brief esp_timer stamps of the last transmission (µs)
+ */
+typedef struct {
+    int64_t wake_us;        // CPU frequency lock requested
+    int64_t enable_us;      // Lock granted, RMT channel enabled
+    int64_t first_edge_us;  // Frame handed to the hardware by rmt_transmit()
+    int64_t done_us;        // on_trans_done event (last repeat left the pin)
+} came_tx_times_t;
 
 // ====== Public API ======
 void came433_init(void);
-void came433_send_portail1(void);
-void came433_send_portail2(void);
 
-#endif // CAME433_H
\ No newline at end of file
+/**
+ * @brief Number of transmitters configured (TX0 always, TX1 if CAME_TX2_GPIO is set)
+ */
+uint8_t came433_tx_count(void);
+
+/**
+ * @brief Start transmitting an OOK frame without waiting for completion
+ *
+ * The frame is encoded straight into RMT memory by the table-driven OOK
+ * encoder and played @p repeats times by the RMT hardware loop. The RMT
+ * on_trans_done event gives a task notification to @p notify_task once the
+ * last repeat has left the pin. The caller must then call came433_finish()
+ * before starting another transmission on @p tx. Different transmitters
+ * run concurrently.
+ */
+esp_err_t came433_start(uint8_t tx, const ook_frame_t *frame, uint8_t repeats, TaskHandle_t notify_task);
+
+/**
+ * @brief Start a multi-frame sequence as one RMT transaction (channel enabled once)
+ *
+ * Same completion contract as came433_start(): one done notification for
+ * the whole sequence, then came433_finish().
+ */
+esp_err_t came433_start_sequence(uint8_t tx, const ook_sequence_t *seq, TaskHandle_t notify_task);
+
+/**
+ * @brief Return the transmitter to idle after the done notification
+ */
+void came433_finish(uint8_t tx);
+
+/**
+ * @brief Stamps of the last transmission on @p tx, valid after came433_finish()
+ */
+void came433_get_times(uint8_t tx, came_tx_times_t *times);
+
+#endif // CAME433_H
@@ -0,0 +1,16 @@
+#ifndef CAME_TIMINGS_H
+#define CAME_TIMINGS_H
+
+// Pure protocol constants (no ESP-IDF dependency), shared by the encoder,
+// the protocol tables and anything that needs to reason about CAME frames.
+
+// ====== CAME Protocol Parameters (Working) ======
+// These parameters have been tested and work perfectly with Flipper Zero
+#define CAME_SHORT_PULSE 320           // Short pulse duration (µs)
+#define CAME_LONG_PULSE 640            // Long pulse duration (µs)
+#define CAME_SHORT_GAP 320             // Short gap duration (µs)
+#define CAME_LONG_GAP 640              // Long gap duration (µs)
+#define CAME_HEADER_DURATION 24320     // CAME header duration (µs)
+#define CAME_START_BIT_DURATION 320    // CAME start bit duration (µs)
+
+#endif // CAME_TIMINGS_H
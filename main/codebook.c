@@ -0,0 +1,221 @@
+#include "codebook.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include <inttypes.h>
+
+static const char *TAG = "CODEBOOK";
+
+#define CODEBOOK_BANKS 2
+
+typedef struct {
+    const esp_partition_t *part;
+    const codebook_header_t *header;    // Mapped start of the partition
+    esp_partition_mmap_handle_t mmap;
+    bool valid;
+} codebook_bank_t;
+
+static codebook_bank_t banks[CODEBOOK_BANKS];
+static const codebook_bank_t *active = NULL;
+
+// Update in progress: target bank, announced size and how far it is erased
+static codebook_bank_t *update_bank = NULL;
+static uint16_t update_count = 0;
+static uint32_t update_erased = 0;
+
+// ====== Private Functions ======
+static inline const codebook_entry_t *codebook_entries(const codebook_bank_t *bank)
+{
+    return (const codebook_entry_t *)(bank->header + 1);
+}
+
+static uint16_t codebook_capacity(const codebook_bank_t *bank)
+{
+    size_t capacity = (bank->part->size - sizeof(codebook_header_t)) / sizeof(codebook_entry_t);
+    return capacity > UINT16_MAX ? UINT16_MAX : (uint16_t)capacity;
+}
+
+static uint32_t codebook_crc(const codebook_bank_t *bank, uint16_t count)
+{
+    return esp_rom_crc32_le(0, (const uint8_t *)codebook_entries(bank), count * sizeof(codebook_entry_t));
+}
+
+static bool codebook_bank_check(const codebook_bank_t *bank)
+{
+    const codebook_header_t *header = bank->header;
+
+    if (header == NULL || header->magic != CODEBOOK_MAGIC) {
+        return false;
+    }
+    if (header->version != CODEBOOK_VERSION || header->entry_size != sizeof(codebook_entry_t) ||
+        header->count > codebook_capacity(bank)) {
+        ESP_LOGW(TAG, "%s: unsupported layout v%d, %d-byte entries", bank->part->label,
+                 header->version, header->entry_size);
+        return false;
+    }
+    if (codebook_crc(bank, header->count) != header->crc32) {
+        ESP_LOGW(TAG, "%s: CRC mismatch, bank ignored", bank->part->label);
+        return false;
+    }
+    return true;
+}
+
+static void codebook_select(void)
+{
+    active = NULL;
+    for (int i = 0; i < CODEBOOK_BANKS; i++) {
+        if (banks[i].valid && (active == NULL || banks[i].header->generation > active->header->generation)) {
+            active = &banks[i];
+        }
+    }
+}
+
+// ====== Public API ======
+void codebook_init(void)
+{
+    static const char *const labels[CODEBOOK_BANKS] = {CODEBOOK_BANK_A, CODEBOOK_BANK_B};
+
+    for (int i = 0; i < CODEBOOK_BANKS; i++) {
+        codebook_bank_t *bank = &banks[i];
+        bank->part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, CODEBOOK_PARTITION_SUBTYPE, labels[i]);
+        if (bank->part == NULL) {
+            ESP_LOGW(TAG, "Partition %s not found, code book disabled", labels[i]);
+            return;
+        }
+        const void *ptr = NULL;
+        esp_err_t ret = esp_partition_mmap(bank->part, 0, bank->part->size, ESP_PARTITION_MMAP_DATA, &ptr, &bank->mmap);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to map %s: %s", labels[i], esp_err_to_name(ret));
+            return;
+        }
+        bank->header = ptr;
+        bank->valid = codebook_bank_check(bank);
+    }
+
+    codebook_select();
+    if (active != NULL) {
+        ESP_LOGI(TAG, "%d codes from %s (generation %" PRIu32 ")", active->header->count,
+                 active->part->label, active->header->generation);
+    } else {
+        ESP_LOGI(TAG, "Code book empty");
+    }
+}
+
+uint16_t codebook_count(void)
+{
+    return active ? active->header->count : 0;
+}
+
+uint32_t codebook_generation(void)
+{
+    return active ? active->header->generation : 0;
+}
+
+const codebook_entry_t *codebook_get(uint16_t index)
+{
+    if (active == NULL || index >= active->header->count) {
+        return NULL;
+    }
+    const codebook_entry_t *entry = &codebook_entries(active)[index];
+    return entry->protocol < OOK_PROTO_COUNT ? entry : NULL;
+}
+
+bool codebook_frame(uint16_t index, ook_frame_t *frame, uint8_t *repeats)
+{
+    const codebook_entry_t *entry = codebook_get(index);
+    if (entry == NULL) {
+        return false;
+    }
+    frame->proto = ook_protocol_get((ook_protocol_id_t)entry->protocol);
+    frame->code = entry->code;
+    frame->te_us = entry->te_us;
+    if (entry->repeats > 0) {
+        *repeats = entry->repeats;
+    }
+    return true;
+}
+
+esp_err_t codebook_update_begin(uint16_t count)
+{
+    if (banks[0].header == NULL || banks[1].header == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    // Never write the bank in service
+    codebook_bank_t *target = (active == &banks[0]) ? &banks[1] : &banks[0];
+    if (count > codebook_capacity(target)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // The header sector goes first: the old content of this bank stops being a candidate
+    target->valid = false;
+    esp_err_t ret = esp_partition_erase_range(target->part, 0, SPI_FLASH_SEC_SIZE);
+    if (ret != ESP_OK) {
+        update_bank = NULL;
+        return ret;
+    }
+    update_bank = target;
+    update_count = count;
+    update_erased = SPI_FLASH_SEC_SIZE;
+    ESP_LOGI(TAG, "Update started: %d codes into %s", count, target->part->label);
+    return ESP_OK;
+}
+
+esp_err_t codebook_update_write(uint16_t first, const uint8_t *entries, size_t size)
+{
+    if (update_bank == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (size == 0 || size % sizeof(codebook_entry_t) != 0 ||
+        first + size / sizeof(codebook_entry_t) > update_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Sectors are erased on first use, so a small update never pays for the whole bank
+    uint32_t offset = sizeof(codebook_header_t) + first * sizeof(codebook_entry_t);
+    while (update_erased < offset + size) {
+        esp_err_t ret = esp_partition_erase_range(update_bank->part, update_erased, SPI_FLASH_SEC_SIZE);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        update_erased += SPI_FLASH_SEC_SIZE;
+    }
+    return esp_partition_write(update_bank->part, offset, entries, size);
+}
+
+esp_err_t codebook_update_commit(uint32_t crc32)
+{
+    if (update_bank == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    codebook_bank_t *bank = update_bank;
+    update_bank = NULL;
+    // Entries never written would read as erased flash (0xFF), which the CRC rejects too
+    if (update_erased < sizeof(codebook_header_t) + update_count * sizeof(codebook_entry_t) ||
+        codebook_crc(bank, update_count) != crc32) {
+        ESP_LOGW(TAG, "Update rejected: CRC mismatch");
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    codebook_header_t header = {
+        .magic = CODEBOOK_MAGIC,
+        .version = CODEBOOK_VERSION,
+        .entry_size = sizeof(codebook_entry_t),
+        .count = update_count,
+        .generation = codebook_generation() + 1,
+        .crc32 = crc32,
+    };
+    esp_err_t ret = esp_partition_write(bank->part, 0, &header, sizeof(header));
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    bank->valid = codebook_bank_check(bank);
+    if (!bank->valid) {
+        return ESP_ERR_INVALID_CRC;
+    }
+    codebook_select();
+    ESP_LOGI(TAG, "Update committed: %d codes, generation %" PRIu32, update_count, header.generation);
+    return ESP_OK;
+}
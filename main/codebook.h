@@ -0,0 +1,85 @@
+#ifndef CODEBOOK_H
+#define CODEBOOK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "ook_protocol.h"
+
+/*
+Code book: a flat table of OOK codes (protocol, timing, repeats) in two
+dedicated data partitions, memory-mapped at boot. Lookups return a pointer
+straight into flash, by index: nothing is parsed or copied into RAM.
+
+Updates are written to the inactive bank (begin / write / commit, driven
+by the ZB433 cluster) and only become visible when the header, written
+last, validates. A torn update leaves the previous bank in service.
+
+Bank layout (little endian):
+  codebook_header_t
+  codebook_entry_t[count]
+*/
+
+// ====== Code Book Configuration ======
+#define CODEBOOK_PARTITION_SUBTYPE 0x40    // Custom data subtype, see partitions.csv
+#define CODEBOOK_BANK_A "codebook_a"
+#define CODEBOOK_BANK_B "codebook_b"
+#define CODEBOOK_MAGIC 0x42435A5A          // "ZZCB"
+#define CODEBOOK_VERSION 1
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t entry_size;     // sizeof(codebook_entry_t) of the writer
+    uint16_t count;
+    uint32_t generation;    // Highest valid generation is the active bank
+    uint32_t crc32;         // CRC-32 (IEEE, zlib) of the entries
+} codebook_header_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t protocol;       // ook_protocol_id_t
+    uint8_t repeats;        // 0 = repeats of the gate it is sent on
+    uint16_t te_us;         // 0 = protocol nominal timing
+    uint32_t code;
+} codebook_entry_t;
+
+// ====== Function Prototypes ======
+/**
+ * @brief Map both banks and select the valid one with the highest generation
+ */
+void codebook_init(void);
+
+uint16_t codebook_count(void);
+uint32_t codebook_generation(void);
+
+/**
+ * @brief Zero-copy lookup, NULL if @p index is out of range or the entry is invalid
+ */
+const codebook_entry_t *codebook_get(uint16_t index);
+
+/**
+ * @brief Resolve an entry into a frame ready for rf_tx_submit()
+ */
+bool codebook_frame(uint16_t index, ook_frame_t *frame, uint8_t *repeats);
+
+// Bulk update, Zigbee task only
+
+/**
+ * @brief Start filling the inactive bank with @p count entries (previous update discarded)
+ */
+esp_err_t codebook_update_begin(uint16_t count);
+
+/**
+ * @brief Write @p size bytes of packed entries starting at entry @p first
+ */
+esp_err_t codebook_update_write(uint16_t first, const uint8_t *entries, size_t size);
+
+/**
+ * @brief Check the entries against @p crc32, write the header and switch banks
+ *
+ * @return ESP_ERR_INVALID_CRC if the written entries do not match
+ */
+esp_err_t codebook_update_commit(uint32_t crc32);
+
+#endif // CODEBOOK_H
@@ -0,0 +1,353 @@
+#include "diagnostics.h"
+#include "mfr_cluster.h"
+#include "endpoints.h"
+#include "gates.h"
+#include "rf_tx.h"
+#include "zb_capacity.h"
+#include "heap_guard.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_zigbee_core.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "DIAG";
+
+/*
+Attribute storage handed to the stack at cluster creation. The stack keeps
+its own copy; these statics are only the initial values and the last
+sampled state used for change detection.
+*/
+static uint16_t diag_resets = 0;
+static uint16_t diag_neighbor_added = 0;
+static uint16_t diag_neighbor_removed = 0;
+
+static uint32_t diag_rf_sent = 0;
+static uint32_t diag_rf_dropped = 0;
+static uint8_t diag_rf_queued = 0;
+static uint32_t diag_heap_free = 0;
+static uint32_t diag_heap_min_free = 0;
+static uint32_t diag_zb_stack_free = 0;
+static uint16_t diag_parent_changes = 0;
+static uint16_t diag_route_changes = 0;
+static uint16_t diag_neighbors_used = 0;
+static uint16_t diag_children_used = 0;
+static uint16_t diag_routes_used = 0;
+static uint16_t diag_table_full = 0;
+static uint32_t diag_zb_heap = 0;
+static uint32_t diag_late_allocs = 0;
+
+// Previous neighbor/route snapshot, to count changes between two samples. The
+// tables are counted in full against their stack capacity (ZB_CAP_STACK_*);
+// only the first DIAG_MAX_* entries are kept to be diffed.
+static uint16_t diag_neighbors[DIAG_MAX_NEIGHBORS];
+static uint16_t diag_neighbor_count = 0;
+static uint16_t diag_parent = 0xFFFF;
+static esp_zb_nwk_route_info_t diag_routes[DIAG_MAX_ROUTES];
+static uint16_t diag_route_count = 0;
+
+// Current sample, static rather than on the Zigbee task stack (sized by the profile)
+static uint16_t diag_neighbors_now[DIAG_MAX_NEIGHBORS];
+static esp_zb_nwk_route_info_t diag_routes_now[DIAG_MAX_ROUTES];
+
+// Which tables were at capacity on the previous sample (DIAG_FULL_* bits)
+#define DIAG_FULL_NEIGHBORS (1 << 0)
+#define DIAG_FULL_CHILDREN (1 << 1)
+#define DIAG_FULL_ROUTES (1 << 2)
+static uint8_t diag_full_mask = 0;
+
+typedef struct {
+    uint16_t cluster_id;
+    uint16_t attr_id;
+    uint32_t delta;         // Reportable change
+} diag_report_t;
+
+// Default reporting, applied once the endpoints are registered
+static const diag_report_t diag_reports[] = {
+    {ESP_ZB_ZCL_CLUSTER_ID_DIAGNOSTICS, DIAG_ATTR_NUMBER_OF_RESETS_ID, 1},
+    {ESP_ZB_ZCL_CLUSTER_ID_DIAGNOSTICS, DIAG_ATTR_NEIGHBOR_ADDED_ID, 1},
+    {ESP_ZB_ZCL_CLUSTER_ID_DIAGNOSTICS, DIAG_ATTR_NEIGHBOR_REMOVED_ID, 1},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_RF_SENT_ID, 10},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_RF_DROPPED_ID, 1},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_RF_QUEUE_DEPTH_ID, 1},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_HEAP_FREE_ID, 4096},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_HEAP_MIN_FREE_ID, 1024},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_ZB_STACK_FREE_ID, 64},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_PARENT_CHANGES_ID, 1},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_ROUTE_CHANGES_ID, 1},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_NEIGHBORS_ID, 1},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_CHILDREN_ID, 1},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_ROUTES_ID, 1},
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_TABLE_FULL_ID, 1},
+#if CONFIG_ZB433_STATIC_ALLOC
+    {ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_LATE_ALLOCS_ID, 1},
+#endif
+};
+
+#define DIAG_ACCESS (ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY | ESP_ZB_ZCL_ATTR_ACCESS_REPORTING)
+
+// ====== Private Functions ======
+
+static uint8_t diag_endpoint(void)
+{
+    return gates_endpoint(0);
+}
+
+static void diag_set(uint16_t cluster_id, uint16_t attr_id, void *value)
+{
+    esp_zb_zcl_set_attribute_val(diag_endpoint(), cluster_id, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+                                 attr_id, value, false);
+}
+
+static bool diag_contains(const uint16_t *addrs, uint16_t count, uint16_t addr)
+{
+    for (int i = 0; i < count; i++) {
+        if (addrs[i] == addr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Diff the neighbor table against the previous sample
+ */
+static void diag_sample_neighbors(void)
+{
+    esp_zb_nwk_info_iterator_t it = ESP_ZB_NWK_INFO_ITERATOR_INIT;
+    esp_zb_nwk_neighbor_info_t neighbor;
+    uint16_t *current = diag_neighbors_now;
+    uint16_t count = 0;
+    uint16_t used = 0;
+    uint16_t children = 0;
+    uint16_t parent = 0xFFFF;
+
+    while (esp_zb_nwk_get_next_neighbor(&it, &neighbor) == ESP_OK) {
+        used++;
+        if (count < DIAG_MAX_NEIGHBORS) {
+            current[count++] = neighbor.short_addr;
+        }
+        if (neighbor.relationship == ESP_ZB_NWK_RELATIONSHIP_PARENT) {
+            parent = neighbor.short_addr;
+        } else if (neighbor.relationship == ESP_ZB_NWK_RELATIONSHIP_CHILD) {
+            children++;
+        }
+    }
+    diag_neighbors_used = used;
+    diag_children_used = children;
+
+    for (int i = 0; i < count; i++) {
+        if (!diag_contains(diag_neighbors, diag_neighbor_count, current[i])) {
+            diag_neighbor_added++;
+        }
+    }
+    for (int i = 0; i < diag_neighbor_count; i++) {
+        if (!diag_contains(current, count, diag_neighbors[i])) {
+            diag_neighbor_removed++;
+        }
+    }
+    if (parent != diag_parent && diag_parent != 0xFFFF) {
+        ESP_LOGW(TAG, "Parent changed: 0x%04hx -> 0x%04hx", diag_parent, parent);
+        diag_parent_changes++;
+    }
+
+    memcpy(diag_neighbors, current, count * sizeof(current[0]));
+    diag_neighbor_count = count;
+    diag_parent = parent;
+}
+
+/**
+ * @brief Count routes that appeared or changed next hop since the previous sample
+ */
+static void diag_sample_routes(void)
+{
+    esp_zb_nwk_info_iterator_t it = ESP_ZB_NWK_INFO_ITERATOR_INIT;
+    esp_zb_nwk_route_info_t *current = diag_routes_now;
+    esp_zb_nwk_route_info_t route;
+    uint16_t count = 0;
+    uint16_t used = 0;
+
+    while (esp_zb_nwk_get_next_route(&it, &route) == ESP_OK) {
+        used++;
+        if (count < DIAG_MAX_ROUTES) {
+            current[count++] = route;
+        }
+    }
+    diag_routes_used = used;
+
+    for (int i = 0; i < count; i++) {
+        bool same = false;
+        for (int j = 0; j < diag_route_count; j++) {
+            if (diag_routes[j].dest_addr == current[i].dest_addr) {
+                same = diag_routes[j].next_hop_addr == current[i].next_hop_addr;
+                break;
+            }
+        }
+        if (!same) {
+            diag_route_changes++;
+        }
+    }
+
+    memcpy(diag_routes, current, count * sizeof(current[0]));
+    diag_route_count = count;
+}
+
+/**
+ * @brief Count one overflow event each time a table reaches its capacity
+ */
+static void diag_check_full(uint8_t bit, uint16_t used, uint16_t capacity, const char *name)
+{
+    if (used < capacity) {
+        diag_full_mask &= ~bit;
+        return;
+    }
+    if (!(diag_full_mask & bit)) {
+        diag_full_mask |= bit;
+        diag_table_full++;
+        ESP_LOGW(TAG, "%s table full (%u/%u): raise the capacity profile", name, used, capacity);
+    }
+}
+
+/**
+ * @brief Report heap allocations made since startup completed (zero-heap mode)
+ */
+static void diag_sample_heap_guard(void)
+{
+    heap_guard_stats_t guard;
+    heap_guard_get_stats(&guard);
+    if (guard.allocs != diag_late_allocs) {
+        ESP_LOGW(TAG, "Heap used after startup: %lu allocations, %lu bytes, largest %lu",
+                 (unsigned long)guard.allocs, (unsigned long)guard.bytes, (unsigned long)guard.largest);
+        diag_late_allocs = guard.allocs;
+    }
+}
+
+/**
+ * @brief Periodic sampler, runs in the Zigbee task (scheduler alarm)
+ */
+static void diag_sample_cb(uint8_t param)
+{
+    rf_tx_stats_t rf;
+    rf_tx_get_stats(&rf);
+    diag_rf_sent = rf.sent;
+    diag_rf_dropped = rf.dropped;
+    diag_rf_queued = rf.queued;
+
+    diag_heap_free = esp_get_free_heap_size();
+    diag_heap_min_free = esp_get_minimum_free_heap_size();
+    diag_zb_stack_free = uxTaskGetStackHighWaterMark(NULL);    // Zigbee_main: we run in it
+
+    diag_sample_neighbors();
+    diag_sample_routes();
+    diag_check_full(DIAG_FULL_NEIGHBORS, diag_neighbors_used, ZB_CAP_STACK_NEIGHBORS, "Neighbor");
+    diag_check_full(DIAG_FULL_CHILDREN, diag_children_used, ZB_CAP_STACK_CHILDREN, "Child");
+    diag_check_full(DIAG_FULL_ROUTES, diag_routes_used, ZB_CAP_STACK_ROUTES, "Route");
+    diag_sample_heap_guard();
+
+    diag_set(ESP_ZB_ZCL_CLUSTER_ID_DIAGNOSTICS, DIAG_ATTR_NEIGHBOR_ADDED_ID, &diag_neighbor_added);
+    diag_set(ESP_ZB_ZCL_CLUSTER_ID_DIAGNOSTICS, DIAG_ATTR_NEIGHBOR_REMOVED_ID, &diag_neighbor_removed);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_RF_SENT_ID, &diag_rf_sent);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_RF_DROPPED_ID, &diag_rf_dropped);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_RF_QUEUE_DEPTH_ID, &diag_rf_queued);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_HEAP_FREE_ID, &diag_heap_free);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_HEAP_MIN_FREE_ID, &diag_heap_min_free);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_ZB_STACK_FREE_ID, &diag_zb_stack_free);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_PARENT_CHANGES_ID, &diag_parent_changes);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_ROUTE_CHANGES_ID, &diag_route_changes);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_NEIGHBORS_ID, &diag_neighbors_used);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_CHILDREN_ID, &diag_children_used);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_ROUTES_ID, &diag_routes_used);
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_TABLE_FULL_ID, &diag_table_full);
+#if CONFIG_ZB433_STATIC_ALLOC
+    diag_set(ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_LATE_ALLOCS_ID, &diag_late_allocs);
+#endif
+
+    ESP_LOGD(TAG, "RF %lu sent / %lu dropped / %u queued, heap %lu (min %lu), Zigbee stack free %lu",
+             (unsigned long)diag_rf_sent, (unsigned long)diag_rf_dropped, diag_rf_queued,
+             (unsigned long)diag_heap_free, (unsigned long)diag_heap_min_free, (unsigned long)diag_zb_stack_free);
+
+    esp_zb_scheduler_alarm(diag_sample_cb, 0, DIAG_POLL_MS);
+}
+
+// ====== Public API ======
+void diagnostics_init(void)
+{
+    nvs_handle_t handle;
+    if (nvs_open(DIAG_NVS_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        ESP_LOGW(TAG, "NVS unavailable, reset counter not persisted");
+        return;
+    }
+    (void)nvs_get_u16(handle, DIAG_NVS_KEY_RESETS, &diag_resets);
+    diag_resets++;
+    if (nvs_set_u16(handle, DIAG_NVS_KEY_RESETS, diag_resets) == ESP_OK) {
+        nvs_commit(handle);
+    }
+    nvs_close(handle);
+    ESP_LOGI(TAG, "Boot #%u (reset reason %d)", diag_resets, esp_reset_reason());
+}
+
+void diagnostics_add_cluster(esp_zb_cluster_list_t *clusters)
+{
+    esp_zb_attribute_list_t *attr_list = esp_zb_zcl_attr_list_create(ESP_ZB_ZCL_CLUSTER_ID_DIAGNOSTICS);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, DIAG_ATTR_NUMBER_OF_RESETS_ID, ESP_ZB_ZCL_ATTR_TYPE_U16, DIAG_ACCESS, &diag_resets);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, DIAG_ATTR_NEIGHBOR_ADDED_ID, ESP_ZB_ZCL_ATTR_TYPE_U16, DIAG_ACCESS, &diag_neighbor_added);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, DIAG_ATTR_NEIGHBOR_REMOVED_ID, ESP_ZB_ZCL_ATTR_TYPE_U16, DIAG_ACCESS, &diag_neighbor_removed);
+    esp_zb_cluster_list_add_custom_cluster(clusters, attr_list, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
+}
+
+void diagnostics_add_mfr_attrs(esp_zb_attribute_list_t *attr_list)
+{
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_RF_SENT_ID, ESP_ZB_ZCL_ATTR_TYPE_U32, DIAG_ACCESS, &diag_rf_sent);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_RF_DROPPED_ID, ESP_ZB_ZCL_ATTR_TYPE_U32, DIAG_ACCESS, &diag_rf_dropped);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_RF_QUEUE_DEPTH_ID, ESP_ZB_ZCL_ATTR_TYPE_U8, DIAG_ACCESS, &diag_rf_queued);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_HEAP_FREE_ID, ESP_ZB_ZCL_ATTR_TYPE_U32, DIAG_ACCESS, &diag_heap_free);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_HEAP_MIN_FREE_ID, ESP_ZB_ZCL_ATTR_TYPE_U32, DIAG_ACCESS, &diag_heap_min_free);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_ZB_STACK_FREE_ID, ESP_ZB_ZCL_ATTR_TYPE_U32, DIAG_ACCESS, &diag_zb_stack_free);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_PARENT_CHANGES_ID, ESP_ZB_ZCL_ATTR_TYPE_U16, DIAG_ACCESS, &diag_parent_changes);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_ROUTE_CHANGES_ID, ESP_ZB_ZCL_ATTR_TYPE_U16, DIAG_ACCESS, &diag_route_changes);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_NEIGHBORS_ID, ESP_ZB_ZCL_ATTR_TYPE_U16, DIAG_ACCESS, &diag_neighbors_used);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_CHILDREN_ID, ESP_ZB_ZCL_ATTR_TYPE_U16, DIAG_ACCESS, &diag_children_used);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_ROUTES_ID, ESP_ZB_ZCL_ATTR_TYPE_U16, DIAG_ACCESS, &diag_routes_used);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_TABLE_FULL_ID, ESP_ZB_ZCL_ATTR_TYPE_U16, DIAG_ACCESS, &diag_table_full);
+    diag_zb_heap = zb_capacity_stack_heap();    // Measured by esp_zb_init(), which runs before the endpoints
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_ZB_HEAP_ID, ESP_ZB_ZCL_ATTR_TYPE_U32, ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &diag_zb_heap);
+#if CONFIG_ZB433_STATIC_ALLOC
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_LATE_ALLOCS_ID, ESP_ZB_ZCL_ATTR_TYPE_U32, DIAG_ACCESS, &diag_late_allocs);
+#endif
+}
+
+size_t diagnostics_neighbor_ram(void)
+{
+    return sizeof(diag_neighbors) + sizeof(diag_neighbors_now);
+}
+
+size_t diagnostics_route_ram(void)
+{
+    return sizeof(diag_routes) + sizeof(diag_routes_now);
+}
+
+void diagnostics_start(void)
+{
+    for (size_t i = 0; i < sizeof(diag_reports) / sizeof(diag_reports[0]); i++) {
+        esp_zb_zcl_reporting_info_t reporting_info = {
+            .direction = ESP_ZB_ZCL_CMD_DIRECTION_TO_SRV,
+            .ep = diag_endpoint(),
+            .cluster_id = diag_reports[i].cluster_id,
+            .cluster_role = ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+            .attr_id = diag_reports[i].attr_id,
+            .manuf_code = ESP_ZB_ZCL_ATTR_NON_MANUFACTURER_SPECIFIC,
+            .dst.profile_id = ESP_ZB_AF_HA_PROFILE_ID,
+            .u.send_info.min_interval = DIAG_REPORT_MIN_S,
+            .u.send_info.max_interval = DIAG_REPORT_MAX_S,
+            .u.send_info.def_min_interval = DIAG_REPORT_MIN_S,
+            .u.send_info.def_max_interval = DIAG_REPORT_MAX_S,
+            .u.send_info.delta.u32 = diag_reports[i].delta,
+        };
+        esp_zb_zcl_update_reporting_info(&reporting_info);
+    }
+
+    esp_zb_scheduler_alarm(diag_sample_cb, 0, DIAG_POLL_MS);
+    ESP_LOGI(TAG, "Diagnostics on EP%d, sampled every %d s", diag_endpoint(), CONFIG_ZB433_DIAG_POLL_S);
+}
@@ -0,0 +1,56 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <stdint.h>
+#include "esp_zigbee_cluster.h"
+#include <stddef.h>
+#include "zb_capacity.h"
+#include "sdkconfig.h"
+
+/*
+Router health, published on the first gate endpoint: the standard
+Diagnostics cluster (0x0B05) for what ZCL already defines, manufacturer
+attributes of the ZB433 cluster for the rest. Values are sampled in the
+Zigbee task and pushed through attribute reporting (defaults below, the
+coordinator can reconfigure them with Configure Reporting).
+*/
+
+// ====== Diagnostics Configuration ======
+#define DIAG_POLL_MS (CONFIG_ZB433_DIAG_POLL_S * 1000)
+#define DIAG_REPORT_MIN_S 60
+#define DIAG_REPORT_MAX_S 3600
+#define DIAG_MAX_NEIGHBORS ZB_CAP_TRACK_NEIGHBORS   // Entries diffed per sample, not the table capacity
+#define DIAG_MAX_ROUTES ZB_CAP_TRACK_ROUTES
+#define DIAG_NVS_NAMESPACE "zb433"
+#define DIAG_NVS_KEY_RESETS "resets"
+
+// Diagnostics cluster (0x0B05) attributes maintained by the router
+#define DIAG_ATTR_NUMBER_OF_RESETS_ID 0x0000
+#define DIAG_ATTR_NEIGHBOR_ADDED_ID 0x010F
+#define DIAG_ATTR_NEIGHBOR_REMOVED_ID 0x0110
+
+// ====== Function Prototypes ======
+/**
+ * @brief Count this boot in NVS (NumberOfResets), call once after nvs_flash_init()
+ */
+void diagnostics_init(void);
+
+void diagnostics_add_cluster(esp_zb_cluster_list_t *clusters);
+
+/**
+ * @brief Add the manufacturer health attributes to the ZB433 cluster attribute list
+ */
+void diagnostics_add_mfr_attrs(esp_zb_attribute_list_t *attr_list);
+
+/**
+ * @brief Set default reporting and start sampling (Zigbee task, after device registration)
+ */
+void diagnostics_start(void);
+
+/**
+ * @brief RAM taken by the neighbor and route snapshots (sized by the capacity profile)
+ */
+size_t diagnostics_neighbor_ram(void);
+size_t diagnostics_route_ram(void);
+
+#endif // DIAGNOSTICS_H
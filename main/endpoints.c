@@ -1,7 +1,15 @@
 #include "endpoints.h"
+#include "gates.h"
 #include "led.h"
 #include "came433.h"
+#include "rf_tx.h"
+#include "rf_sched.h"
 #include "zigbee.h"
+#include "mfr_cluster.h"
+#include "codebook.h"
+#include "diagnostics.h"
+#include "zb_ota.h"
+#include "trace.h"
 #include "esp_log.h"
 #include "esp_check.h"
 #include "freertos/FreeRTOS.h"
@@ -15,101 +23,166 @@ static const char *TAG = "BUTTONS";
 static uint8_t MANUFACTURER_NAME[] = {16, 'C','e','s','a','r',' ','R','I','C','H','A','R','D',' ','E','I'};
 static uint8_t MODEL_IDENTIFIER[] = {12, 'Z','B','4','3','3','-','R','o','u','t','e','r'};
 
+// Cluster defaults are identical for every gate: one copy, shared by all endpoints
+static esp_zb_basic_cluster_cfg_t basic_cfg = {
+    .zcl_version = ESP_ZB_ZCL_BASIC_ZCL_VERSION_DEFAULT_VALUE,
+    .power_source = ESP_ZB_ZCL_BASIC_POWER_SOURCE_DC_SOURCE
+};
+static esp_zb_on_off_cluster_cfg_t on_off_cfg = {.on_off = false};
+static esp_zb_identify_cluster_cfg_t identify_cfg = {.identify_time = 0};
 
 // ====== Endpoint Creation ======
-void create_endpoints(void)
+// The primary (first) endpoint also carries the device-wide diagnostics
+static esp_zb_cluster_list_t *create_gate_clusters(bool primary)
 {
-    // Create endpoint list
-    esp_zb_ep_list_t *ep_list = esp_zb_ep_list_create();
-
-    // Create EP1 (Portail Principal) - manual creation with server role
-    esp_zb_cluster_list_t *ep1_clusters = esp_zb_zcl_cluster_list_create();
-
-    // Basic cluster for EP1
-    esp_zb_basic_cluster_cfg_t basic_cfg_ep1 = {
-        .zcl_version = ESP_ZB_ZCL_BASIC_ZCL_VERSION_DEFAULT_VALUE,
-        .power_source = ESP_ZB_ZCL_BASIC_POWER_SOURCE_DC_SOURCE
-    };
-    esp_zb_attribute_list_t *basic_attr_list_ep1 = esp_zb_basic_cluster_create(&basic_cfg_ep1);
-    esp_zb_basic_cluster_add_attr(basic_attr_list_ep1, ESP_ZB_ZCL_ATTR_BASIC_MANUFACTURER_NAME_ID, MANUFACTURER_NAME);
-    esp_zb_basic_cluster_add_attr(basic_attr_list_ep1, ESP_ZB_ZCL_ATTR_BASIC_MODEL_IDENTIFIER_ID, MODEL_IDENTIFIER);
-    esp_zb_cluster_list_add_basic_cluster(ep1_clusters, basic_attr_list_ep1, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
-
-    // On/Off cluster for EP1 (SERVER role to receive commands)
-    esp_zb_on_off_cluster_cfg_t on_off_cfg_ep1 = {.on_off = false};
-    esp_zb_attribute_list_t *on_off_attr_list_ep1 = esp_zb_on_off_cluster_create(&on_off_cfg_ep1);
-    esp_zb_cluster_list_add_on_off_cluster(ep1_clusters, on_off_attr_list_ep1, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
-
-    // Identify cluster for EP1
-    esp_zb_identify_cluster_cfg_t identify_cfg_ep1 = {.identify_time = 0};
-    esp_zb_attribute_list_t *identify_attr_list_ep1 = esp_zb_identify_cluster_create(&identify_cfg_ep1);
-    esp_zb_cluster_list_add_identify_cluster(ep1_clusters, identify_attr_list_ep1, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
-
-    // Add EP1 to endpoint list
-    esp_zb_endpoint_config_t ep1_config = {
-        .endpoint = BUTTON_1_ENDPOINT,
-        .app_profile_id = ESP_ZB_AF_HA_PROFILE_ID,
-        .app_device_id = ESP_ZB_HA_ON_OFF_SWITCH_DEVICE_ID,
-        .app_device_version = 0
-    };
-    esp_zb_ep_list_add_ep(ep_list, ep1_clusters, ep1_config);
-
-    // Create EP2 (Portail Parking) - create cluster list manually and add to ep_list
-    esp_zb_cluster_list_t *ep2_clusters = esp_zb_zcl_cluster_list_create();
+    esp_zb_cluster_list_t *clusters = esp_zb_zcl_cluster_list_create();
 
     // Basic cluster
-    esp_zb_basic_cluster_cfg_t basic_cfg = {
-        .zcl_version = ESP_ZB_ZCL_BASIC_ZCL_VERSION_DEFAULT_VALUE,
-        .power_source = ESP_ZB_ZCL_BASIC_POWER_SOURCE_DC_SOURCE
-    };
     esp_zb_attribute_list_t *basic_attr_list = esp_zb_basic_cluster_create(&basic_cfg);
     esp_zb_basic_cluster_add_attr(basic_attr_list, ESP_ZB_ZCL_ATTR_BASIC_MANUFACTURER_NAME_ID, MANUFACTURER_NAME);
     esp_zb_basic_cluster_add_attr(basic_attr_list, ESP_ZB_ZCL_ATTR_BASIC_MODEL_IDENTIFIER_ID, MODEL_IDENTIFIER);
-    esp_zb_cluster_list_add_basic_cluster(ep2_clusters, basic_attr_list, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
+    esp_zb_cluster_list_add_basic_cluster(clusters, basic_attr_list, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
 
-    // On/Off cluster
-    esp_zb_on_off_cluster_cfg_t on_off_cfg = {.on_off = false};
+    // On/Off cluster (SERVER role to receive commands)
     esp_zb_attribute_list_t *on_off_attr_list = esp_zb_on_off_cluster_create(&on_off_cfg);
-    esp_zb_cluster_list_add_on_off_cluster(ep2_clusters, on_off_attr_list, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
+    esp_zb_cluster_list_add_on_off_cluster(clusters, on_off_attr_list, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
 
     // Identify cluster
-    esp_zb_identify_cluster_cfg_t identify_cfg = {.identify_time = 0};
     esp_zb_attribute_list_t *identify_attr_list = esp_zb_identify_cluster_create(&identify_cfg);
-    esp_zb_cluster_list_add_identify_cluster(ep2_clusters, identify_attr_list, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
-
-    // Add EP2 to endpoint list
-    esp_zb_endpoint_config_t ep2_config = {
-        .endpoint = BUTTON_2_ENDPOINT,
-        .app_profile_id = ESP_ZB_AF_HA_PROFILE_ID,
-        .app_device_id = ESP_ZB_HA_ON_OFF_SWITCH_DEVICE_ID,
-        .app_device_version = 0
-    };
-    esp_zb_ep_list_add_ep(ep_list, ep2_clusters, ep2_config);
-
-    // Register both endpoints
+    esp_zb_cluster_list_add_identify_cluster(clusters, identify_attr_list, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
+
+    // Diagnostics cluster (device health, reportable) and firmware upgrades
+    if (primary) {
+        diagnostics_add_cluster(clusters);
+        zb_ota_add_cluster(clusters);
+    }
+
+    // Manufacturer cluster (latency histograms, health counters)
+    mfr_cluster_add(clusters, primary);
+
+    return clusters;
+}
+
+void create_endpoints(void)
+{
+    // Create endpoint list
+    esp_zb_ep_list_t *ep_list = esp_zb_ep_list_create();
+
+    // One endpoint per gate, all built from the same cluster template
+    for (int i = 0; i < gates_count(); i++) {
+        esp_zb_endpoint_config_t ep_config = {
+            .endpoint = gates_endpoint(i),
+            .app_profile_id = ESP_ZB_AF_HA_PROFILE_ID,
+            .app_device_id = ESP_ZB_HA_ON_OFF_SWITCH_DEVICE_ID,
+            .app_device_version = 0
+        };
+        esp_zb_ep_list_add_ep(ep_list, create_gate_clusters(i == 0), ep_config);
+    }
+
+    // Register all endpoints
     ESP_LOGI(TAG, "Registering endpoints with Zigbee stack...");
     esp_zb_device_register(ep_list);
 
-    ESP_LOGI(TAG, "Endpoints EP%d and EP%d registered successfully", BUTTON_1_ENDPOINT, BUTTON_2_ENDPOINT);
+    ESP_LOGI(TAG, "Endpoints EP%d..EP%d registered successfully",
+             gates_endpoint(0), gates_endpoint(gates_count() - 1));
 }
 
 // ====== Button Click Detection ======
-void handle_button_click(uint8_t endpoint)
+// Runs in the Zigbee stack context: only queues the RF burst, never waits for it
+esp_err_t handle_button_click(uint8_t endpoint, int64_t arrival_us)
 {
-    switch (endpoint) {
-    case BUTTON_1_ENDPOINT:
-        ESP_LOGI(TAG, "Button 1 clicked - Portail Principal");
-        led_set_color(0, 128, 255);
-        came433_send_portail1();
-        break;
-    case BUTTON_2_ENDPOINT:
-        ESP_LOGI(TAG, "Button 2 clicked - Portail Parking");
-        led_set_color(255, 0, 255);
-        came433_send_portail2();
-        break;
-    default:
+    const gate_t *gate = gates_get(endpoint);
+    if (gate == NULL) {
         ESP_LOGW(TAG, "Unknown button endpoint: %d", endpoint);
-        break;
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    TRACE3(BUTTON_CLICK, endpoint, gate->cfg.protocol, gate->cfg.code);
+    led_set_color(gate->cfg.led_rgb[0], gate->cfg.led_rgb[1], gate->cfg.led_rgb[2]);
+    uint8_t priority = gate->cfg.high_priority ? RF_PRIO_HIGH : RF_PRIO_NORMAL;
+    esp_err_t ret = rf_tx_submit(endpoint, gate->tx, &gate->frame, gate->cfg.repeats, priority, arrival_us);
+    if (ret != ESP_OK) {
+        led_off();
+    }
+    return ret;
+}
+
+esp_err_t handle_code_click(uint8_t endpoint, uint16_t index, int64_t arrival_us)
+{
+    const gate_t *gate = gates_get(endpoint);
+    if (gate == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    ook_frame_t frame;
+    uint8_t repeats = gate->cfg.repeats;
+    if (!codebook_frame(index, &frame, &repeats)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    TRACE3(CODE_CLICK, endpoint, index, frame.code);
+    led_set_color(gate->cfg.led_rgb[0], gate->cfg.led_rgb[1], gate->cfg.led_rgb[2]);
+    uint8_t priority = gate->cfg.high_priority ? RF_PRIO_HIGH : RF_PRIO_NORMAL;
+    esp_err_t ret = rf_tx_submit(endpoint, gate->tx, &frame, repeats, priority, arrival_us);
+    if (ret != ESP_OK) {
+        led_off();
+    }
+    return ret;
+}
+
+esp_err_t handle_sequence_click(const endpoint_seq_step_t *steps, uint8_t count, int64_t arrival_us)
+{
+    ook_sequence_t seq = {.count = count};
+    uint8_t endpoints[OOK_SEQ_MAX_STEPS];
+    uint8_t priority = RF_PRIO_NORMAL;
+    const gate_t *first = NULL;
+
+    if (count == 0 || count > OOK_SEQ_MAX_STEPS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (int i = 0; i < count; i++) {
+        const gate_t *gate = gates_get(steps[i].endpoint);
+        if (gate == NULL) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        // One RMT transaction: every step goes out on the first gate's transmitter
+        if (first != NULL && gate->tx != first->tx) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        first = first ? first : gate;
+
+        ook_seq_step_t *step = &seq.steps[i];
+        step->frame = gate->frame;
+        step->repeats = gate->cfg.repeats;
+        if (steps[i].code_index != ENDPOINT_SEQ_GATE_CODE &&
+            !codebook_frame(steps[i].code_index, &step->frame, &step->repeats)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (steps[i].repeats != 0) {
+            step->repeats = steps[i].repeats;
+        }
+        step->gap_ms = steps[i].gap_ms < OOK_SEQ_MAX_GAP_MS ? steps[i].gap_ms : OOK_SEQ_MAX_GAP_MS;
+        endpoints[i] = steps[i].endpoint;
+        if (gate->cfg.high_priority) {
+            priority = RF_PRIO_HIGH;
+        }
+    }
+
+    led_set_color(first->cfg.led_rgb[0], first->cfg.led_rgb[1], first->cfg.led_rgb[2]);
+    esp_err_t ret = rf_tx_submit_sequence(first->tx, &seq, endpoints, priority, arrival_us);
+    if (ret != ESP_OK) {
+        led_off();
+    }
+    return ret;
+}
+
+// Called by the RF worker once the burst has left the antenna
+void handle_rf_done(uint8_t endpoint, esp_err_t status)
+{
+    if (status != ESP_OK) {
+        ESP_LOGW(TAG, "EP%d transmission failed: %s", endpoint, esp_err_to_name(status));
     }
     led_off();
+    mfr_cluster_publish_latency(endpoint);
 }
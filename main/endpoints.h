@@ -10,11 +10,41 @@
 #define ESP_ZB_AF_HA_PROFILE_ID 0x0104
 // Use On/Off Switch device id (was working before, try with Multistate Input)
 #define ESP_ZB_HA_ON_OFF_SWITCH_DEVICE_ID 0x0003
-#define BUTTON_1_ENDPOINT 1
-#define BUTTON_2_ENDPOINT 2
+// Gate endpoints start at GATE_FIRST_ENDPOINT, see gates.h
 
 // ====== Function Prototypes ======
 void create_endpoints(void);
-void handle_button_click(uint8_t endpoint);
+
+/**
+ * @brief Send the gate mapped to @p endpoint with its LED, repeats and priority
+ *
+ * @return ESP_ERR_NOT_FOUND for an unknown endpoint, else the rf_tx_submit() result
+ */
+esp_err_t handle_button_click(uint8_t endpoint, int64_t arrival_us);
+
+/**
+ * @brief Send code book entry @p index with the LED, repeats and priority of @p endpoint
+ */
+esp_err_t handle_code_click(uint8_t endpoint, uint16_t index, int64_t arrival_us);
+
+/**
+ * @brief One step of a scene: a gate, optionally with a code book entry instead of its own code
+ */
+typedef struct {
+    uint8_t endpoint;
+    uint16_t code_index;    // ENDPOINT_SEQ_GATE_CODE = the gate's own code
+    uint8_t repeats;        // 0 = the gate's repeat count
+    uint16_t gap_ms;        // Idle time before the next step
+} endpoint_seq_step_t;
+
+#define ENDPOINT_SEQ_GATE_CODE 0xFFFF
+
+/**
+ * @brief Send several gates back to back in one RMT transaction
+ *
+ * All steps must use the same transmitter. High priority if any gate is.
+ */
+esp_err_t handle_sequence_click(const endpoint_seq_step_t *steps, uint8_t count, int64_t arrival_us);
+void handle_rf_done(uint8_t endpoint, esp_err_t status);
 
 #endif // ENDPOINTS_H
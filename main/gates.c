@@ -0,0 +1,160 @@
+#include "gates.h"
+#include "came433.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include <stddef.h>
+#include <string.h>
+
+static const char *TAG = "GATES";
+
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t count;
+    gate_cfg_t gates[GATE_MAX];
+} gates_blob_t;
+
+static gate_t gate_table[GATE_MAX];
+static uint8_t gate_count = 0;
+static uint8_t gate_tx_count = CAME_TX_MAX;    // Transmitters fitted, known after gates_bind_tx()
+
+// Factory defaults: the two historical CAME-24 remotes
+static const gate_cfg_t gate_defaults[] = {
+    {.protocol = OOK_PROTO_CAME_24, .repeats = CAME_REPEATS, .code = KEY_A, .led_rgb = {0, 128, 255}},   // Portail principal
+    {.protocol = OOK_PROTO_CAME_24, .repeats = CAME_REPEATS, .code = KEY_B, .led_rgb = {255, 0, 255}},   // Portail parking
+};
+
+// ====== Private Functions ======
+static bool gate_cfg_valid(const gate_cfg_t *cfg)
+{
+    const ook_protocol_t *proto = ook_protocol_get((ook_protocol_id_t)cfg->protocol);
+    return proto != NULL && cfg->repeats > 0 && cfg->tx < CAME_TX_MAX;
+}
+
+static void gate_resolve(gate_t *gate, const gate_cfg_t *cfg)
+{
+    gate->cfg = *cfg;
+    gate->frame.proto = ook_protocol_get((ook_protocol_id_t)cfg->protocol);
+    gate->frame.code = cfg->code;
+    gate->frame.te_us = cfg->te_us;
+    gate->tx = cfg->tx < gate_tx_count ? cfg->tx : 0;
+}
+
+static esp_err_t gates_load(gates_blob_t *blob)
+{
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(GATES_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    size_t size = sizeof(*blob);
+    ret = nvs_get_blob(handle, GATES_NVS_KEY, blob, &size);
+    nvs_close(handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+
+    if (blob->count == 0 || blob->count > GATE_MAX) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    if (blob->version != GATES_BLOB_VERSION ||
+        size != offsetof(gates_blob_t, gates) + blob->count * sizeof(gate_cfg_t)) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t gates_save(void)
+{
+    gates_blob_t blob = {
+        .version = GATES_BLOB_VERSION,
+        .count = gate_count,
+    };
+    for (int i = 0; i < gate_count; i++) {
+        blob.gates[i] = gate_table[i].cfg;
+    }
+
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(GATES_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_set_blob(handle, GATES_NVS_KEY, &blob, offsetof(gates_blob_t, gates) + gate_count * sizeof(gate_cfg_t));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return ret;
+}
+
+// ====== Public API ======
+void gates_init(void)
+{
+    gates_blob_t blob;
+    esp_err_t ret = gates_load(&blob);
+
+    if (ret == ESP_OK) {
+        gate_count = 0;
+        for (int i = 0; i < blob.count; i++) {
+            if (!gate_cfg_valid(&blob.gates[i])) {
+                ESP_LOGW(TAG, "Gate %d has an invalid config, table truncated", i);
+                break;
+            }
+            gate_resolve(&gate_table[gate_count++], &blob.gates[i]);
+        }
+    }
+
+    if (ret != ESP_OK || gate_count == 0) {
+        ESP_LOGI(TAG, "No gate table in NVS (%s), using defaults", esp_err_to_name(ret));
+        gate_count = sizeof(gate_defaults) / sizeof(gate_defaults[0]);
+        for (int i = 0; i < gate_count; i++) {
+            gate_resolve(&gate_table[i], &gate_defaults[i]);
+        }
+    }
+
+    for (int i = 0; i < gate_count; i++) {
+        ESP_LOGI(TAG, "EP%d: %s 0x%06lX x%d on TX%d", gates_endpoint(i), gate_table[i].frame.proto->name,
+                 (unsigned long)gate_table[i].cfg.code, gate_table[i].cfg.repeats, gate_table[i].cfg.tx);
+    }
+}
+
+void gates_bind_tx(uint8_t tx_count)
+{
+    gate_tx_count = tx_count;
+    for (int i = 0; i < gate_count; i++) {
+        gate_t *gate = &gate_table[i];
+        if (gate->cfg.tx >= tx_count) {
+            ESP_LOGW(TAG, "EP%d: TX%d is not fitted, using TX0", gates_endpoint(i), gate->cfg.tx);
+        }
+        gate_resolve(gate, &gate->cfg);
+    }
+}
+
+uint8_t gates_count(void)
+{
+    return gate_count;
+}
+
+const gate_t *gates_get(uint8_t endpoint)
+{
+    int index = gates_index(endpoint);
+    return (index >= 0 && index < gate_count) ? &gate_table[index] : NULL;
+}
+
+esp_err_t gates_set(uint8_t endpoint, const gate_cfg_t *cfg)
+{
+    int index = gates_index(endpoint);
+
+    if (cfg == NULL || !gate_cfg_valid(cfg) || cfg->tx >= gate_tx_count || index < 0 || index > gate_count ||
+        index >= GATE_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    gate_resolve(&gate_table[index], cfg);
+    if (index == gate_count) {
+        // New endpoints only appear in the Zigbee descriptor after a reboot
+        gate_count++;
+    }
+    ESP_LOGI(TAG, "EP%d updated: %s 0x%06lX", endpoint, gate_table[index].frame.proto->name, (unsigned long)cfg->code);
+    return gates_save();
+}
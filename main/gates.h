@@ -0,0 +1,75 @@
+#ifndef GATES_H
+#define GATES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "ook_protocol.h"
+#include "sdkconfig.h"
+
+/*
+Gate table: one entry per barrier, endpoint N is gate N - GATE_FIRST_ENDPOINT.
+Loaded from NVS at boot (defaults: KEY_A / KEY_B from came433.h), then used
+for endpoint creation and O(1) command dispatch.
+*/
+
+// ====== Gate Table Configuration ======
+#define GATE_MAX CONFIG_ZB433_MAX_GATES
+#define GATE_FIRST_ENDPOINT 1
+#define GATES_NVS_NAMESPACE "zb433"
+#define GATES_NVS_KEY "gates"
+#define GATES_BLOB_VERSION 1            // Bump on any gate_cfg_t layout change
+
+/**
+ * @brief Persisted gate configuration (NVS blob layout, keep packed)
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t protocol;       // ook_protocol_id_t
+    uint8_t repeats;
+    uint16_t te_us;         // 0 = protocol nominal timing
+    uint32_t code;
+    uint8_t led_rgb[3];     // LED color while this gate transmits
+    uint8_t high_priority;  // 1 = served before normal gates by the RF scheduler
+    uint8_t tx;             // Transmitter index (came433), 0 = 433.92 MHz module
+} gate_cfg_t;
+
+typedef struct {
+    gate_cfg_t cfg;
+    ook_frame_t frame;      // Resolved from cfg, ready for the RF worker
+    uint8_t tx;             // Transmitter to use: cfg.tx, or TX0 if that one is not fitted
+} gate_t;
+
+// ====== Function Prototypes ======
+void gates_init(void);
+
+/**
+ * @brief Check every gate against the transmitters actually initialised (after came433_init())
+ *
+ * A gate bound to a missing transmitter falls back to TX0 with a warning;
+ * its stored configuration is kept for when the module is fitted. From
+ * then on gates_set() refuses tx >= @p tx_count.
+ */
+void gates_bind_tx(uint8_t tx_count);
+uint8_t gates_count(void);
+
+/**
+ * @brief Direct-indexed lookup, NULL if no gate is mapped to @p endpoint
+ */
+const gate_t *gates_get(uint8_t endpoint);
+
+static inline uint8_t gates_endpoint(uint8_t index)
+{
+    return GATE_FIRST_ENDPOINT + index;
+}
+
+static inline int gates_index(uint8_t endpoint)
+{
+    return (int)endpoint - GATE_FIRST_ENDPOINT;
+}
+
+/**
+ * @brief Replace (or append, for endpoint == count + first) a gate and persist the table
+ */
+esp_err_t gates_set(uint8_t endpoint, const gate_cfg_t *cfg);
+
+#endif // GATES_H
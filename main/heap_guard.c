@@ -0,0 +1,65 @@
+#include "heap_guard.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if CONFIG_ZB433_STATIC_ALLOC
+static const char *TAG = "HEAP_GUARD";
+
+static atomic_bool guard_armed = false;
+static atomic_uint_fast32_t guard_allocs = 0;
+static atomic_uint_fast32_t guard_bytes = 0;
+static atomic_uint_fast32_t guard_largest = 0;
+
+// ====== Heap Hooks ======
+/*
+Called by heap_caps for every allocation (CONFIG_HEAP_USE_HOOKS), from any
+task or ISR and possibly with the flash cache disabled: IRAM, lock-free,
+no logging.
+*/
+void IRAM_ATTR esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    if (ptr == NULL || !atomic_load_explicit(&guard_armed, memory_order_relaxed)) {
+        return;
+    }
+    atomic_fetch_add_explicit(&guard_allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&guard_bytes, size, memory_order_relaxed);
+
+    uint_fast32_t largest = atomic_load_explicit(&guard_largest, memory_order_relaxed);
+    while (size > largest &&
+           !atomic_compare_exchange_weak_explicit(&guard_largest, &largest, size,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void IRAM_ATTR esp_heap_trace_free_hook(void *ptr)
+{
+}
+#endif
+
+// ====== Public API ======
+void heap_guard_arm(void)
+{
+#if CONFIG_ZB433_STATIC_ALLOC
+    if (atomic_exchange(&guard_armed, true)) {
+        return;
+    }
+    ESP_LOGI(TAG, "Startup complete, heap frozen at %lu bytes free: later allocations are reported",
+             (unsigned long)esp_get_free_heap_size());
+#endif
+}
+
+void heap_guard_get_stats(heap_guard_stats_t *stats)
+{
+#if CONFIG_ZB433_STATIC_ALLOC
+    stats->allocs = atomic_load(&guard_allocs);
+    stats->bytes = atomic_load(&guard_bytes);
+    stats->largest = atomic_load(&guard_largest);
+#else
+    *stats = (heap_guard_stats_t){0};
+#endif
+}
@@ -0,0 +1,33 @@
+#ifndef HEAP_GUARD_H
+#define HEAP_GUARD_H
+
+#include <stdint.h>
+#include "sdkconfig.h"
+
+/*
+Zero-heap-after-init guard (CONFIG_ZB433_STATIC_ALLOC). Tasks, queues and
+semaphores are statically allocated; drivers and the Zigbee stack allocate
+only while starting up. Once the network is ready the guard is armed and
+every heap allocation from then on, ours or a library's, is counted
+through the heap hooks and reported by the diagnostics.
+Without the option the functions are no-ops and the counters stay at 0.
+*/
+
+/**
+ * @brief Heap allocations seen since the guard was armed
+ */
+typedef struct {
+    uint32_t allocs;
+    uint32_t bytes;
+    uint32_t largest;
+} heap_guard_stats_t;
+
+// ====== Function Prototypes ======
+/**
+ * @brief Startup is over: count every allocation from now on
+ */
+void heap_guard_arm(void);
+
+void heap_guard_get_stats(heap_guard_stats_t *stats);
+
+#endif // HEAP_GUARD_H
@@ -0,0 +1,153 @@
+#include "latency.h"
+#include "gates.h"
+#include "trace.h"
+#include <string.h>
+
+// Upper bounds (µs), roughly 1-2-5 per decade; the last bucket is open-ended
+static const uint32_t latency_bounds[LATENCY_BUCKETS] = {
+    100, 200, 500,
+    1000, 2000, 5000,
+    10000, 20000, 50000,
+    100000, 200000, 500000,
+    1000000, 2000000, 5000000,
+    UINT32_MAX,
+};
+
+typedef struct {
+    uint16_t buckets[LATENCY_BUCKETS];
+    uint32_t max_us;
+} latency_hist_t;
+
+typedef struct {
+    uint32_t samples;
+    latency_hist_t seg[LAT_SEG_COUNT];
+} latency_gate_t;
+
+static latency_gate_t latency_gates[GATE_MAX];
+
+// ====== Private Functions ======
+
+static latency_gate_t *latency_gate(uint8_t endpoint)
+{
+    int index = gates_index(endpoint);
+    return (index >= 0 && index < GATE_MAX) ? &latency_gates[index] : NULL;
+}
+
+static void latency_hist_add(latency_hist_t *hist, int64_t from_us, int64_t to_us)
+{
+    if (from_us == 0 || to_us < from_us) {
+        return;     // Stage not reached (e.g. TX error)
+    }
+
+    int64_t delta = to_us - from_us;
+    uint32_t value = delta > UINT32_MAX ? UINT32_MAX : (uint32_t)delta;
+
+    int b = 0;
+    while (value > latency_bounds[b]) {
+        b++;
+    }
+
+    // Saturated bucket: halve the whole histogram, percentiles keep their shape
+    if (hist->buckets[b] == UINT16_MAX) {
+        for (int i = 0; i < LATENCY_BUCKETS; i++) {
+            hist->buckets[i] /= 2;
+        }
+    }
+    hist->buckets[b]++;
+    if (value > hist->max_us) {
+        hist->max_us = value;
+    }
+}
+
+/**
+ * @brief Upper bound of the bucket holding the @p permille quantile, capped by the max
+ */
+static uint32_t latency_hist_quantile(const latency_hist_t *hist, uint32_t permille)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        total += hist->buckets[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    uint32_t rank = (total * permille + 999) / 1000;
+    uint32_t seen = 0;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            return latency_bounds[i] < hist->max_us ? latency_bounds[i] : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+static uint8_t *latency_put_u32(uint8_t *p, uint32_t value)
+{
+    p[0] = value & 0xFF;
+    p[1] = (value >> 8) & 0xFF;
+    p[2] = (value >> 16) & 0xFF;
+    p[3] = (value >> 24) & 0xFF;
+    return p + 4;
+}
+
+// ====== Public API ======
+void latency_record(uint8_t endpoint, const latency_stamps_t *stamps)
+{
+    latency_gate_t *gate = latency_gate(endpoint);
+    if (gate == NULL) {
+        return;
+    }
+
+    gate->samples++;
+    latency_hist_add(&gate->seg[LAT_SEG_DISPATCH], stamps->arrival_us, stamps->dispatch_us);
+    latency_hist_add(&gate->seg[LAT_SEG_QUEUE], stamps->dispatch_us, stamps->wake_us);
+    latency_hist_add(&gate->seg[LAT_SEG_WAKE], stamps->wake_us, stamps->enable_us);
+    latency_hist_add(&gate->seg[LAT_SEG_START], stamps->enable_us, stamps->first_edge_us);
+    latency_hist_add(&gate->seg[LAT_SEG_AIR], stamps->first_edge_us, stamps->done_us);
+    latency_hist_add(&gate->seg[LAT_SEG_TOTAL], stamps->arrival_us, stamps->done_us);
+
+    TRACE5(LAT_SAMPLE, endpoint,
+           (uint32_t)(stamps->dispatch_us - stamps->arrival_us),
+           (uint32_t)(stamps->enable_us - stamps->dispatch_us),
+           (uint32_t)(stamps->first_edge_us - stamps->enable_us),
+           (uint32_t)(stamps->done_us - stamps->first_edge_us));
+}
+
+void latency_get_summary(uint8_t endpoint, latency_seg_t seg, latency_summary_t *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+
+    latency_gate_t *gate = latency_gate(endpoint);
+    if (gate == NULL || seg >= LAT_SEG_COUNT) {
+        return;
+    }
+
+    const latency_hist_t *hist = &gate->seg[seg];
+    summary->p50_us = latency_hist_quantile(hist, 500);
+    summary->p95_us = latency_hist_quantile(hist, 950);
+    summary->p99_us = latency_hist_quantile(hist, 990);
+    summary->max_us = hist->max_us;
+}
+
+size_t latency_encode_report(uint8_t endpoint, uint8_t *buf, size_t size)
+{
+    latency_gate_t *gate = latency_gate(endpoint);
+    if (gate == NULL || size < LATENCY_REPORT_SIZE) {
+        return 0;
+    }
+
+    uint8_t *p = buf;
+    *p++ = LATENCY_REPORT_VERSION;
+    p = latency_put_u32(p, gate->samples);
+    for (int seg = 0; seg < LAT_SEG_COUNT; seg++) {
+        latency_summary_t summary;
+        latency_get_summary(endpoint, (latency_seg_t)seg, &summary);
+        p = latency_put_u32(p, summary.p50_us);
+        p = latency_put_u32(p, summary.p95_us);
+        p = latency_put_u32(p, summary.p99_us);
+        p = latency_put_u32(p, summary.max_us);
+    }
+    return p - buf;
+}
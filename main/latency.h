@@ -0,0 +1,64 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Command-to-RF latency, per gate endpoint. Every burst carries esp_timer
+stamps from the ZCL command arrival down to the RMT done event; each
+segment between two stamps feeds a fixed-bucket histogram so p50/p95/p99
+are available without storing samples.
+*/
+
+// ====== Latency Configuration ======
+#define LATENCY_BUCKETS 16
+#define LATENCY_REPORT_VERSION 2
+
+typedef enum {
+    LAT_SEG_DISPATCH = 0,   // ZCL arrival -> queued for RF (Zigbee task, our code)
+    LAT_SEG_QUEUE,          // Queued -> RF worker starts the burst (scheduler, duty cycle)
+    LAT_SEG_START,          // RMT enabled -> first edge
+    LAT_SEG_AIR,            // First edge -> RMT done (all repeats)
+    LAT_SEG_TOTAL,          // ZCL arrival -> RMT done
+    LAT_SEG_WAKE,           // PM lock requested -> CPU back at full clock (0 without power management)
+    LAT_SEG_COUNT
+} latency_seg_t;
+
+/**
+ * @brief esp_timer stamps of one burst (µs, 0 = stage not reached)
+ */
+typedef struct {
+    int64_t arrival_us;     // ZCL command entered zb_action_handler
+    int64_t dispatch_us;    // rf_tx_submit() queued the burst
+    int64_t wake_us;        // RF worker requested the CPU frequency lock
+    int64_t enable_us;      // rmt_enable()
+    int64_t first_edge_us;  // rmt_transmit() handed the frame to the hardware
+    int64_t done_us;        // on_trans_done ISR
+} latency_stamps_t;
+
+typedef struct {
+    uint32_t p50_us;
+    uint32_t p95_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} latency_summary_t;
+
+// Report layout (little endian): version, uint32 samples, then
+// LAT_SEG_COUNT x {p50, p95, p99, max} as uint32 µs
+#define LATENCY_REPORT_SIZE (1 + 4 + LAT_SEG_COUNT * 4 * 4)
+
+// ====== Function Prototypes ======
+/**
+ * @brief Account one completed burst (single writer: the RF worker)
+ */
+void latency_record(uint8_t endpoint, const latency_stamps_t *stamps);
+
+void latency_get_summary(uint8_t endpoint, latency_seg_t seg, latency_summary_t *summary);
+
+/**
+ * @brief Serialize all segments of @p endpoint, returns the bytes written (0 if too small)
+ */
+size_t latency_encode_report(uint8_t endpoint, uint8_t *buf, size_t size);
+
+#endif // LATENCY_H
@@ -1,74 +1,220 @@
 #include "led.h"
+#include "rmt_mgr.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include <stdlib.h>
 
 static const char *TAG = "LED";
 
-static led_strip_handle_t led_strip;
+/*
+LED engine: one task owns the strip and renders effects frame by frame.
+Callers (Zigbee stack callbacks, RF worker...) only overwrite a one-slot
+mailbox, so they never wait for led_strip_refresh() or for an animation;
+a new request replaces the running effect immediately.
+The strip's RMT channel comes from rmt_mgr and may be time-shared with an
+RF transmitter: a frame that cannot get the channel stays pending and is
+retried on the next frame tick, the LED never delays a burst.
+*/
 
-// ====== LED Initialization ======
-void led_init(void)
+typedef struct {
+    led_effect_t effect;
+    uint8_t rgb[3];
+    uint32_t duration_ms;
+} led_request_t;
+
+static led_strip_handle_t led_strip = NULL;
+static QueueHandle_t led_mailbox = NULL;
+static StaticQueue_t led_mailbox_buf;
+static uint8_t led_mailbox_storage[sizeof(led_request_t)];
+static StaticTask_t led_task_buf;
+static StackType_t led_task_stack[LED_TASK_STACK];
+static rmt_mgr_client_t led_client;
+static int32_t led_last = -1;          // Last frame sent to the strip, -1 = unknown
+static bool led_pending = false;       // A frame is waiting for the RMT channel
+
+// Breathing curve, one period in 64 steps: ((1 - cos) / 2) ^ 2.2 * 255
+static const uint8_t breathe_table[64] = {
+    0, 0, 0, 0, 0, 1, 1, 2, 4, 6, 9, 14, 19, 26, 34, 44,
+    55, 68, 82, 97, 113, 130, 147, 164, 180, 196, 210, 223, 234, 243, 250, 254,
+    255, 254, 250, 243, 234, 223, 210, 196, 180, 164, 147, 130, 113, 97, 82, 68,
+    55, 44, 34, 26, 19, 14, 9, 6, 4, 2, 1, 1, 0, 0, 0, 0,
+};
+#define BREATHE_PERIOD_MS 2000
+#define BLINK_HALF_PERIOD_MS 100
+
+// ====== RMT Channel ======
+static esp_err_t led_channel_open(void *ctx)
 {
-    ESP_LOGI(TAG, "Initializing LED RGB on GPIO%d", LED_GPIO);
-    
     led_strip_config_t strip_config = {
         .strip_gpio_num = LED_GPIO,
         .max_leds = LED_NUMBERS,
         .led_model = LED_MODEL_WS2812,
         .flags.invert_out = false,
     };
-    
+
     led_strip_rmt_config_t rmt_config = {
         .clk_src = RMT_CLK_SRC_DEFAULT,
         .resolution_hz = 10 * 1000 * 1000, // 10MHz
         .flags.with_dma = false,
     };
-    
-    ESP_ERROR_CHECK(led_strip_new_rmt_device(&strip_config, &rmt_config, &led_strip));
+
+    return led_strip_new_rmt_device(&strip_config, &rmt_config, &led_strip);
+}
+
+static void led_channel_close(void *ctx)
+{
+    // The WS2812 latches its color: it stays lit while the channel is lent out
+    ESP_ERROR_CHECK(led_strip_del(led_strip));
+    led_strip = NULL;
+}
+
+// ====== Rendering ======
+static void led_write(uint8_t red, uint8_t green, uint8_t blue)
+{
+    int32_t packed = (red << 16) | (green << 8) | blue;
+
+    // Skip the RMT transfer when the frame did not change (or there is no channel at all)
+    if (packed == led_last || led_client.slot < 0) {
+        led_pending = false;
+        return;
+    }
+    // Never wait: a transmitter holding the shared channel always wins
+    esp_err_t ret = rmt_mgr_acquire(&led_client, 0);
+    if (ret != ESP_OK) {
+        led_pending = ret == ESP_ERR_TIMEOUT;   // Otherwise the channel was taken for good
+        return;
+    }
+    if (packed == 0) {
+        led_strip_clear(led_strip);
+    } else {
+        led_strip_set_pixel(led_strip, 0, red, green, blue);
+        led_strip_refresh(led_strip);
+    }
+    rmt_mgr_release(&led_client);
+    led_last = packed;
+    led_pending = false;
+}
+
+/**
+ * @brief Render one frame of @p req at @p elapsed_ms
+ *
+ * @return true while the effect needs further frames
+ */
+static bool led_render(const led_request_t *req, uint32_t elapsed_ms)
+{
+    if (req->duration_ms != 0 && elapsed_ms >= req->duration_ms) {
+        led_write(0, 0, 0);
+        return false;
+    }
+
+    switch (req->effect) {
+    case LED_EFFECT_SOLID:
+        led_write(req->rgb[0], req->rgb[1], req->rgb[2]);
+        return req->duration_ms != 0;   // Only needs another frame to expire
+    case LED_EFFECT_BLINK:
+        if ((elapsed_ms / BLINK_HALF_PERIOD_MS) & 1) {
+            led_write(0, 0, 0);
+        } else {
+            led_write(req->rgb[0], req->rgb[1], req->rgb[2]);
+        }
+        return true;
+    case LED_EFFECT_BREATHE: {
+        uint32_t level = breathe_table[(elapsed_ms % BREATHE_PERIOD_MS) * 64 / BREATHE_PERIOD_MS];
+        led_write(req->rgb[0] * level / 255, req->rgb[1] * level / 255, req->rgb[2] * level / 255);
+        return true;
+    }
+    case LED_EFFECT_OFF:
+    default:
+        led_write(0, 0, 0);
+        return false;
+    }
+}
+
+static void led_task(void *pvParameters)
+{
+    led_request_t current = {.effect = LED_EFFECT_OFF};
+    TickType_t started = xTaskGetTickCount();
+    bool animating = false;
+
+    while (1) {
+        led_request_t req;
+        TickType_t wait = animating ? pdMS_TO_TICKS(LED_FRAME_MS) : portMAX_DELAY;
+
+        // The mailbox doubles as the frame clock: a new request preempts at once
+        if (xQueueReceive(led_mailbox, &req, wait) == pdTRUE) {
+            current = req;
+            started = xTaskGetTickCount();
+        }
+        animating = led_render(&current, pdTICKS_TO_MS(xTaskGetTickCount() - started));
+        animating |= led_pending;   // Keep ticking until the deferred frame goes out
+    }
+}
+
+// ====== LED Initialization ======
+void led_init(void)
+{
+    ESP_LOGI(TAG, "Initializing LED RGB on GPIO%d", LED_GPIO);
+
+    // Shareable: falls back to time-sharing a transmitter's channel when they run out
+    led_client = (rmt_mgr_client_t){
+        .name = "LED",
+        .open = led_channel_open,
+        .close = led_channel_close,
+    };
+    esp_err_t ret = rmt_mgr_register(&led_client, true);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "No RMT channel for the LED (%s), running dark", esp_err_to_name(ret));
+    }
+
+    led_mailbox = xQueueCreateStatic(1, sizeof(led_request_t), led_mailbox_storage, &led_mailbox_buf);
+    if (led_mailbox == NULL ||
+        xTaskCreateStatic(led_task, "LED", LED_TASK_STACK, NULL, LED_TASK_PRIORITY,
+                          led_task_stack, &led_task_buf) == NULL) {
+        ESP_LOGE(TAG, "Failed to start LED engine");
+        abort();
+    }
     ESP_LOGI(TAG, "LED RGB initialized successfully");
 }
 
 // ====== LED Control ======
+void led_play(led_effect_t effect, uint8_t red, uint8_t green, uint8_t blue, uint32_t duration_ms)
+{
+    led_request_t req = {
+        .effect = effect,
+        .rgb = {red, green, blue},
+        .duration_ms = duration_ms,
+    };
+    // One-slot mailbox: the newest request wins, callers never wait
+    xQueueOverwrite(led_mailbox, &req);
+}
+
 void led_set_color(uint32_t red, uint32_t green, uint32_t blue)
 {
-    ESP_ERROR_CHECK(led_strip_set_pixel(led_strip, 0, red, green, blue));
-    ESP_ERROR_CHECK(led_strip_refresh(led_strip));
+    led_play(LED_EFFECT_SOLID, red, green, blue, 0);
 }
 
 void led_off(void)
 {
-    ESP_ERROR_CHECK(led_strip_clear(led_strip));
+    led_play(LED_EFFECT_OFF, 0, 0, 0, 0);
 }
 
 // ====== Identify LED Effects ======
 void led_identify_blink(void)
 {
     ESP_LOGI(TAG, "Identify effect - Blink");
-    led_set_color(255, 255, 255); // Blanc
-    vTaskDelay(pdMS_TO_TICKS(100));
-    led_off();
-    vTaskDelay(pdMS_TO_TICKS(100));
-    led_set_color(255, 255, 255); // Blanc
-    vTaskDelay(pdMS_TO_TICKS(100));
-    led_off();
+    led_play(LED_EFFECT_BLINK, 255, 255, 255, 3 * BLINK_HALF_PERIOD_MS); // Blanc: on/off/on
 }
 
-void led_identify_breathe(void)
+void led_identify_breathe(uint32_t duration_ms)
 {
     ESP_LOGI(TAG, "Identify effect - Breathe");
-    for (int i = 0; i < 15; i++) {
-        led_set_color(128, 128, 255);
-        vTaskDelay(pdMS_TO_TICKS(100));
-        led_off();
-        vTaskDelay(pdMS_TO_TICKS(100));
-    }
+    led_play(LED_EFFECT_BREATHE, 128, 128, 255, duration_ms);
 }
 
 void led_identify_okay(void)
 {
     ESP_LOGI(TAG, "Identify effect - Okay");
-    led_set_color(0, 255, 0); // Vert
-    vTaskDelay(pdMS_TO_TICKS(1000));
-    led_off();
+    led_play(LED_EFFECT_SOLID, 0, 255, 0, 1000); // Vert
 }
@@ -7,15 +7,35 @@
 // ====== LED Configuration ======
 #define LED_GPIO 8
 #define LED_NUMBERS 1
+#define LED_FRAME_MS 20                // 50 Hz animation rate
+#define LED_TASK_STACK 2560
+#define LED_TASK_PRIORITY 2            // Cosmetic: below every functional task
+
+// ====== LED Effects ======
+typedef enum {
+    LED_EFFECT_OFF = 0,
+    LED_EFFECT_SOLID,       // Static color, optionally for duration_ms
+    LED_EFFECT_BLINK,       // 100 ms on / 100 ms off
+    LED_EFFECT_BREATHE,     // Gamma-corrected breathing, 2 s period
+} led_effect_t;
 
 // ====== Function Prototypes ======
 void led_init(void);
+
+/**
+ * @brief Post an effect to the LED engine (never blocks)
+ *
+ * The request preempts whatever effect is running. @p duration_ms = 0 keeps
+ * the effect until the next request; otherwise the LED turns off afterwards.
+ */
+void led_play(led_effect_t effect, uint8_t red, uint8_t green, uint8_t blue, uint32_t duration_ms);
+
 void led_set_color(uint32_t red, uint32_t green, uint32_t blue);
 void led_off(void);
 
 // ====== Identify LED Effects ======
 void led_identify_blink(void);
-void led_identify_breathe(void);
+void led_identify_breathe(uint32_t duration_ms);
 void led_identify_okay(void);
 
 #endif // LED_H
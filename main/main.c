@@ -9,16 +9,27 @@
 #include "led.h"
 #include "endpoints.h"
 #include "came433.h"
+#include "gates.h"
+#include "rf_tx.h"
+#include "diagnostics.h"
+#include "trace.h"
+#include "rf_learn.h"
+#include "codebook.h"
+#include "boot_timeline.h"
+#include "power.h"
 
 #define TAG "ZB433"
 
 void app_main(void)
 {
+    boot_mark(BOOT_MARK_APP_START);
     ESP_LOGI(TAG, "ZB433 Router starting...");
-    
+    trace_init();
+
     // Initialize LED
     led_init();
     led_set_color(255, 0, 0);
+    boot_mark(BOOT_MARK_LED_INIT);
 
     // Initialize NVS
     esp_err_t ret = nvs_flash_init();
@@ -27,20 +38,23 @@ void app_main(void)
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+    boot_mark(BOOT_MARK_NVS_INIT);
+    diagnostics_init();
+    power_init();
 
+    gates_init();
+    codebook_init();
+    boot_mark(BOOT_MARK_GATES_INIT);
     came433_init();
+    gates_bind_tx(came433_tx_count());
+    boot_mark(BOOT_MARK_CAME_INIT);
+    rf_tx_init(handle_rf_done);
+    boot_mark(BOOT_MARK_RF_TX_INIT);
+    rf_learn_init();
     zigbee_init();
-    
-    // Wait for Zigbee stack to be ready
-    vTaskDelay(pdMS_TO_TICKS(1000));
-
-    led_set_color(255, 64, 0);
 
-    // Commissioning is now handled automatically by the signal handler
-    ESP_LOGI(TAG, "Zigbee stack started - commissioning handled by signal handler");
+    // No fixed wait: the signal handler drives commissioning (and the LED) as the stack reports progress
+    ESP_LOGI(TAG, "Zigbee task started - commissioning handled by signal handler");
 
-    // Main loop - connection status is logged by signal handler
-    while (1) {
-        vTaskDelay(pdMS_TO_TICKS(5000));
-    }
+    // Nothing left to do here: returning deletes the main task instead of waking it every 5 s
 }
\ No newline at end of file
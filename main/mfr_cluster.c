@@ -0,0 +1,214 @@
+#include "mfr_cluster.h"
+#include "latency.h"
+#include "diagnostics.h"
+#include "trace.h"
+#include "rf_learn.h"
+#include "codebook.h"
+#include "endpoints.h"
+#include "gates.h"
+#include "boot_timeline.h"
+#include "zcl_defer.h"
+#include "esp_log.h"
+#include "esp_zigbee_core.h"
+
+static const char *TAG = "MFR_CLUSTER";
+
+// Octet string initial value: the stack sizes the attribute storage from the
+// length byte, so the template already has the full report length
+static uint8_t latency_template[1 + LATENCY_REPORT_SIZE] = {LATENCY_REPORT_SIZE, LATENCY_REPORT_VERSION};
+static uint32_t trace_levels_value = 0;
+static uint8_t boot_template[1 + BOOT_TIMELINE_REPORT_SIZE] = {BOOT_TIMELINE_REPORT_SIZE, BOOT_TIMELINE_REPORT_VERSION,
+                                                                 BOOT_MARK_COUNT};
+static uint16_t codebook_count_value = 0;
+static uint32_t codebook_gen_value = 0;
+static uint16_t press_counters[GATE_MAX];
+
+_Static_assert(1 + LATENCY_REPORT_SIZE <= ZCL_DEFER_VALUE_MAX, "latency report does not fit a deferred update");
+
+// ====== Private Functions ======
+static inline uint16_t mfr_get_u16(const uint8_t *p)
+{
+    return p[0] | (uint16_t)p[1] << 8;
+}
+
+static inline uint32_t mfr_get_u32(const uint8_t *p)
+{
+    return p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/**
+ * @brief Refresh the code book attributes after a commit (Zigbee task)
+ */
+static void mfr_cluster_publish_codebook(void)
+{
+    codebook_count_value = codebook_count();
+    codebook_gen_value = codebook_generation();
+    esp_zb_zcl_set_attribute_val(gates_endpoint(0), ZB433_MFR_CLUSTER_ID, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+                                 ZB433_MFR_ATTR_CODEBOOK_COUNT_ID, &codebook_count_value, false);
+    esp_zb_zcl_set_attribute_val(gates_endpoint(0), ZB433_MFR_CLUSTER_ID, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+                                 ZB433_MFR_ATTR_CODEBOOK_GEN_ID, &codebook_gen_value, false);
+}
+
+// ====== Public API ======
+void mfr_cluster_add(esp_zb_cluster_list_t *clusters, bool primary)
+{
+    esp_zb_attribute_list_t *attr_list = esp_zb_zcl_attr_list_create(ZB433_MFR_CLUSTER_ID);
+    esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_LATENCY_ID, ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING,
+                                          ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, latency_template);
+    if (primary) {
+        diagnostics_add_mfr_attrs(attr_list);
+        trace_levels_value = trace_get_levels();
+        esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_TRACE_LEVELS_ID, ESP_ZB_ZCL_ATTR_TYPE_U32,
+                                              ESP_ZB_ZCL_ATTR_ACCESS_READ_WRITE, &trace_levels_value);
+        codebook_count_value = codebook_count();
+        codebook_gen_value = codebook_generation();
+        esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_CODEBOOK_COUNT_ID, ESP_ZB_ZCL_ATTR_TYPE_U16,
+                                              ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &codebook_count_value);
+        esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_CODEBOOK_GEN_ID, ESP_ZB_ZCL_ATTR_TYPE_U32,
+                                              ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, &codebook_gen_value);
+        esp_zb_custom_cluster_add_custom_attr(attr_list, ZB433_MFR_ATTR_BOOT_TIMELINE_ID, ESP_ZB_ZCL_ATTR_TYPE_OCTET_STRING,
+                                              ESP_ZB_ZCL_ATTR_ACCESS_READ_ONLY, boot_template);
+    }
+    esp_zb_cluster_list_add_custom_cluster(clusters, attr_list, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE);
+}
+
+void mfr_cluster_publish_latency(uint8_t endpoint)
+{
+    uint8_t value[1 + LATENCY_REPORT_SIZE];
+
+    value[0] = latency_encode_report(endpoint, &value[1], LATENCY_REPORT_SIZE);
+    if (value[0] == 0) {
+        return;
+    }
+
+    // Back-to-back bursts coalesce: only the latest report reaches the stack
+    esp_err_t ret = zcl_defer_set(endpoint, ZB433_MFR_CLUSTER_ID, ZB433_MFR_ATTR_LATENCY_ID, value, 1 + value[0]);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "EP%d: latency attribute update not queued: %s", endpoint, esp_err_to_name(ret));
+    }
+}
+
+void mfr_cluster_publish_boot_timeline(void)
+{
+    uint8_t value[1 + BOOT_TIMELINE_REPORT_SIZE];
+
+    value[0] = boot_timeline_encode(&value[1], BOOT_TIMELINE_REPORT_SIZE);
+    esp_zb_zcl_set_attribute_val(gates_endpoint(0), ZB433_MFR_CLUSTER_ID, ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+                                 ZB433_MFR_ATTR_BOOT_TIMELINE_ID, value, false);
+}
+
+void mfr_cluster_send_press(uint8_t endpoint)
+{
+    int index = gates_index(endpoint);
+    if (index < 0 || index >= GATE_MAX) {
+        return;
+    }
+
+    // The counter lets the receiver spot a lost or replayed notification
+    uint16_t count = ++press_counters[index];
+    // Destinations come from the binding table: the converter binds the cluster of each gate endpoint
+    esp_zb_zcl_custom_cluster_cmd_req_t req = {
+        .zcl_basic_cmd = {
+            .src_endpoint = endpoint,
+        },
+        .address_mode = ESP_ZB_APS_ADDR_MODE_DST_ADDR_ENDP_NOT_PRESENT,
+        .profile_id = ESP_ZB_AF_HA_PROFILE_ID,
+        .cluster_id = ZB433_MFR_CLUSTER_ID,
+        .direction = ESP_ZB_ZCL_CMD_DIRECTION_TO_CLI,
+        .dis_defalut_resp = 1,      // APS ack only: a ZCL default response would double the traffic
+        .custom_cmd_id = ZB433_MFR_CMD_PRESS_ID,
+        .data = {
+            .type = ESP_ZB_ZCL_ATTR_TYPE_U16,
+            .size = sizeof(count),
+            .value = &count,
+        },
+    };
+    esp_zb_zcl_custom_cluster_cmd_req(&req);
+    TRACE2(PRESS_EVENT, endpoint, count);
+}
+
+void mfr_cluster_handle_write(uint8_t endpoint, uint16_t attr_id, const void *value)
+{
+    if (value == NULL) {
+        return;
+    }
+
+    switch (attr_id) {
+    case ZB433_MFR_ATTR_TRACE_LEVELS_ID:
+        trace_set_levels(*(const uint32_t *)value);
+        break;
+    default:
+        ESP_LOGD(TAG, "EP%d: write to read-only attribute 0x%04x ignored", endpoint, attr_id);
+        break;
+    }
+}
+
+esp_err_t mfr_cluster_handle_command(uint8_t endpoint, uint8_t command_id, const uint8_t *payload, uint16_t size,
+                                     int64_t arrival_us)
+{
+    esp_err_t ret;
+
+    if (payload == NULL) {
+        size = 0;
+    }
+
+    switch (command_id) {
+    case ZB433_MFR_CMD_LEARN_ID:
+        ret = rf_learn_start(endpoint, size >= 2 ? mfr_get_u16(payload) : 0,
+                             size >= 3 ? payload[2] : RF_LEARN_TX_KEEP);
+        break;
+    case ZB433_MFR_CMD_SEND_CODE_ID:
+        if (size < 2) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        ret = handle_code_click(endpoint, mfr_get_u16(payload), arrival_us);
+        break;
+    case ZB433_MFR_CMD_CODEBOOK_BEGIN_ID:
+        if (size < 2) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        ret = codebook_update_begin(mfr_get_u16(payload));
+        break;
+    case ZB433_MFR_CMD_CODEBOOK_WRITE_ID:
+        if (size < 2) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        ret = codebook_update_write(mfr_get_u16(payload), payload + 2, size - 2);
+        break;
+    case ZB433_MFR_CMD_CODEBOOK_COMMIT_ID:
+        if (size < 4) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        ret = codebook_update_commit(mfr_get_u32(payload));
+        if (ret == ESP_OK) {
+            mfr_cluster_publish_codebook();
+        }
+        break;
+    case ZB433_MFR_CMD_SEQUENCE_ID: {
+        endpoint_seq_step_t steps[OOK_SEQ_MAX_STEPS];
+        uint8_t count = size >= 1 ? payload[0] : 0;
+        if (count == 0 || count > OOK_SEQ_MAX_STEPS || size < 1 + count * ZB433_MFR_SEQ_STEP_SIZE) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        for (int i = 0; i < count; i++) {
+            const uint8_t *p = payload + 1 + i * ZB433_MFR_SEQ_STEP_SIZE;
+            steps[i] = (endpoint_seq_step_t){
+                .endpoint = p[0],
+                .code_index = mfr_get_u16(&p[1]),
+                .repeats = p[3],
+                .gap_ms = mfr_get_u16(&p[4]),
+            };
+        }
+        ret = handle_sequence_click(steps, count, arrival_us);
+        break;
+    }
+    default:
+        ESP_LOGD(TAG, "EP%d: unknown command 0x%02x ignored", endpoint, command_id);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "EP%d: command 0x%02x refused: %s", endpoint, command_id, esp_err_to_name(ret));
+    }
+    return ret;
+}
@@ -0,0 +1,90 @@
+#ifndef MFR_CLUSTER_H
+#define MFR_CLUSTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_zigbee_cluster.h"
+
+/*
+ZB433 manufacturer-specific cluster, present on every gate endpoint.
+Diagnostics that have no standard ZCL home, plus the learning and code
+book commands.
+*/
+
+// ====== Cluster Definition ======
+#define ZB433_MFR_CLUSTER_ID 0xFC00
+#define ZB433_MFR_ATTR_LATENCY_ID 0x0000   // Octet string, see latency.h report layout
+
+// Device health, first gate endpoint only (diagnostics.c), all reportable
+#define ZB433_MFR_ATTR_RF_SENT_ID 0x0010           // U32, bursts sent
+#define ZB433_MFR_ATTR_RF_DROPPED_ID 0x0011        // U32, bursts refused or failed
+#define ZB433_MFR_ATTR_RF_QUEUE_DEPTH_ID 0x0012    // U8, bursts waiting for airtime
+#define ZB433_MFR_ATTR_HEAP_FREE_ID 0x0013         // U32, bytes
+#define ZB433_MFR_ATTR_HEAP_MIN_FREE_ID 0x0014     // U32, bytes, lowest since boot
+#define ZB433_MFR_ATTR_ZB_STACK_FREE_ID 0x0015     // U32, Zigbee_main stack high-water mark (bytes left)
+#define ZB433_MFR_ATTR_PARENT_CHANGES_ID 0x0016    // U16
+#define ZB433_MFR_ATTR_ROUTE_CHANGES_ID 0x0017     // U16, next hop changed or route added
+#define ZB433_MFR_ATTR_NEIGHBORS_ID 0x0018         // U16, neighbor table entries in use
+#define ZB433_MFR_ATTR_CHILDREN_ID 0x0019          // U16, children among them
+#define ZB433_MFR_ATTR_ROUTES_ID 0x001A            // U16, routing table entries in use
+#define ZB433_MFR_ATTR_TABLE_FULL_ID 0x001B        // U16, times a stack table reached its capacity (ZB_CAP_STACK_*)
+#define ZB433_MFR_ATTR_ZB_HEAP_ID 0x001C           // U32, bytes taken by the stack pools (read only)
+#define ZB433_MFR_ATTR_LATE_ALLOCS_ID 0x001D       // U32, heap allocations after startup (CONFIG_ZB433_STATIC_ALLOC)
+
+// Runtime configuration, first gate endpoint only, writable
+#define ZB433_MFR_ATTR_TRACE_LEVELS_ID 0x0020      // U32, trace level per module, 4 bits each (trace.h)
+
+// Code book, first gate endpoint only, read-only (codebook.h)
+#define ZB433_MFR_ATTR_CODEBOOK_COUNT_ID 0x0021    // U16, entries in the active bank
+#define ZB433_MFR_ATTR_CODEBOOK_GEN_ID 0x0022      // U32, generation of the active bank
+
+// Startup, first gate endpoint only, read-only
+#define ZB433_MFR_ATTR_BOOT_TIMELINE_ID 0x0023     // Octet string, see boot_timeline.h report layout
+
+// Commands (client to server), any gate endpoint
+#define ZB433_MFR_CMD_LEARN_ID 0x00                // Payload: optional U16 timeout (s), optional U8 transmitter, see rf_learn.h
+#define ZB433_MFR_CMD_SEND_CODE_ID 0x01            // U16 code book index, sent with this gate's settings
+#define ZB433_MFR_CMD_CODEBOOK_BEGIN_ID 0x02       // U16 entry count
+#define ZB433_MFR_CMD_CODEBOOK_WRITE_ID 0x03       // U16 first index + packed codebook_entry_t
+#define ZB433_MFR_CMD_CODEBOOK_COMMIT_ID 0x04      // U32 CRC-32 of all entries
+#define ZB433_MFR_CMD_SEQUENCE_ID 0x05             // U8 step count + packed steps, see below
+
+// Sequence step: U8 endpoint, U16 code book index (0xFFFF = gate code), U8 repeats (0 = gate), U16 gap (ms)
+#define ZB433_MFR_SEQ_STEP_SIZE 6
+
+// Notifications (server to client), from the pressed gate endpoint to its ZB433 cluster bindings
+#define ZB433_MFR_CMD_PRESS_ID 0x00                // U16 press counter of this endpoint (wraps)
+
+// ====== Function Prototypes ======
+/**
+ * @brief Add the ZB433 cluster; @p primary also carries the device health attributes
+ */
+void mfr_cluster_add(esp_zb_cluster_list_t *clusters, bool primary);
+
+/**
+ * @brief Refresh the latency attribute of @p endpoint (any task, applied by the Zigbee task via zcl_defer)
+ */
+void mfr_cluster_publish_latency(uint8_t endpoint);
+
+/**
+ * @brief Refresh the boot timeline attribute (Zigbee task)
+ */
+void mfr_cluster_publish_boot_timeline(void);
+
+/**
+ * @brief Notify the bound clients that @p endpoint was pressed: one frame, no state to reset (Zigbee task)
+ */
+void mfr_cluster_send_press(uint8_t endpoint);
+
+/**
+ * @brief Apply a write to a ZB433 cluster attribute (Zigbee task, SET_ATTR_VALUE callback)
+ */
+void mfr_cluster_handle_write(uint8_t endpoint, uint16_t attr_id, const void *value);
+
+/**
+ * @brief Execute a ZB433 cluster command (Zigbee task, custom cluster request callback)
+ */
+esp_err_t mfr_cluster_handle_command(uint8_t endpoint, uint8_t command_id, const uint8_t *payload, uint16_t size,
+                                     int64_t arrival_us);
+
+#endif // MFR_CLUSTER_H
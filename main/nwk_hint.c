@@ -0,0 +1,100 @@
+#include "nwk_hint.h"
+#include "esp_log.h"
+#include "esp_zigbee_core.h"
+#include "nvs.h"
+#include <string.h>
+
+static const char *TAG = "NWK_HINT";
+
+#define NWK_HINT_CHANNEL_MIN 11
+#define NWK_HINT_CHANNEL_MAX 26
+
+static nwk_hint_t cached_hint;
+static bool cached_valid = false;
+
+// ====== Private Functions ======
+static bool nwk_hint_load(nwk_hint_t *hint)
+{
+    nvs_handle_t handle;
+    if (nvs_open(NWK_HINT_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+
+    size_t size = sizeof(*hint);
+    esp_err_t ret = nvs_get_blob(handle, NWK_HINT_NVS_KEY, hint, &size);
+    nvs_close(handle);
+
+    return ret == ESP_OK && size == sizeof(*hint) && hint->version == NWK_HINT_VERSION &&
+           hint->channel >= NWK_HINT_CHANNEL_MIN && hint->channel <= NWK_HINT_CHANNEL_MAX;
+}
+
+static esp_err_t nwk_hint_save(const nwk_hint_t *hint)
+{
+    nvs_handle_t handle;
+    esp_err_t ret = nvs_open(NWK_HINT_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_set_blob(handle, NWK_HINT_NVS_KEY, hint, sizeof(*hint));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return ret;
+}
+
+static uint16_t nwk_hint_parent(void)
+{
+    esp_zb_nwk_info_iterator_t it = ESP_ZB_NWK_INFO_ITERATOR_INIT;
+    esp_zb_nwk_neighbor_info_t neighbor;
+
+    while (esp_zb_nwk_get_next_neighbor(&it, &neighbor) == ESP_OK) {
+        if (neighbor.relationship == ESP_ZB_NWK_RELATIONSHIP_PARENT) {
+            return neighbor.short_addr;
+        }
+    }
+    return 0xFFFF;
+}
+
+// ====== Public API ======
+void nwk_hint_apply(void)
+{
+    cached_valid = nwk_hint_load(&cached_hint);
+    if (!cached_valid) {
+        ESP_LOGI(TAG, "No cached network, scanning all channels");
+        esp_zb_set_primary_network_channel_set(ESP_ZB_TRANSCEIVER_ALL_CHANNELS_MASK);
+        return;
+    }
+
+    ESP_LOGI(TAG, "Cached network: channel %d, PAN 0x%04hx, parent 0x%04hx",
+             cached_hint.channel, cached_hint.pan_id, cached_hint.parent);
+    esp_zb_set_primary_network_channel_set(1UL << cached_hint.channel);
+    esp_zb_set_secondary_network_channel_set(ESP_ZB_TRANSCEIVER_ALL_CHANNELS_MASK);
+}
+
+void nwk_hint_update(void)
+{
+    nwk_hint_t hint = {
+        .version = NWK_HINT_VERSION,
+        .channel = esp_zb_get_current_channel(),
+        .pan_id = esp_zb_get_pan_id(),
+        .parent = nwk_hint_parent(),
+    };
+    esp_zb_get_extended_pan_id(hint.ext_pan_id);
+
+    if (cached_valid && memcmp(&hint, &cached_hint, sizeof(hint)) == 0) {
+        return;     // Unchanged: no flash write
+    }
+    if (cached_valid && hint.parent != cached_hint.parent) {
+        ESP_LOGI(TAG, "Parent changed since last join: 0x%04hx -> 0x%04hx", cached_hint.parent, hint.parent);
+    }
+
+    esp_err_t ret = nwk_hint_save(&hint);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to cache network: %s", esp_err_to_name(ret));
+        return;
+    }
+    cached_hint = hint;
+    cached_valid = true;
+    ESP_LOGI(TAG, "Network cached: channel %d, PAN 0x%04hx", hint.channel, hint.pan_id);
+}
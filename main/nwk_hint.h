@@ -0,0 +1,40 @@
+#ifndef NWK_HINT_H
+#define NWK_HINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+Last good network, cached in NVS: channel, PAN ID, extended PAN ID and
+parent. Steering scans the cached channel first (BDB primary channel set)
+and only widens to every channel (secondary set) if nothing answers there.
+*/
+
+// ====== Hint Configuration ======
+#define NWK_HINT_NVS_NAMESPACE "zb433"
+#define NWK_HINT_NVS_KEY "nwk_hint"
+#define NWK_HINT_VERSION 1
+
+/**
+ * @brief Persisted network hint (NVS blob layout, keep packed)
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t version;
+    uint8_t channel;            // 11..26
+    uint16_t pan_id;
+    uint8_t ext_pan_id[8];
+    uint16_t parent;            // Short address, 0xFFFF = unknown
+} nwk_hint_t;
+
+// ====== Function Prototypes ======
+/**
+ * @brief Set the BDB channel masks from the cached hint (Zigbee task, before esp_zb_start)
+ */
+void nwk_hint_apply(void);
+
+/**
+ * @brief Cache the current network and parent if they changed (Zigbee task, once joined)
+ */
+void nwk_hint_update(void);
+
+#endif // NWK_HINT_H
@@ -0,0 +1,182 @@
+#include "ook_decoder.h"
+#include <string.h>
+
+typedef enum {
+    OOK_PAIR_NONE = 0,
+    OOK_PAIR_SYNC,
+    OOK_PAIR_BIT0,
+    OOK_PAIR_BIT1,
+} ook_pair_kind_t;
+
+// ====== Private Functions ======
+
+static uint32_t ook_deviation(uint32_t measured_us, uint32_t expected_us)
+{
+    return measured_us > expected_us ? measured_us - expected_us : expected_us - measured_us;
+}
+
+/**
+ * @brief Deviation of a measured pair from a table pair, UINT32_MAX if out of tolerance
+ */
+static uint32_t ook_pair_error(const ook_pair_t *pair, uint16_t te_us, uint32_t d0, uint32_t d1)
+{
+    uint32_t e0 = (uint32_t)pair->units0 * te_us;
+    uint32_t e1 = (uint32_t)pair->units1 * te_us;
+    uint32_t dev0 = ook_deviation(d0, e0);
+    uint32_t dev1 = ook_deviation(d1, e1);
+
+    if (dev0 * 100 > e0 * OOK_DECODER_TOLERANCE_PCT || dev1 * 100 > e1 * OOK_DECODER_TOLERANCE_PCT) {
+        return UINT32_MAX;
+    }
+    return dev0 + dev1;
+}
+
+static ook_pair_kind_t ook_classify(const ook_protocol_t *proto, uint32_t d0, uint32_t d1)
+{
+    uint32_t err_sync = ook_pair_error(&proto->sync, proto->te_us, d0, d1);
+    uint32_t err_bit0 = ook_pair_error(&proto->bit0, proto->te_us, d0, d1);
+    uint32_t err_bit1 = ook_pair_error(&proto->bit1, proto->te_us, d0, d1);
+
+    if (err_sync != UINT32_MAX && err_sync <= err_bit0 && err_sync <= err_bit1) {
+        return OOK_PAIR_SYNC;
+    }
+    if (err_bit0 == UINT32_MAX && err_bit1 == UINT32_MAX) {
+        return OOK_PAIR_NONE;
+    }
+    return err_bit0 <= err_bit1 ? OOK_PAIR_BIT0 : OOK_PAIR_BIT1;
+}
+
+static void ook_track_restart(ook_decoder_track_t *track, bool synced)
+{
+    track->code = 0;
+    track->sum_us = 0;
+    track->sum_units = 0;
+    track->bit_count = 0;
+    track->synced = synced;
+}
+
+static bool ook_track_complete(const ook_decoder_track_t *track, ook_protocol_id_t id, ook_decoded_t *out)
+{
+    const ook_protocol_t *proto = &ook_protocols[id];
+
+    if (!track->synced || track->bit_count != proto->bits || track->sum_units == 0) {
+        return false;
+    }
+    out->protocol = id;
+    out->code = track->code;
+    out->te_us = track->sum_us / track->sum_units;
+    return true;
+}
+
+/**
+ * @brief Advance one protocol track by a complete pair
+ */
+static bool ook_track_pair(ook_decoder_track_t *track, ook_protocol_id_t id,
+                           uint32_t d0, uint32_t d1, ook_decoded_t *out)
+{
+    const ook_protocol_t *proto = &ook_protocols[id];
+    bool done = false;
+
+    ook_pair_kind_t kind = ook_classify(proto, d0, d1);
+
+    switch (kind) {
+    case OOK_PAIR_SYNC:
+        // A sync closes the frame before it (trailing-sync protocols, or repeats of
+        // sync-first ones) and opens the next one
+        done = ook_track_complete(track, id, out);
+        ook_track_restart(track, true);
+        break;
+    case OOK_PAIR_BIT0:
+    case OOK_PAIR_BIT1: {
+        if (!track->synced) {
+            break;
+        }
+        const ook_pair_t *pair = kind == OOK_PAIR_BIT1 ? &proto->bit1 : &proto->bit0;
+        if (track->bit_count >= proto->bits) {
+            ook_track_restart(track, false);    // Longer than this protocol: not ours
+            break;
+        }
+        track->code = (track->code << 1) | (kind == OOK_PAIR_BIT1);
+        track->sum_us += d0 + d1;
+        track->sum_units += pair->units0 + pair->units1;
+        track->bit_count++;
+        break;
+    }
+    default:
+        ook_track_restart(track, false);
+        break;
+    }
+    return done;
+}
+
+/**
+ * @brief Relative te deviation in per mille, to pick between protocols sharing a shape
+ */
+static uint32_t ook_te_deviation(const ook_decoded_t *decoded)
+{
+    uint16_t nominal = ook_protocols[decoded->protocol].te_us;
+    return ook_deviation(decoded->te_us, nominal) * 1000 / nominal;
+}
+
+/**
+ * @brief Keep the candidate closest to its protocol's nominal timing (EV1527 vs PT2262)
+ */
+static bool ook_keep_best(bool found, ook_decoded_t *best, const ook_decoded_t *candidate)
+{
+    if (!found || ook_te_deviation(candidate) < ook_te_deviation(best)) {
+        *best = *candidate;
+    }
+    return true;
+}
+
+// ====== Public API ======
+void ook_decoder_reset(ook_decoder_t *dec)
+{
+    memset(dec, 0, sizeof(*dec));
+}
+
+bool ook_decoder_feed(ook_decoder_t *dec, uint8_t level, uint32_t duration_us, ook_decoded_t *out)
+{
+    bool found = false;
+
+    if (duration_us == 0) {
+        return false;
+    }
+    if (duration_us > UINT16_MAX) {
+        duration_us = UINT16_MAX;
+    }
+
+    for (int id = 0; id < OOK_PROTO_COUNT; id++) {
+        ook_decoder_track_t *track = &dec->tracks[id];
+        // Pairs of this protocol always start with the same level as its bits
+        uint8_t first_level = ook_protocols[id].bit0.level0;
+
+        if (level == first_level) {
+            track->first_us = duration_us;
+            track->have_first = 1;
+        } else if (track->have_first) {
+            track->have_first = 0;
+            ook_decoded_t decoded;
+            if (ook_track_pair(track, (ook_protocol_id_t)id, track->first_us, duration_us, &decoded)) {
+                found = ook_keep_best(found, out, &decoded);
+            }
+        }
+    }
+    return found;
+}
+
+bool ook_decoder_flush(ook_decoder_t *dec, ook_decoded_t *out)
+{
+    bool found = false;
+
+    for (int id = 0; id < OOK_PROTO_COUNT; id++) {
+        ook_decoder_track_t *track = &dec->tracks[id];
+        ook_decoded_t decoded;
+        if (ook_track_complete(track, (ook_protocol_id_t)id, &decoded)) {
+            found = ook_keep_best(found, out, &decoded);
+        }
+        track->have_first = 0;
+        ook_track_restart(track, false);
+    }
+    return found;
+}
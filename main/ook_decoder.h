@@ -0,0 +1,57 @@
+#ifndef OOK_DECODER_H
+#define OOK_DECODER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ook_protocol.h"
+
+/*
+Streaming OOK decoder: the inverse of ook_encoder, driven by the same
+protocol table. Edges are fed one level/duration at a time, in any chunking;
+every protocol is tracked in parallel in a fixed-size state, so memory does
+not depend on the capture length. A frame is reported when exactly `bits`
+bit pairs sit between two sync pairs (or between a sync and the end of the
+signal); if several protocols match, the one whose measured te is closest to
+its nominal te wins. Trailing-sync protocols need one repeat to lock on.
+Pure C, no ESP-IDF dependency.
+*/
+
+// ====== Decoder Configuration ======
+#define OOK_DECODER_TOLERANCE_PCT 35   // Accepted deviation from the table duration
+
+typedef struct {
+    uint32_t code;
+    uint32_t sum_us;        // Measured durations of the frame, for te estimation
+    uint16_t sum_units;
+    uint16_t first_us;      // First half of the pair being assembled
+    uint8_t bit_count;
+    uint8_t synced;         // A sync pair has been seen
+    uint8_t have_first;
+} ook_decoder_track_t;
+
+typedef struct {
+    ook_decoder_track_t tracks[OOK_PROTO_COUNT];
+} ook_decoder_t;
+
+typedef struct {
+    ook_protocol_id_t protocol;
+    uint32_t code;
+    uint16_t te_us;         // Measured time unit
+} ook_decoded_t;
+
+// ====== Function Prototypes ======
+void ook_decoder_reset(ook_decoder_t *dec);
+
+/**
+ * @brief Feed one level with its duration
+ *
+ * @return true if a frame completed, written to @p out
+ */
+bool ook_decoder_feed(ook_decoder_t *dec, uint8_t level, uint32_t duration_us, ook_decoded_t *out);
+
+/**
+ * @brief End of signal (idle line): report a frame that was waiting for its next sync
+ */
+bool ook_decoder_flush(ook_decoder_t *dec, ook_decoded_t *out);
+
+#endif // OOK_DECODER_H
@@ -0,0 +1,251 @@
+#include "ook_encoder.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_attr.h"
+#include <stdlib.h>
+
+static const char *TAG = "OOK_ENC";
+
+#define OOK_MAX_DURATION 0x7FFF        // 15-bit RMT duration field
+#define OOK_GAP_CHUNK_MS 50            // Idle LOW per gap symbol (two 25 ms halves)
+
+typedef enum {
+    OOK_ENC_START = 0,
+    OOK_ENC_SYNC_HEAD,
+    OOK_ENC_BITS,
+    OOK_ENC_SYNC_TAIL,
+} ook_enc_state_t;
+
+enum {
+    OOK_SYM_SYNC = 0,
+    OOK_SYM_BIT0,
+    OOK_SYM_BIT1,
+    OOK_SYM_COUNT
+};
+
+typedef struct {
+    rmt_encoder_t base;
+    rmt_encoder_t *copy_encoder;    // Writes our symbols into the RMT memory block
+    ook_enc_state_t state;
+    uint8_t bits_left;
+    rmt_symbol_word_t symbols[OOK_SYM_COUNT]; // Resolved for the frame being sent
+    // Sequence payloads only
+    bool seq_started;
+    uint8_t step;
+    uint8_t repeats_left;
+    uint16_t gap_left_ms;       // Non-zero while the idle gap after a step is being written
+} ook_encoder_t;
+
+// ====== Private Functions ======
+/*
+Everything reachable from encode()/reset() is IRAM_ATTR: with
+CONFIG_RMT_ISR_IRAM_SAFE the driver refills the memory block from its ISR
+even while the flash cache is disabled (OTA writes, NVS commits).
+*/
+
+static IRAM_ATTR rmt_symbol_word_t ook_pair_to_symbol(const ook_pair_t *pair, uint16_t te_us)
+{
+    uint32_t d0 = (uint32_t)pair->units0 * te_us;
+    uint32_t d1 = (uint32_t)pair->units1 * te_us;
+
+    rmt_symbol_word_t symbol = {
+        .level0 = pair->level0 ? 1 : 0,
+        .duration0 = d0 > OOK_MAX_DURATION ? OOK_MAX_DURATION : d0,
+        .level1 = pair->level0 ? 0 : 1,
+        .duration1 = d1 > OOK_MAX_DURATION ? OOK_MAX_DURATION : d1,
+    };
+    return symbol;
+}
+
+/**
+ * @brief Resolve the three symbols of a frame once, so refills are table lookups
+ */
+static IRAM_ATTR void ook_prepare(ook_encoder_t *ook, const ook_frame_t *frame)
+{
+    const ook_protocol_t *proto = frame->proto;
+    uint16_t te_us = ook_frame_te(frame);
+
+    ook->symbols[OOK_SYM_SYNC] = ook_pair_to_symbol(&proto->sync, te_us);
+    ook->symbols[OOK_SYM_BIT0] = ook_pair_to_symbol(&proto->bit0, te_us);
+    ook->symbols[OOK_SYM_BIT1] = ook_pair_to_symbol(&proto->bit1, te_us);
+    ook->bits_left = proto->bits;
+    ook->state = proto->sync_first ? OOK_ENC_SYNC_HEAD : OOK_ENC_BITS;
+}
+
+/**
+ * @brief Encode the rest of one frame, reports COMPLETE once its last symbol is written
+ */
+static IRAM_ATTR size_t ook_encode_frame(ook_encoder_t *ook, rmt_channel_handle_t channel,
+                                         const ook_frame_t *frame, rmt_encode_state_t *ret_state)
+{
+    rmt_encoder_handle_t copy_encoder = ook->copy_encoder;
+    rmt_encode_state_t session_state = RMT_ENCODING_RESET;
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+    size_t encoded_symbols = 0;
+
+    if (ook->state == OOK_ENC_START) {
+        ook_prepare(ook, frame);
+    }
+
+    // One symbol per iteration; stops as soon as the RMT memory block is full
+    while (ook->state != OOK_ENC_START) {
+        const rmt_symbol_word_t *symbol;
+        if (ook->state == OOK_ENC_BITS) {
+            bool bit = (frame->code >> (ook->bits_left - 1)) & 1;
+            symbol = &ook->symbols[bit ? OOK_SYM_BIT1 : OOK_SYM_BIT0];
+        } else {
+            symbol = &ook->symbols[OOK_SYM_SYNC];
+        }
+
+        encoded_symbols += copy_encoder->encode(copy_encoder, channel, symbol, sizeof(*symbol), &session_state);
+
+        if (session_state & RMT_ENCODING_COMPLETE) {
+            switch (ook->state) {
+            case OOK_ENC_SYNC_HEAD:
+                ook->state = OOK_ENC_BITS;
+                break;
+            case OOK_ENC_BITS:
+                if (--ook->bits_left == 0) {
+                    ook->state = frame->proto->sync_first ? OOK_ENC_START : OOK_ENC_SYNC_TAIL;
+                }
+                break;
+            default:
+                ook->state = OOK_ENC_START;
+                break;
+            }
+            if (ook->state == OOK_ENC_START) {
+                state |= RMT_ENCODING_COMPLETE;
+            }
+        }
+        if (session_state & RMT_ENCODING_MEM_FULL) {
+            state |= RMT_ENCODING_MEM_FULL;
+            break;
+        }
+    }
+
+    *ret_state = state;
+    return encoded_symbols;
+}
+
+/**
+ * @brief Next step of a sequence, with its repeat count and the gap that follows it
+ */
+static IRAM_ATTR void ook_seq_step_begin(ook_encoder_t *ook, const ook_sequence_t *seq)
+{
+    const ook_seq_step_t *step = &seq->steps[ook->step];
+
+    ook->repeats_left = step->repeats ? step->repeats : 1;
+    ook->gap_left_ms = 0;
+}
+
+static IRAM_ATTR size_t ook_encode_sequence(ook_encoder_t *ook, rmt_channel_handle_t channel,
+                                            const ook_sequence_t *seq, rmt_encode_state_t *ret_state)
+{
+    rmt_encoder_handle_t copy_encoder = ook->copy_encoder;
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+    size_t encoded_symbols = 0;
+
+    if (!ook->seq_started) {
+        ook->seq_started = true;
+        ook->step = 0;
+        ook_seq_step_begin(ook, seq);
+    }
+
+    while (ook->step < seq->count) {
+        const ook_seq_step_t *step = &seq->steps[ook->step];
+        rmt_encode_state_t session_state = RMT_ENCODING_RESET;
+
+        if (ook->gap_left_ms == 0) {
+            encoded_symbols += ook_encode_frame(ook, channel, &step->frame, &session_state);
+            if ((session_state & RMT_ENCODING_COMPLETE) && --ook->repeats_left == 0) {
+                // The last step needs no trailing gap: the end marker idles the pin
+                ook->gap_left_ms = (ook->step + 1 < seq->count) ? step->gap_ms : 0;
+                if (ook->gap_left_ms == 0 && ++ook->step < seq->count) {
+                    ook_seq_step_begin(ook, seq);
+                }
+            }
+        } else {
+            // Idle LOW in 50 ms symbols: both halves non-zero, a zero duration would end the transaction
+            uint16_t chunk_ms = ook->gap_left_ms < OOK_GAP_CHUNK_MS ? ook->gap_left_ms : OOK_GAP_CHUNK_MS;
+            uint32_t chunk_us = (uint32_t)chunk_ms * 1000;
+            rmt_symbol_word_t gap = {
+                .level0 = 0,
+                .duration0 = chunk_us / 2,
+                .level1 = 0,
+                .duration1 = chunk_us - chunk_us / 2,
+            };
+            encoded_symbols += copy_encoder->encode(copy_encoder, channel, &gap, sizeof(gap), &session_state);
+            if (session_state & RMT_ENCODING_COMPLETE) {
+                ook->gap_left_ms -= chunk_ms;
+                if (ook->gap_left_ms == 0 && ++ook->step < seq->count) {
+                    ook_seq_step_begin(ook, seq);
+                }
+            }
+        }
+
+        if (session_state & RMT_ENCODING_MEM_FULL) {
+            state |= RMT_ENCODING_MEM_FULL;
+            break;
+        }
+    }
+
+    if (ook->step >= seq->count) {
+        ook->seq_started = false;
+        state |= RMT_ENCODING_COMPLETE;
+    }
+    *ret_state = state;
+    return encoded_symbols;
+}
+
+static IRAM_ATTR size_t ook_encode(rmt_encoder_t *encoder, rmt_channel_handle_t channel,
+                                   const void *primary_data, size_t data_size, rmt_encode_state_t *ret_state)
+{
+    ook_encoder_t *ook = __containerof(encoder, ook_encoder_t, base);
+
+    if (data_size == sizeof(ook_sequence_t)) {
+        return ook_encode_sequence(ook, channel, (const ook_sequence_t *)primary_data, ret_state);
+    }
+    return ook_encode_frame(ook, channel, (const ook_frame_t *)primary_data, ret_state);
+}
+
+static IRAM_ATTR esp_err_t ook_reset(rmt_encoder_t *encoder)
+{
+    ook_encoder_t *ook = __containerof(encoder, ook_encoder_t, base);
+    rmt_encoder_reset(ook->copy_encoder);
+    ook->state = OOK_ENC_START;
+    ook->seq_started = false;
+    return ESP_OK;
+}
+
+static esp_err_t ook_del(rmt_encoder_t *encoder)
+{
+    ook_encoder_t *ook = __containerof(encoder, ook_encoder_t, base);
+    rmt_del_encoder(ook->copy_encoder);
+    free(ook);
+    return ESP_OK;
+}
+
+// ====== Public API ======
+esp_err_t ook_encoder_new(rmt_encoder_handle_t *ret_encoder)
+{
+    ESP_RETURN_ON_FALSE(ret_encoder, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    ook_encoder_t *ook = calloc(1, sizeof(ook_encoder_t));
+    ESP_RETURN_ON_FALSE(ook, ESP_ERR_NO_MEM, TAG, "no mem for OOK encoder");
+
+    ook->base.encode = ook_encode;
+    ook->base.reset = ook_reset;
+    ook->base.del = ook_del;
+    ook->state = OOK_ENC_START;
+
+    rmt_copy_encoder_config_t copy_encoder_config = {};
+    esp_err_t ret = rmt_new_copy_encoder(&copy_encoder_config, &ook->copy_encoder);
+    if (ret != ESP_OK) {
+        free(ook);
+        ESP_LOGE(TAG, "Failed to create copy encoder: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    *ret_encoder = &ook->base;
+    return ESP_OK;
+}
@@ -0,0 +1,22 @@
+#ifndef OOK_ENCODER_H
+#define OOK_ENCODER_H
+
+#include "esp_err.h"
+#include "driver/rmt_encoder.h"
+#include "ook_protocol.h"
+
+/**
+ * @brief Create a streaming RMT encoder for ook_frame_t payloads
+ *
+ * Pass a single ook_frame_t as rmt_transmit() payload (size sizeof(ook_frame_t)).
+ * Symbols are computed from the protocol table and written straight into the
+ * RMT memory block on each refill; nothing is allocated per transmission.
+ * The channel resolution must be 1 MHz (durations are in µs).
+ *
+ * An ook_sequence_t payload (size sizeof(ook_sequence_t)) is also accepted:
+ * every step's frame is encoded repeats times, followed by gap_ms of idle
+ * LOW, all in one transaction. Use it without loop_count.
+ */
+esp_err_t ook_encoder_new(rmt_encoder_handle_t *ret_encoder);
+
+#endif // OOK_ENCODER_H
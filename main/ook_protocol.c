@@ -0,0 +1,76 @@
+#include "ook_protocol.h"
+#include "came_timings.h"
+#include <stddef.h>
+
+// CAME timings are kept as the tested µs values in came_timings.h, expressed here in te units
+#define CAME_TE CAME_SHORT_PULSE
+
+// ====== Protocol Table ======
+// CAME (as implemented by Flipper Zero): 24320 µs LOW header + 320 µs start bit,
+// bit 0 = 320 µs LOW + 640 µs HIGH, bit 1 = 640 µs LOW + 320 µs HIGH
+// In DRAM: the encoder reads it from the RMT ISR, which keeps running while flash is being written (OTA)
+const ook_protocol_t ook_protocols[OOK_PROTO_COUNT] DRAM_ATTR = {
+    [OOK_PROTO_CAME_12] = {
+        .name = "CAME-12", .te_us = CAME_TE, .bits = 12, .sync_first = true,
+        .sync = {0, CAME_HEADER_DURATION / CAME_TE, CAME_START_BIT_DURATION / CAME_TE},
+        .bit0 = {0, CAME_SHORT_GAP / CAME_TE, CAME_LONG_PULSE / CAME_TE},
+        .bit1 = {0, CAME_LONG_GAP / CAME_TE, CAME_SHORT_PULSE / CAME_TE},
+    },
+    [OOK_PROTO_CAME_24] = {
+        .name = "CAME-24", .te_us = CAME_TE, .bits = 24, .sync_first = true,
+        .sync = {0, CAME_HEADER_DURATION / CAME_TE, CAME_START_BIT_DURATION / CAME_TE},
+        .bit0 = {0, CAME_SHORT_GAP / CAME_TE, CAME_LONG_PULSE / CAME_TE},
+        .bit1 = {0, CAME_LONG_GAP / CAME_TE, CAME_SHORT_PULSE / CAME_TE},
+    },
+    // Nice FLO: same shape as CAME with a 700 µs unit and a 36 te header
+    [OOK_PROTO_NICE_FLO_12] = {
+        .name = "Nice FLO-12", .te_us = 700, .bits = 12, .sync_first = true,
+        .sync = {0, 36, 1}, .bit0 = {0, 1, 2}, .bit1 = {0, 2, 1},
+    },
+    [OOK_PROTO_NICE_FLO_24] = {
+        .name = "Nice FLO-24", .te_us = 700, .bits = 24, .sync_first = true,
+        .sync = {0, 36, 1}, .bit0 = {0, 1, 2}, .bit1 = {0, 2, 1},
+    },
+    // PT2262 family: high-first bits, 1:31 sync closing the frame
+    [OOK_PROTO_PT2262] = {
+        .name = "PT2262", .te_us = 350, .bits = 24, .sync_first = false,
+        .sync = {1, 1, 31}, .bit0 = {1, 1, 3}, .bit1 = {1, 3, 1},
+    },
+    [OOK_PROTO_EV1527] = {
+        .name = "EV1527", .te_us = 300, .bits = 24, .sync_first = true,
+        .sync = {1, 1, 31}, .bit0 = {1, 1, 3}, .bit1 = {1, 3, 1},
+    },
+    [OOK_PROTO_PRINCETON] = {
+        .name = "Princeton", .te_us = 390, .bits = 24, .sync_first = false,
+        .sync = {1, 1, 30}, .bit0 = {1, 1, 3}, .bit1 = {1, 3, 1},
+    },
+};
+
+// ====== Public API ======
+const ook_protocol_t *ook_protocol_get(ook_protocol_id_t id)
+{
+    return (id < OOK_PROTO_COUNT) ? &ook_protocols[id] : NULL;
+}
+
+uint32_t ook_frame_duration_us(const ook_frame_t *frame)
+{
+    const ook_protocol_t *proto = frame->proto;
+    uint32_t units = proto->sync.units0 + proto->sync.units1;
+
+    // Every bit pair has the same total length for these protocols, but do not rely on it
+    for (int bit = proto->bits - 1; bit >= 0; bit--) {
+        const ook_pair_t *pair = ((frame->code >> bit) & 1) ? &proto->bit1 : &proto->bit0;
+        units += pair->units0 + pair->units1;
+    }
+    return units * ook_frame_te(frame);
+}
+
+uint32_t ook_sequence_airtime_us(const ook_sequence_t *seq)
+{
+    uint32_t airtime = 0;
+
+    for (int i = 0; i < seq->count; i++) {
+        airtime += ook_frame_duration_us(&seq->steps[i].frame) * seq->steps[i].repeats;
+    }
+    return airtime;
+}
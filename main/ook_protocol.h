@@ -0,0 +1,95 @@
+#ifndef OOK_PROTOCOL_H
+#define OOK_PROTOCOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_attr.h"
+
+/*
+OOK remote protocols as timing tables. Every protocol is a sync pair plus a
+pair for bit 0 and bit 1, each pair being one level followed by the opposite
+level. Durations are expressed in multiples of the protocol time unit (te) so
+a per-gate te override rescales the whole frame consistently.
+This header is pure C: no ESP-IDF dependency.
+*/
+
+// ====== Protocol Identifiers ======
+typedef enum {
+    OOK_PROTO_CAME_12 = 0,
+    OOK_PROTO_CAME_24,
+    OOK_PROTO_NICE_FLO_12,
+    OOK_PROTO_NICE_FLO_24,
+    OOK_PROTO_PT2262,       // 12 tri-state trits packed 2 bits each (0=00, 1=11, F=01)
+    OOK_PROTO_EV1527,       // 20-bit address + 4 data bits, learning-code remotes
+    OOK_PROTO_PRINCETON,    // PT2262 clones with the slower 390 µs clock
+    OOK_PROTO_COUNT
+} ook_protocol_id_t;
+
+/**
+ * @brief One level followed by its opposite, durations in te units
+ */
+typedef struct {
+    uint8_t level0;     // First level (1 = carrier on)
+    uint8_t units0;
+    uint8_t units1;     // Second level is !level0
+} ook_pair_t;
+
+typedef struct {
+    const char *name;
+    uint16_t te_us;     // Nominal time unit (µs)
+    uint8_t bits;       // Code length, sent MSB first
+    bool sync_first;    // Sync before the bits (CAME, Nice) or after them (PT2262)
+    ook_pair_t sync;
+    ook_pair_t bit0;
+    ook_pair_t bit1;
+} ook_protocol_t;
+
+/**
+ * @brief A code ready to be encoded: protocol, value and effective te
+ */
+typedef struct {
+    const ook_protocol_t *proto;
+    uint32_t code;
+    uint16_t te_us;     // 0 = protocol nominal te
+} ook_frame_t;
+
+/**
+ * @brief Several frames played back to back in one transmission (scenes)
+ */
+#define OOK_SEQ_MAX_STEPS 8
+#define OOK_SEQ_MAX_GAP_MS 10000
+
+typedef struct {
+    ook_frame_t frame;
+    uint8_t repeats;
+    uint16_t gap_ms;    // Carrier off after the last repeat, ignored on the last step
+} ook_seq_step_t;
+
+typedef struct {
+    uint8_t count;
+    ook_seq_step_t steps[OOK_SEQ_MAX_STEPS];
+} ook_sequence_t;
+
+// ====== Protocol Table ======
+extern const ook_protocol_t ook_protocols[OOK_PROTO_COUNT];
+
+// ====== Function Prototypes ======
+const ook_protocol_t *ook_protocol_get(ook_protocol_id_t id);
+
+/**
+ * @brief Air time of one frame (sync + all bits), in µs
+ */
+uint32_t ook_frame_duration_us(const ook_frame_t *frame);
+
+/**
+ * @brief Air time of a sequence (all frames and repeats, gaps excluded), in µs
+ */
+uint32_t ook_sequence_airtime_us(const ook_sequence_t *seq);
+
+// Used by the encoder in the RMT ISR: always inlined, never a flash call
+FORCE_INLINE_ATTR uint16_t ook_frame_te(const ook_frame_t *frame)
+{
+    return frame->te_us ? frame->te_us : frame->proto->te_us;
+}
+
+#endif // OOK_PROTOCOL_H
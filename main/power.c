@@ -0,0 +1,25 @@
+#include "power.h"
+#include "esp_log.h"
+#include "esp_pm.h"
+
+static const char *TAG = "POWER";
+
+// ====== Public API ======
+void power_init(void)
+{
+#if CONFIG_ZB433_PM
+    esp_pm_config_t pm_config = {
+        .max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+        .min_freq_mhz = CONFIG_ZB433_PM_MIN_FREQ_MHZ,
+        .light_sleep_enable = false,
+    };
+    esp_err_t ret = esp_pm_configure(&pm_config);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Power management not applied: %s", esp_err_to_name(ret));
+        return;
+    }
+    ESP_LOGI(TAG, "DFS %d-%d MHz, tickless idle, no light sleep", pm_config.min_freq_mhz, pm_config.max_freq_mhz);
+#else
+    ESP_LOGD(TAG, "Power management disabled");
+#endif
+}
@@ -0,0 +1,21 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include "sdkconfig.h"
+
+/*
+Power management profile (CONFIG_ZB433_PM): dynamic frequency scaling
+between CONFIG_ZB433_PM_MIN_FREQ_MHZ and the default CPU clock, plus
+FreeRTOS tickless idle. Light sleep stays off: a router must keep its
+receiver on. Drivers that need a stable clock hold their own PM locks
+(RMT TX: came433.c), the cost of waking back up is reported as the
+LAT_SEG_WAKE latency segment.
+*/
+
+// ====== Function Prototypes ======
+/**
+ * @brief Apply the PM profile, call early in app_main (no-op when disabled)
+ */
+void power_init(void);
+
+#endif // POWER_H
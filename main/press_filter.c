@@ -0,0 +1,76 @@
+#include "press_filter.h"
+#include "gates.h"
+#include "rf_tx.h"
+#include "trace.h"
+#include "esp_timer.h"
+
+/*
+One Zigbee2MQTT press may reach zb_action_handler twice (custom cluster
+request + SET_ATTR_VALUE fallback), and users hammer the button while the
+gate is still being signalled. Each accepted press costs ~250 ms of 433 MHz
+airtime and delays the other gates, so repeats are filtered here.
+All calls happen in the Zigbee task: no locking.
+*/
+
+typedef struct {
+    int64_t last_us;        // Last new press (accepted or merged), duplicates never extend the window
+    press_key_t key;
+    uint32_t duplicates;
+    uint32_t merged;
+} press_track_t;
+
+static press_track_t press_tracks[GATE_MAX];
+
+static bool press_same(const press_key_t *a, const press_key_t *b)
+{
+    // A trigger without a key is assumed to be the other delivery of the keyed one
+    if (!a->has_key || !b->has_key) {
+        return true;
+    }
+    return a->tsn == b->tsn && a->src_addr == b->src_addr;
+}
+
+// ====== Public API ======
+press_verdict_t press_filter_check(uint8_t endpoint, const press_key_t *key)
+{
+    int index = gates_index(endpoint);
+    if (index < 0 || index >= GATE_MAX) {
+        return PRESS_ACCEPT;
+    }
+
+    press_track_t *track = &press_tracks[index];
+    int64_t now = esp_timer_get_time();
+
+    if (track->last_us != 0 && now - track->last_us < (int64_t)PRESS_FILTER_WINDOW_MS * 1000 &&
+        press_same(&track->key, key)) {
+        track->duplicates++;
+        // Keep the richer identity for the next comparison
+        if (key->has_key) {
+            track->key = *key;
+        }
+        TRACE2(DUP_TSN, endpoint, key->tsn);
+        return PRESS_DUPLICATE;
+    }
+
+    track->last_us = now;
+    track->key = *key;
+
+    if (rf_tx_endpoint_busy(endpoint)) {
+        track->merged++;
+        TRACE1(MERGED, endpoint);
+        return PRESS_MERGED;
+    }
+    return PRESS_ACCEPT;
+}
+
+void press_filter_get_stats(uint8_t endpoint, uint32_t *duplicates, uint32_t *merged)
+{
+    int index = gates_index(endpoint);
+    if (index < 0 || index >= GATE_MAX) {
+        *duplicates = 0;
+        *merged = 0;
+        return;
+    }
+    *duplicates = press_tracks[index].duplicates;
+    *merged = press_tracks[index].merged;
+}
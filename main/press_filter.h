@@ -0,0 +1,38 @@
+#ifndef PRESS_FILTER_H
+#define PRESS_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+// ====== Press Filter Configuration ======
+#define PRESS_FILTER_WINDOW_MS CONFIG_ZB433_DEDUP_WINDOW_MS
+
+typedef enum {
+    PRESS_ACCEPT = 0,       // New press: start an RF burst
+    PRESS_DUPLICATE,        // Same press delivered twice (other callback or APS retry)
+    PRESS_MERGED,           // New press while this gate's burst is queued or on air
+} press_verdict_t;
+
+/**
+ * @brief Identity of a trigger, when the callback provides one
+ *
+ * SET_ATTR_VALUE callbacks carry no ZCL header: has_key = false, and they are
+ * matched against any press seen on the endpoint within the window.
+ */
+typedef struct {
+    bool has_key;
+    uint8_t tsn;            // ZCL transaction sequence number
+    uint16_t src_addr;      // Sender short address
+} press_key_t;
+
+// ====== Function Prototypes ======
+
+/**
+ * @brief Classify a trigger; call from the Zigbee task only
+ */
+press_verdict_t press_filter_check(uint8_t endpoint, const press_key_t *key);
+
+void press_filter_get_stats(uint8_t endpoint, uint32_t *duplicates, uint32_t *merged);
+
+#endif // PRESS_FILTER_H
@@ -0,0 +1,274 @@
+#include "rf_learn.h"
+#include "ook_decoder.h"
+#include "gates.h"
+#include "came433.h"
+#include "led.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_zigbee_core.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "driver/rmt_rx.h"
+#include "esp_attr.h"
+#include <stdlib.h>
+#include <inttypes.h>
+
+static const char *TAG = "RF_LEARN";
+
+typedef struct {
+    uint8_t endpoint;
+    uint8_t tx;             // RF_LEARN_TX_KEEP or transmitter index
+    uint16_t timeout_s;
+} rf_learn_req_t;
+
+typedef struct {
+    rmt_symbol_word_t *symbols;
+    size_t count;
+} rf_learn_chunk_t;
+
+static rmt_channel_handle_t learn_rx_channel = NULL;
+static QueueHandle_t learn_req_queue = NULL;
+static QueueHandle_t learn_rx_queue = NULL;
+static StaticQueue_t learn_req_queue_buf;
+static uint8_t learn_req_queue_storage[sizeof(rf_learn_req_t)];
+static StaticQueue_t learn_rx_queue_buf;
+static uint8_t learn_rx_queue_storage[RF_LEARN_BUFFERS * sizeof(rf_learn_chunk_t)];
+static StaticTask_t learn_task_buf;
+static StackType_t learn_task_stack[RF_LEARN_TASK_STACK];
+static rmt_symbol_word_t learn_rx_buffers[RF_LEARN_BUFFERS][RF_LEARN_RX_SYMBOLS];
+static ook_decoder_t learn_decoder;
+
+static const rmt_receive_config_t learn_rx_config = {
+    .signal_range_min_ns = RF_LEARN_RANGE_MIN_NS,
+    .signal_range_max_ns = RF_LEARN_RANGE_MAX_NS,
+};
+
+// ====== Private Functions ======
+
+/**
+ * @brief RMT receive-done event (ISR context): hand the filled buffer to the task
+ */
+static bool IRAM_ATTR rf_learn_rx_done_cb(rmt_channel_handle_t channel, const rmt_rx_done_event_data_t *edata, void *user_ctx)
+{
+    BaseType_t task_woken = pdFALSE;
+    rf_learn_chunk_t chunk = {
+        .symbols = edata->received_symbols,
+        .count = edata->num_symbols,
+    };
+    xQueueSendFromISR(learn_rx_queue, &chunk, &task_woken);
+    return task_woken == pdTRUE;
+}
+
+/**
+ * @brief Count a decoded frame; true once the same one was seen RF_LEARN_MATCHES times in a row
+ */
+static bool rf_learn_match(const ook_decoded_t *frame, ook_decoded_t *learned, uint8_t *matches)
+{
+    ESP_LOGD(TAG, "Frame: %s 0x%06" PRIX32 " (te %u us)", ook_protocol_get(frame->protocol)->name, frame->code, frame->te_us);
+    if (*matches > 0 && frame->protocol == learned->protocol && frame->code == learned->code) {
+        (*matches)++;
+    } else {
+        *learned = *frame;
+        *matches = 1;
+    }
+    return *matches >= RF_LEARN_MATCHES;
+}
+
+/**
+ * @brief Feed one RX chunk to the decoder; true once the same frame was seen often enough
+ */
+static bool rf_learn_decode(const rf_learn_chunk_t *chunk, ook_decoded_t *learned, uint8_t *matches)
+{
+    ook_decoded_t frame;
+
+    for (size_t i = 0; i < chunk->count; i++) {
+        const rmt_symbol_word_t *symbol = &chunk->symbols[i];
+        // Both halves, always: a frame may complete on either one, and skipping
+        // the other would cost the decoder the first pair of the next frame
+        if (ook_decoder_feed(&learn_decoder, symbol->level0, symbol->duration0, &frame) &&
+            rf_learn_match(&frame, learned, matches)) {
+            return true;
+        }
+        if (ook_decoder_feed(&learn_decoder, symbol->level1, symbol->duration1, &frame) &&
+            rf_learn_match(&frame, learned, matches)) {
+            return true;
+        }
+    }
+
+    // A zero duration is the end marker of an idle line longer than any sync; a
+    // chunk without it stopped on a full buffer and continues in the next one
+    const rmt_symbol_word_t *last = chunk->count > 0 ? &chunk->symbols[chunk->count - 1] : NULL;
+    if (last != NULL && (last->duration0 == 0 || last->duration1 == 0) && ook_decoder_flush(&learn_decoder, &frame)) {
+        return rf_learn_match(&frame, learned, matches);
+    }
+    return false;
+}
+
+static esp_err_t rf_learn_commit(uint8_t endpoint, uint8_t tx, const ook_decoded_t *learned)
+{
+    const ook_protocol_t *proto = ook_protocol_get(learned->protocol);
+    const gate_t *gate = gates_get(endpoint);
+    gate_cfg_t cfg = {
+        .repeats = CAME_REPEATS,
+        .led_rgb = {255, 255, 255},
+    };
+
+    // Re-learning keeps the gate's LED color, repeats and priority
+    if (gate != NULL) {
+        cfg = gate->cfg;
+    }
+    if (tx != RF_LEARN_TX_KEEP) {
+        cfg.tx = tx;
+    }
+    cfg.protocol = learned->protocol;
+    cfg.code = learned->code;
+    uint32_t margin = (uint32_t)proto->te_us * RF_LEARN_TE_MARGIN_PCT / 100;
+    cfg.te_us = (learned->te_us + margin >= proto->te_us && learned->te_us <= proto->te_us + margin) ? 0 : learned->te_us;
+
+    // The Zigbee task reads the gate table: update it under the stack lock
+    esp_zb_lock_acquire(portMAX_DELAY);
+    esp_err_t ret = gates_set(endpoint, &cfg);
+    esp_zb_lock_release();
+    return ret;
+}
+
+static void rf_learn_session(const rf_learn_req_t *req)
+{
+    ook_decoded_t learned = {0};
+    uint8_t matches = 0;
+    int current = 0;
+    bool done = false;
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)req->timeout_s * 1000000;
+
+    ESP_LOGI(TAG, "EP%d: learning for %u s, press the remote", req->endpoint, req->timeout_s);
+    led_identify_breathe(req->timeout_s * 1000u);
+
+    ook_decoder_reset(&learn_decoder);
+    xQueueReset(learn_rx_queue);
+    esp_err_t ret = rmt_enable(learn_rx_channel);
+    if (ret == ESP_OK) {
+        ret = rmt_receive(learn_rx_channel, learn_rx_buffers[current], sizeof(learn_rx_buffers[current]), &learn_rx_config);
+        if (ret != ESP_OK) {
+            rmt_disable(learn_rx_channel);
+        }
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "EP%d: receiver unavailable: %s", req->endpoint, esp_err_to_name(ret));
+        led_off();
+        return;
+    }
+
+    while (!done) {
+        int64_t left_us = deadline_us - esp_timer_get_time();
+        rf_learn_chunk_t chunk;
+        if (left_us <= 0 || xQueueReceive(learn_rx_queue, &chunk, pdMS_TO_TICKS(left_us / 1000) + 1) != pdTRUE) {
+            break;
+        }
+
+        // Re-arm on the other buffer first: nothing is lost while this one is decoded
+        current ^= 1;
+        ret = rmt_receive(learn_rx_channel, learn_rx_buffers[current], sizeof(learn_rx_buffers[current]), &learn_rx_config);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "RMT receive failed: %s", esp_err_to_name(ret));
+            break;
+        }
+
+        done = rf_learn_decode(&chunk, &learned, &matches);
+    }
+
+    rmt_disable(learn_rx_channel);
+
+    if (!done) {
+        ESP_LOGW(TAG, "EP%d: no code learned", req->endpoint);
+        led_off();
+        return;
+    }
+
+    ret = rf_learn_commit(req->endpoint, req->tx, &learned);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "EP%d: learned %s 0x%06" PRIX32 " (te %u us)", req->endpoint,
+                 ook_protocol_get(learned.protocol)->name, learned.code, learned.te_us);
+        led_identify_okay();
+    } else {
+        ESP_LOGE(TAG, "EP%d: failed to store learned code: %s", req->endpoint, esp_err_to_name(ret));
+        led_off();
+    }
+}
+
+// ====== Learning Task ======
+static void rf_learn_task(void *pvParameters)
+{
+    rf_learn_req_t req;
+
+    while (1) {
+        xQueueReceive(learn_req_queue, &req, portMAX_DELAY);
+        rf_learn_session(&req);
+    }
+}
+
+// ====== Public API ======
+void rf_learn_init(void)
+{
+    if (RF_LEARN_GPIO < 0) {
+        ESP_LOGI(TAG, "No 433MHz receiver configured, learning disabled");
+        return;
+    }
+
+    rmt_rx_channel_config_t rx_chan_config = {
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .gpio_num = RF_LEARN_GPIO,
+        .mem_block_symbols = RF_LEARN_RX_SYMBOLS,
+        .resolution_hz = 1000000, // 1µs resolution, same as TX
+    };
+    // Not worth a boot loop: the gates keep working, only learning is lost
+    esp_err_t ret = rmt_new_rx_channel(&rx_chan_config, &learn_rx_channel);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "No RMT RX channel for GPIO%d (%s), learning disabled", RF_LEARN_GPIO, esp_err_to_name(ret));
+        return;
+    }
+
+    learn_rx_queue = xQueueCreateStatic(RF_LEARN_BUFFERS, sizeof(rf_learn_chunk_t),
+                                        learn_rx_queue_storage, &learn_rx_queue_buf);
+    learn_req_queue = xQueueCreateStatic(1, sizeof(rf_learn_req_t), learn_req_queue_storage, &learn_req_queue_buf);
+    if (learn_rx_queue == NULL || learn_req_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create learning queues");
+        abort();
+    }
+
+    rmt_rx_event_callbacks_t rx_callbacks = {
+        .on_recv_done = rf_learn_rx_done_cb,
+    };
+    ESP_ERROR_CHECK(rmt_rx_register_event_callbacks(learn_rx_channel, &rx_callbacks, NULL));
+
+    if (xTaskCreateStatic(rf_learn_task, "RF_learn", RF_LEARN_TASK_STACK, NULL, RF_LEARN_TASK_PRIORITY,
+                          learn_task_stack, &learn_task_buf) == NULL) {
+        ESP_LOGE(TAG, "Failed to create learning task");
+        abort();
+    }
+    ESP_LOGI(TAG, "433MHz receiver on GPIO%d, learning available", RF_LEARN_GPIO);
+}
+
+esp_err_t rf_learn_start(uint8_t endpoint, uint16_t timeout_s, uint8_t tx)
+{
+    if (learn_req_queue == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    int index = gates_index(endpoint);
+    if (index < 0 || index > gates_count() || index >= GATE_MAX ||
+        (tx != RF_LEARN_TX_KEEP && tx >= came433_tx_count())) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    rf_learn_req_t req = {
+        .endpoint = endpoint,
+        .tx = tx,
+        .timeout_s = timeout_s ? timeout_s : RF_LEARN_DEFAULT_TIMEOUT_S,
+    };
+    // One session at a time: the request slot stays full until the task picks it up
+    if (uxQueueMessagesWaiting(learn_req_queue) > 0 || xQueueSend(learn_req_queue, &req, 0) != pdTRUE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,44 @@
+#ifndef RF_LEARN_H
+#define RF_LEARN_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+/*
+433MHz learning mode: an RMT RX channel on a spare GPIO (433MHz receiver
+module DATA pin) captures a remote, the streaming OOK decoder recognises
+the protocol and code, and the result is committed to the gate table once
+RF_LEARN_MATCHES identical frames have been seen. The channel is only
+enabled during a learning session.
+*/
+
+// ====== Learning Configuration ======
+#define RF_LEARN_GPIO CONFIG_ZB433_RX_GPIO      // -1 = no receiver fitted
+#define RF_LEARN_RX_SYMBOLS 48                  // One C6 memory block: TX0 and the LED may hold the others
+#define RF_LEARN_BUFFERS 2                      // Ping-pong: one receiving while the other is decoded
+#define RF_LEARN_MATCHES 2                      // Identical consecutive frames required
+#define RF_LEARN_DEFAULT_TIMEOUT_S 30
+#define RF_LEARN_RANGE_MIN_NS 1250              // Glitch filter
+#define RF_LEARN_RANGE_MAX_NS 30000000          // Idle threshold, above the longest sync (CAME 24.3 ms)
+#define RF_LEARN_TE_MARGIN_PCT 5                // Keep the nominal te if the measured one is this close
+#define RF_LEARN_TX_KEEP 0xFF                   // Keep the gate's transmitter (TX0 for a new gate)
+#define RF_LEARN_TASK_STACK 3072
+#define RF_LEARN_TASK_PRIORITY 3
+
+// ====== Function Prototypes ======
+void rf_learn_init(void);
+
+/**
+ * @brief Start learning the code of @p endpoint (any task, returns immediately)
+ *
+ * @p endpoint may be an existing gate or the next free one (appended, its
+ * Zigbee endpoint appears after a reboot). 0 = RF_LEARN_DEFAULT_TIMEOUT_S.
+ * @p tx binds the gate to a transmitter, RF_LEARN_TX_KEEP leaves it as is.
+ *
+ * @return ESP_ERR_NOT_SUPPORTED without receiver, ESP_ERR_INVALID_STATE if a
+ *         session is already running
+ */
+esp_err_t rf_learn_start(uint8_t endpoint, uint16_t timeout_s, uint8_t tx);
+
+#endif // RF_LEARN_H
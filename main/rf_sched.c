@@ -0,0 +1,231 @@
+#include "rf_sched.h"
+#include "gates.h"
+#include "trace.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "RF_SCHED";
+
+/*
+Airtime scheduler in front of each transmitter (one independent instance
+per RF module, each with its own budget). Each gate has a tiny FIFO;
+the worker is served the highest-priority head, round-robin across gates,
+so one busy endpoint cannot starve the others. Airtime is accounted in a
+rolling window of RF_SCHED_BUCKETS buckets and a burst only starts if it
+fits in the duty-cycle budget (ETSI-style 1% / 10%).
+*/
+
+#define RF_SCHED_WINDOW_US ((int64_t)RF_SCHED_WINDOW_S * 1000000)
+#define RF_SCHED_BUCKET_US (RF_SCHED_WINDOW_US / RF_SCHED_BUCKETS)
+
+typedef struct {
+    rf_job_t jobs[RF_SCHED_GATE_DEPTH];
+    uint8_t head;
+    uint8_t count;
+} rf_gate_queue_t;
+
+typedef struct {
+    portMUX_TYPE lock;
+    SemaphoreHandle_t wake;
+    StaticSemaphore_t wake_buf;
+    rf_gate_queue_t gate_queues[GATE_MAX];
+    uint8_t rr_cursor;
+    uint8_t queued_total;
+
+    // Rolling airtime window
+    uint32_t bucket_us[RF_SCHED_BUCKETS];
+    int64_t bucket_epoch;               // Absolute index of the current bucket
+    uint32_t window_used_us;
+    uint32_t budget_us;
+    uint16_t duty_permille;
+
+    rf_sched_stats_t stats;
+} rf_sched_t;
+
+static rf_sched_t scheds[RF_SCHED_MAX];
+
+// ====== Private Functions ======
+
+// Expire buckets that left the window; caller holds sched->lock
+static void window_advance(rf_sched_t *sched, int64_t now)
+{
+    int64_t epoch = now / RF_SCHED_BUCKET_US;
+    int64_t steps = epoch - sched->bucket_epoch;
+
+    if (steps >= RF_SCHED_BUCKETS) {
+        memset(sched->bucket_us, 0, sizeof(sched->bucket_us));
+        sched->window_used_us = 0;
+    } else {
+        for (int64_t e = sched->bucket_epoch + 1; e <= epoch; e++) {
+            uint32_t *bucket = &sched->bucket_us[e % RF_SCHED_BUCKETS];
+            sched->window_used_us -= *bucket;
+            *bucket = 0;
+        }
+    }
+    sched->bucket_epoch = epoch;
+}
+
+// Time until enough old buckets expire for @p airtime to fit; caller holds sched->lock
+static uint32_t window_wait_ms(const rf_sched_t *sched, int64_t now, uint32_t airtime)
+{
+    uint32_t freed = 0;
+    uint32_t excess = sched->window_used_us + airtime - sched->budget_us;
+
+    for (int k = 1; k < RF_SCHED_BUCKETS; k++) {
+        freed += sched->bucket_us[(sched->bucket_epoch + k) % RF_SCHED_BUCKETS];
+        if (freed >= excess) {
+            int64_t expiry = (sched->bucket_epoch + k) * RF_SCHED_BUCKET_US;
+            return (uint32_t)((expiry - now) / 1000) + 1;
+        }
+    }
+    return (uint32_t)(RF_SCHED_BUCKET_US / 1000);
+}
+
+// Pick the next gate: best head priority, round-robin from rr_cursor; caller holds sched->lock
+static int pick_gate(const rf_sched_t *sched)
+{
+    int best = -1;
+    uint8_t best_prio = RF_PRIO_COUNT;
+
+    for (int n = 0; n < GATE_MAX; n++) {
+        int i = (sched->rr_cursor + n) % GATE_MAX;
+        const rf_gate_queue_t *q = &sched->gate_queues[i];
+        if (q->count > 0 && q->jobs[q->head].priority < best_prio) {
+            best = i;
+            best_prio = q->jobs[q->head].priority;
+        }
+    }
+    return best;
+}
+
+static bool rf_sched_pop(rf_sched_t *sched, rf_job_t *job, uint32_t *retry_ms)
+{
+    bool found = false;
+    int64_t now = esp_timer_get_time();
+
+    *retry_ms = 0;
+    portENTER_CRITICAL(&sched->lock);
+    int gate = pick_gate(sched);
+    if (gate >= 0) {
+        rf_gate_queue_t *q = &sched->gate_queues[gate];
+        const rf_job_t *head = &q->jobs[q->head];
+
+        window_advance(sched, now);
+        // rf_sched_push() refused bursts over the whole budget, so this always fits eventually
+        if (sched->window_used_us + head->airtime_us <= sched->budget_us) {
+            *job = *head;
+            q->head = (q->head + 1) % RF_SCHED_GATE_DEPTH;
+            q->count--;
+            sched->queued_total--;
+            sched->rr_cursor = (gate + 1) % GATE_MAX;
+
+            sched->bucket_us[sched->bucket_epoch % RF_SCHED_BUCKETS] += job->airtime_us;
+            sched->window_used_us += job->airtime_us;
+
+            uint32_t wait = (uint32_t)(now - job->enqueued_us);
+            sched->stats.wait_avg_us = sched->stats.wait_avg_us - sched->stats.wait_avg_us / 8 + wait / 8;
+            if (wait > sched->stats.wait_max_us) {
+                sched->stats.wait_max_us = wait;
+            }
+            found = true;
+        } else {
+            *retry_ms = window_wait_ms(sched, now, head->airtime_us);
+            sched->stats.throttled++;
+        }
+    }
+    portEXIT_CRITICAL(&sched->lock);
+
+    if (*retry_ms != 0) {
+        // Fires on every retry while held back: trace only, stats.throttled has the count
+        TRACE2(RF_THROTTLED, (uint32_t)(sched - scheds), *retry_ms);
+    }
+    return found;
+}
+
+// ====== Public API ======
+void rf_sched_init(uint8_t tx, uint16_t duty_permille)
+{
+    if (tx >= RF_SCHED_MAX) {
+        return;
+    }
+
+    rf_sched_t *sched = &scheds[tx];
+    sched->lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+    sched->wake = xSemaphoreCreateBinaryStatic(&sched->wake_buf);
+    if (sched->wake == NULL) {
+        ESP_LOGE(TAG, "Failed to create scheduler semaphore");
+        abort();
+    }
+    sched->duty_permille = duty_permille;
+    sched->budget_us = (uint32_t)(RF_SCHED_WINDOW_US * duty_permille / 1000);
+    sched->bucket_epoch = esp_timer_get_time() / RF_SCHED_BUCKET_US;
+    ESP_LOGI(TAG, "TX%d: duty cycle budget %d.%d%% over %d s (%lu ms)", tx, duty_permille / 10,
+             duty_permille % 10, RF_SCHED_WINDOW_S, (unsigned long)(sched->budget_us / 1000));
+}
+
+esp_err_t rf_sched_push(uint8_t tx, const rf_job_t *job)
+{
+    int gate = gates_index(job->endpoint);
+    if (tx >= RF_SCHED_MAX || scheds[tx].wake == NULL || gate < 0 || gate >= GATE_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    rf_sched_t *sched = &scheds[tx];
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&sched->lock);
+    rf_gate_queue_t *q = &sched->gate_queues[gate];
+    if (job->airtime_us > sched->budget_us) {
+        // Could never fit the window: refuse now rather than break the hard cap later
+        sched->stats.rejected++;
+        ret = ESP_ERR_INVALID_SIZE;
+    } else if (q->count < RF_SCHED_GATE_DEPTH) {
+        q->jobs[(q->head + q->count) % RF_SCHED_GATE_DEPTH] = *job;
+        q->count++;
+        sched->queued_total++;
+    } else {
+        sched->stats.rejected++;
+        ret = ESP_ERR_NO_MEM;
+    }
+    portEXIT_CRITICAL(&sched->lock);
+
+    if (ret == ESP_OK) {
+        xSemaphoreGive(sched->wake);
+    }
+    return ret;
+}
+
+void rf_sched_take(uint8_t tx, rf_job_t *job)
+{
+    rf_sched_t *sched = &scheds[tx];
+
+    while (1) {
+        uint32_t retry_ms = 0;
+        if (rf_sched_pop(sched, job, &retry_ms)) {
+            return;
+        }
+        // Sleep until a new job arrives, or until the budget frees up
+        xSemaphoreTake(sched->wake, retry_ms ? pdMS_TO_TICKS(retry_ms) : portMAX_DELAY);
+    }
+}
+
+void rf_sched_get_stats(uint8_t tx, rf_sched_stats_t *stats)
+{
+    if (tx >= RF_SCHED_MAX || scheds[tx].wake == NULL) {
+        *stats = (rf_sched_stats_t){0};
+        return;
+    }
+
+    rf_sched_t *sched = &scheds[tx];
+    portENTER_CRITICAL(&sched->lock);
+    window_advance(sched, esp_timer_get_time());
+    *stats = sched->stats;
+    stats->airtime_window_us = sched->window_used_us;
+    stats->budget_us = sched->budget_us;
+    stats->duty_cycle_bp = (uint32_t)((int64_t)sched->window_used_us * 10000 / RF_SCHED_WINDOW_US);
+    stats->queued = sched->queued_total;
+    portEXIT_CRITICAL(&sched->lock);
+}
@@ -0,0 +1,68 @@
+#ifndef RF_SCHED_H
+#define RF_SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "ook_protocol.h"
+#include "came433.h"
+#include "sdkconfig.h"
+
+// ====== Scheduler Configuration ======
+#define RF_SCHED_GATE_DEPTH 2                           // Pending bursts per gate
+#define RF_SCHED_BUCKETS 60                             // Rolling window resolution
+#define RF_SCHED_WINDOW_S CONFIG_ZB433_DUTY_WINDOW_S
+#define RF_SCHED_DUTY_PERMILLE CONFIG_ZB433_DUTY_CYCLE_PERMILLE          // TX0 (433.92 MHz)
+#define RF_SCHED_TX2_DUTY_PERMILLE CONFIG_ZB433_RF_TX2_DUTY_PERMILLE  // TX1 (e.g. 868 MHz)
+#define RF_SCHED_MAX CAME_TX_MAX                        // One independent scheduler per transmitter
+
+typedef enum {
+    RF_PRIO_HIGH = 0,
+    RF_PRIO_NORMAL,
+    RF_PRIO_COUNT
+} rf_prio_t;
+
+typedef struct {
+    ook_frame_t frame;
+    const ook_sequence_t *seq;  // Scene played instead of frame (rf_tx.c pool), NULL otherwise
+    int64_t arrival_us;     // ZCL command arrival, for end-to-end latency
+    int64_t enqueued_us;
+    uint32_t airtime_us;    // Whole burst, all repeats
+    uint8_t endpoint;
+    uint8_t repeats;
+    uint8_t priority;       // rf_prio_t
+} rf_job_t;
+
+typedef struct {
+    uint32_t duty_cycle_bp;     // Achieved duty cycle over the window (1/10000)
+    uint32_t airtime_window_us; // Airtime spent in the current window
+    uint32_t budget_us;         // Allowed airtime per window
+    uint32_t wait_avg_us;       // Queue wait, exponential average
+    uint32_t wait_max_us;
+    uint32_t throttled;         // Bursts held back by the duty-cycle budget
+    uint32_t rejected;          // Bursts refused: gate queue full, or longer than the whole budget
+    uint8_t queued;
+} rf_sched_stats_t;
+
+// ====== Function Prototypes ======
+void rf_sched_init(uint8_t tx, uint16_t duty_permille);
+
+/**
+ * @brief Queue a burst (non-blocking, any task)
+ *
+ * @return ESP_ERR_NO_MEM if this gate already has RF_SCHED_GATE_DEPTH bursts pending,
+ *         ESP_ERR_INVALID_SIZE if the burst alone exceeds the duty-cycle budget
+ */
+esp_err_t rf_sched_push(uint8_t tx, const rf_job_t *job);
+
+/**
+ * @brief Block until a burst may go on air, then reserve its airtime
+ *
+ * Jobs are served by priority, round-robin across gates within a priority,
+ * and only when the burst fits in the rolling duty-cycle budget.
+ */
+void rf_sched_take(uint8_t tx, rf_job_t *job);
+
+void rf_sched_get_stats(uint8_t tx, rf_sched_stats_t *stats);
+
+#endif // RF_SCHED_H
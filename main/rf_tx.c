@@ -0,0 +1,259 @@
+#include "rf_tx.h"
+#include "rf_sched.h"
+#include "came433.h"
+#include "gates.h"
+#include "latency.h"
+#include "trace.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "RF_TX";
+
+/*
+The Zigbee stack must never wait for the 433MHz radio: a CAME burst lasts
+~250 ms (5 x ~49 ms) during which the router would stop routing and acking.
+Commands go through the airtime scheduler (rf_sched.c) and are played by a
+dedicated worker per transmitter, so bursts on different modules overlap;
+completion comes from the RMT on_trans_done event instead of
+rmt_tx_wait_all_done().
+*/
+
+static rf_tx_done_cb_t rf_done_cb = NULL;
+static atomic_uint_fast8_t rf_pending[GATE_MAX];  // Queued + on-air bursts per gate
+static uint32_t rf_sent[CAME_TX_MAX];      // Each slot written by its worker only
+static uint32_t rf_failed[CAME_TX_MAX];
+static const char *const rf_task_names[CAME_TX_MAX] = {"RF_tx0", "RF_tx1"};
+static StaticTask_t rf_task_bufs[CAME_TX_MAX];
+static StackType_t rf_task_stacks[CAME_TX_MAX][RF_TX_TASK_STACK];
+
+// Sequences are too large for rf_job_t: jobs point into this pool instead
+typedef struct {
+    ook_sequence_t seq;
+    uint8_t endpoints[OOK_SEQ_MAX_STEPS];
+    atomic_bool in_use;
+} rf_seq_slot_t;
+
+static rf_seq_slot_t rf_seqs[RF_TX_SEQ_SLOTS];
+
+static atomic_uint_fast8_t *rf_pending_slot(uint8_t endpoint)
+{
+    int index = gates_index(endpoint);
+    return (index >= 0 && index < GATE_MAX) ? &rf_pending[index] : NULL;
+}
+
+static void rf_pending_add(uint8_t endpoint, int delta)
+{
+    atomic_uint_fast8_t *pending = rf_pending_slot(endpoint);
+    if (pending != NULL) {
+        atomic_fetch_add(pending, delta);
+    }
+}
+
+static void rf_seq_release(const ook_sequence_t *seq)
+{
+    rf_seq_slot_t *slot = __containerof(seq, rf_seq_slot_t, seq);
+
+    for (int i = 0; i < slot->seq.count; i++) {
+        rf_pending_add(slot->endpoints[i], -1);
+    }
+    atomic_store(&slot->in_use, false);
+}
+
+/**
+ * @brief Longest wait for the done event: the whole burst, scene gaps included, plus a margin
+ */
+static TickType_t rf_job_done_timeout(const rf_job_t *job)
+{
+    uint32_t timeout_ms = job->airtime_us / 1000 + RF_TX_DONE_MARGIN_MS;
+
+    if (job->seq != NULL) {
+        for (int i = 0; i + 1 < job->seq->count; i++) {
+            timeout_ms += job->seq->steps[i].gap_ms;
+        }
+    }
+    return pdMS_TO_TICKS(timeout_ms) + 1;
+}
+
+// ====== Worker Task ======
+static void rf_tx_task(void *pvParameters)
+{
+    uint8_t tx = (uint8_t)(uintptr_t)pvParameters;
+    rf_job_t job;
+
+    while (1) {
+        // Blocks until a burst is both pending and allowed by the duty-cycle budget
+        rf_sched_take(tx, &job);
+
+        int64_t start_us = esp_timer_get_time();
+        esp_err_t ret = job.seq != NULL ?
+                        came433_start_sequence(tx, job.seq, xTaskGetCurrentTaskHandle()) :
+                        came433_start(tx, &job.frame, job.repeats, xTaskGetCurrentTaskHandle());
+        if (ret == ESP_OK) {
+            // Sleep until the RMT ISR reports the end of the burst
+            TickType_t timeout = rf_job_done_timeout(&job);
+            if (ulTaskNotifyTake(pdTRUE, timeout) == 0) {
+                ESP_LOGE(TAG, "EP%d: no TX done event after %lu ms", job.endpoint,
+                         (unsigned long)pdTICKS_TO_MS(timeout));
+                ret = ESP_ERR_TIMEOUT;
+            }
+            came433_finish(tx);
+        }
+
+        int64_t done_us = esp_timer_get_time();
+        TRACE4(RF_DONE, job.endpoint, ret, (uint32_t)(start_us - job.enqueued_us), (uint32_t)(done_us - start_us));
+
+        if (ret == ESP_OK) {
+            rf_sent[tx]++;
+            came_tx_times_t times;
+            came433_get_times(tx, &times);
+            latency_stamps_t stamps = {
+                .arrival_us = job.arrival_us,
+                .dispatch_us = job.enqueued_us,
+                .wake_us = times.wake_us,
+                .enable_us = times.enable_us,
+                .first_edge_us = times.first_edge_us,
+                .done_us = times.done_us,
+            };
+            latency_record(job.endpoint, &stamps);
+        } else {
+            rf_failed[tx]++;
+        }
+
+        rf_sched_stats_t stats;
+        rf_sched_get_stats(tx, &stats);
+        TRACE5(RF_DUTY, tx, stats.duty_cycle_bp, stats.wait_avg_us, stats.wait_max_us, stats.queued);
+
+        if (job.seq != NULL) {
+            rf_seq_release(job.seq);
+        } else {
+            rf_pending_add(job.endpoint, -1);
+        }
+
+        if (rf_done_cb != NULL) {
+            rf_done_cb(job.endpoint, ret);
+        }
+    }
+}
+
+// ====== Public API ======
+void rf_tx_init(rf_tx_done_cb_t on_done)
+{
+    static const uint16_t duty_permille[CAME_TX_MAX] = {RF_SCHED_DUTY_PERMILLE, RF_SCHED_TX2_DUTY_PERMILLE};
+
+    rf_done_cb = on_done;
+    for (uint8_t tx = 0; tx < came433_tx_count(); tx++) {
+        rf_sched_init(tx, duty_permille[tx]);
+        if (xTaskCreateStatic(rf_tx_task, rf_task_names[tx], RF_TX_TASK_STACK, (void *)(uintptr_t)tx,
+                              RF_TX_TASK_PRIORITY, rf_task_stacks[tx], &rf_task_bufs[tx]) == NULL) {
+            ESP_LOGE(TAG, "Failed to create RF worker task");
+            abort();
+        }
+    }
+    ESP_LOGI(TAG, "%d RF worker(s) started (%d pending bursts per gate)", came433_tx_count(), RF_SCHED_GATE_DEPTH);
+}
+
+esp_err_t rf_tx_submit(uint8_t endpoint, uint8_t tx, const ook_frame_t *frame, uint8_t repeats,
+                       uint8_t priority, int64_t arrival_us)
+{
+    if (frame == NULL || frame->proto == NULL || repeats == 0 || tx >= came433_tx_count()) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    rf_job_t job = {
+        .frame = *frame,
+        .arrival_us = arrival_us,
+        .enqueued_us = esp_timer_get_time(),
+        .airtime_us = ook_frame_duration_us(frame) * repeats,
+        .endpoint = endpoint,
+        .repeats = repeats,
+        .priority = priority < RF_PRIO_COUNT ? priority : RF_PRIO_NORMAL,
+    };
+
+    rf_pending_add(endpoint, 1);
+
+    esp_err_t ret = rf_sched_push(tx, &job);
+    if (ret != ESP_OK) {
+        rf_pending_add(endpoint, -1);
+        if (ret == ESP_ERR_INVALID_SIZE) {
+            ESP_LOGW(TAG, "EP%d: %lu us burst exceeds the duty-cycle budget, command dropped", endpoint,
+                     (unsigned long)job.airtime_us);
+        } else {
+            ESP_LOGW(TAG, "EP%d: RF queue full, command dropped", endpoint);
+        }
+    }
+    return ret;
+}
+
+esp_err_t rf_tx_submit_sequence(uint8_t tx, const ook_sequence_t *seq, const uint8_t *endpoints,
+                                uint8_t priority, int64_t arrival_us)
+{
+    if (seq == NULL || endpoints == NULL || seq->count == 0 || seq->count > OOK_SEQ_MAX_STEPS ||
+        tx >= came433_tx_count()) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    rf_seq_slot_t *slot = NULL;
+    for (int i = 0; i < RF_TX_SEQ_SLOTS && slot == NULL; i++) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&rf_seqs[i].in_use, &expected, true)) {
+            slot = &rf_seqs[i];
+        }
+    }
+    if (slot == NULL) {
+        ESP_LOGW(TAG, "Too many sequences pending, dropped");
+        return ESP_ERR_NO_MEM;
+    }
+
+    slot->seq = *seq;
+    memcpy(slot->endpoints, endpoints, seq->count);
+    for (int i = 0; i < seq->count; i++) {
+        rf_pending_add(endpoints[i], 1);
+    }
+
+    rf_job_t job = {
+        .seq = &slot->seq,
+        .arrival_us = arrival_us,
+        .enqueued_us = esp_timer_get_time(),
+        .airtime_us = ook_sequence_airtime_us(seq),
+        .endpoint = endpoints[0],
+        .repeats = 1,
+        .priority = priority < RF_PRIO_COUNT ? priority : RF_PRIO_NORMAL,
+    };
+
+    esp_err_t ret = rf_sched_push(tx, &job);
+    if (ret != ESP_OK) {
+        rf_seq_release(&slot->seq);
+        if (ret == ESP_ERR_INVALID_SIZE) {
+            ESP_LOGW(TAG, "EP%d: %lu us sequence exceeds the duty-cycle budget, dropped", endpoints[0],
+                     (unsigned long)job.airtime_us);
+        } else {
+            ESP_LOGW(TAG, "EP%d: RF queue full, sequence dropped", endpoints[0]);
+        }
+    }
+    return ret;
+}
+
+bool rf_tx_endpoint_busy(uint8_t endpoint)
+{
+    atomic_uint_fast8_t *pending = rf_pending_slot(endpoint);
+    return pending != NULL && atomic_load(pending) > 0;
+}
+
+void rf_tx_get_stats(rf_tx_stats_t *stats)
+{
+    *stats = (rf_tx_stats_t){0};
+    for (uint8_t tx = 0; tx < came433_tx_count(); tx++) {
+        rf_sched_stats_t sched;
+        rf_sched_get_stats(tx, &sched);
+
+        stats->sent += rf_sent[tx];
+        stats->dropped += rf_failed[tx] + sched.rejected;
+        stats->queued += sched.queued;
+    }
+}
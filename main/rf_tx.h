@@ -0,0 +1,64 @@
+#ifndef RF_TX_H
+#define RF_TX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "came433.h"
+
+// ====== RF Worker Configuration ======
+#define RF_TX_TASK_STACK 3072
+#define RF_TX_TASK_PRIORITY 4          // Below Zigbee_main (5): the stack always wins the CPU
+#define RF_TX_DONE_MARGIN_MS 200       // Beyond the burst's airtime and gaps: the RMT done event is lost
+#define RF_TX_SEQ_SLOTS 2              // Scenes queued or on air at once
+
+/**
+ * @brief Completion hook, called from the RF worker task
+ */
+typedef void (*rf_tx_done_cb_t)(uint8_t endpoint, esp_err_t status);
+
+typedef struct {
+    uint32_t sent;          // Bursts that completed on air
+    uint32_t dropped;       // Refused by the scheduler (queue full) or failed on the RMT side
+    uint8_t queued;         // Bursts waiting for airtime, all transmitters
+} rf_tx_stats_t;
+
+// ====== Function Prototypes ======
+void rf_tx_init(rf_tx_done_cb_t on_done);
+
+/**
+ * @brief Queue a frame for transmission and return immediately
+ *
+ * Safe to call from the Zigbee stack context: never blocks. The burst is
+ * played when the airtime scheduler of transmitter @p tx grants it
+ * (priority, per-gate round-robin, duty-cycle budget).
+ *
+ * @param tx Transmitter index, < came433_tx_count()
+ * @param priority rf_prio_t (RF_PRIO_HIGH or RF_PRIO_NORMAL)
+ * @param arrival_us esp_timer stamp of the command that caused the burst
+ * @return ESP_ERR_NO_MEM if this gate already has too many bursts pending,
+ *         ESP_ERR_INVALID_SIZE if repeats x frame airtime exceeds the duty-cycle budget
+ */
+esp_err_t rf_tx_submit(uint8_t endpoint, uint8_t tx, const ook_frame_t *frame, uint8_t repeats,
+                       uint8_t priority, int64_t arrival_us);
+
+/**
+ * @brief Queue a multi-gate sequence, played as one RMT transaction on @p tx
+ *
+ * @p endpoints gives the gate of each step: they all count as busy until
+ * the sequence is done. It is queued and accounted under the first one.
+ *
+ * @return ESP_ERR_NO_MEM if RF_TX_SEQ_SLOTS sequences are already pending,
+ *         ESP_ERR_INVALID_SIZE if its airtime exceeds the duty-cycle budget
+ */
+esp_err_t rf_tx_submit_sequence(uint8_t tx, const ook_sequence_t *seq, const uint8_t *endpoints,
+                                uint8_t priority, int64_t arrival_us);
+
+/**
+ * @brief True while a burst for @p endpoint is queued or on air
+ */
+bool rf_tx_endpoint_busy(uint8_t endpoint);
+
+void rf_tx_get_stats(rf_tx_stats_t *stats);
+
+#endif // RF_TX_H
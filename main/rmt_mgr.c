@@ -0,0 +1,156 @@
+#include "rmt_mgr.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "RMT_MGR";
+
+typedef struct {
+    SemaphoreHandle_t mutex;
+    StaticSemaphore_t mutex_buf;
+    rmt_mgr_client_t *clients[RMT_MGR_SLOT_CLIENTS];
+    uint8_t count;
+    bool exclusive;                 // Holds a non-shareable client
+    rmt_mgr_client_t *bound;        // Client whose channel is currently open
+} rmt_mgr_slot_t;
+
+static rmt_mgr_slot_t mgr_slots[RMT_MGR_TX_SLOTS];
+
+// ====== Private Functions ======
+static int rmt_mgr_pick_slot(bool shareable)
+{
+    int best = -1;
+
+    // A free slot first, then the least crowded one that accepts this client
+    for (int i = 0; i < RMT_MGR_TX_SLOTS; i++) {
+        const rmt_mgr_slot_t *slot = &mgr_slots[i];
+        if (slot->count == 0) {
+            return i;
+        }
+        if (slot->count >= RMT_MGR_SLOT_CLIENTS || (!shareable && slot->exclusive)) {
+            continue;
+        }
+        if (best < 0 || slot->count < mgr_slots[best].count) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+#if CONFIG_ZB433_STATIC_ALLOC
+/**
+ * @brief Take the slot away from its shareable clients for good (zero-heap mode)
+ *
+ * Time-sharing deletes and recreates driver objects at every handover, so a
+ * transmitter that would share a slot gets it alone; the evicted clients
+ * find their slot gone and stay dark.
+ */
+static void rmt_mgr_evict(rmt_mgr_slot_t *slot, const rmt_mgr_client_t *client)
+{
+    // The evicted client may be drawing right now: wait for it to release
+    xSemaphoreTake(slot->mutex, portMAX_DELAY);
+    for (int i = 0; i < slot->count; i++) {
+        ESP_LOGW(TAG, "%s: out of RMT TX channels, %s gives up its channel (no time-sharing in zero-heap mode)",
+                 client->name, slot->clients[i]->name);
+        slot->clients[i]->slot = -1;
+        slot->clients[i] = NULL;
+    }
+    if (slot->bound != NULL) {
+        slot->bound->close(slot->bound->ctx);
+        slot->bound = NULL;
+    }
+    slot->count = 0;
+    xSemaphoreGive(slot->mutex);
+}
+#endif
+
+// ====== Public API ======
+esp_err_t rmt_mgr_register(rmt_mgr_client_t *client, bool shareable)
+{
+    client->slot = -1;
+    int index = rmt_mgr_pick_slot(shareable);
+    if (index < 0) {
+        ESP_LOGE(TAG, "No RMT TX channel left for %s", client->name);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    rmt_mgr_slot_t *slot = &mgr_slots[index];
+#if CONFIG_ZB433_STATIC_ALLOC
+    // Every handover deletes and recreates driver objects: no time-sharing without heap
+    if (slot->bound != NULL) {
+        if (shareable) {
+            ESP_LOGW(TAG, "%s: out of RMT TX channels, time-sharing disabled in zero-heap mode", client->name);
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+        rmt_mgr_evict(slot, client);    // Only shareable clients there: rmt_mgr_pick_slot() skips exclusive slots
+    }
+#endif
+    if (slot->mutex == NULL) {
+        slot->mutex = xSemaphoreCreateMutexStatic(&slot->mutex_buf);
+        if (slot->mutex == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    if (slot->bound == NULL) {
+        esp_err_t ret = client->open(client->ctx);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        slot->bound = client;
+        ESP_LOGI(TAG, "%s: dedicated RMT TX channel %d", client->name, index);
+    } else {
+        ESP_LOGW(TAG, "%s: out of RMT TX channels, time-shared with %s", client->name, slot->bound->name);
+    }
+
+    client->slot = index;
+    slot->clients[slot->count++] = client;
+    slot->exclusive |= !shareable;
+    return ESP_OK;
+}
+
+esp_err_t rmt_mgr_acquire(rmt_mgr_client_t *client, TickType_t wait)
+{
+    int8_t index = client->slot;
+    if (index < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    rmt_mgr_slot_t *slot = &mgr_slots[index];
+    if (xSemaphoreTake(slot->mutex, wait) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    if (client->slot != index) {
+        // Evicted while waiting for the slot
+        xSemaphoreGive(slot->mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (slot->bound != client) {
+        // Hand the hardware channel over: only one RMT channel object per slot at a time
+        if (slot->bound != NULL) {
+            slot->bound->close(slot->bound->ctx);
+            slot->bound = NULL;
+        }
+        esp_err_t ret = client->open(client->ctx);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "%s: failed to reopen RMT channel: %s", client->name, esp_err_to_name(ret));
+            xSemaphoreGive(slot->mutex);
+            return ret;
+        }
+        slot->bound = client;
+    }
+    return ESP_OK;
+}
+
+void rmt_mgr_release(rmt_mgr_client_t *client)
+{
+    if (client->slot >= 0) {
+        xSemaphoreGive(mgr_slots[client->slot].mutex);
+    }
+}
+
+bool rmt_mgr_shared(const rmt_mgr_client_t *client)
+{
+    return client->slot >= 0 && mgr_slots[client->slot].count > 1;
+}
@@ -0,0 +1,65 @@
+#ifndef RMT_MGR_H
+#define RMT_MGR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "soc/soc_caps.h"
+
+/*
+RMT TX channel manager: the ESP32-C6 has only two TX channels, shared by
+the RF transmitters and the LED strip. Each client gets a dedicated
+channel while there are enough of them; past that, a shareable client
+(the LED) is time-shared with a transmitter. Clients keep their channel
+open between uses, it is only torn down when the other client of the
+slot needs it. RX channels (learning mode) are a separate pool.
+*/
+
+// ====== Manager Configuration ======
+#define RMT_MGR_TX_SLOTS SOC_RMT_TX_CANDIDATES_PER_GROUP
+#define RMT_MGR_SLOT_CLIENTS 2
+
+/**
+ * @brief A user of one RMT TX channel
+ *
+ * open() creates the RMT channel on the client's GPIO, close() deletes it
+ * and parks the GPIO in its idle state. Both run in the acquiring task.
+ */
+typedef struct {
+    const char *name;
+    esp_err_t (*open)(void *ctx);
+    void (*close)(void *ctx);
+    void *ctx;
+    int8_t slot;            // Assigned by rmt_mgr_register()
+} rmt_mgr_client_t;
+
+// ====== Function Prototypes ======
+/**
+ * @brief Assign a channel slot to @p client and open it if the slot is free (app_main only)
+ *
+ * A slot holds at most one non-shareable client. With CONFIG_ZB433_STATIC_ALLOC
+ * slots are never time-shared: a non-shareable client evicts the shareable
+ * ones of its slot, whose rmt_mgr_acquire() then fails with ESP_ERR_INVALID_STATE.
+ *
+ * @return ESP_ERR_NOT_FOUND if every slot already has a non-shareable client,
+ *         ESP_ERR_NOT_SUPPORTED for a shareable client that would have to time-share
+ *         with CONFIG_ZB433_STATIC_ALLOC
+ */
+esp_err_t rmt_mgr_register(rmt_mgr_client_t *client, bool shareable);
+
+/**
+ * @brief Take exclusive use of the client's channel, reopening it if the slot was lent out
+ *
+ * @return ESP_ERR_TIMEOUT if the other client of the slot kept it for longer than @p wait
+ */
+esp_err_t rmt_mgr_acquire(rmt_mgr_client_t *client, TickType_t wait);
+
+void rmt_mgr_release(rmt_mgr_client_t *client);
+
+/**
+ * @brief True if @p client shares its channel with another client
+ */
+bool rmt_mgr_shared(const rmt_mgr_client_t *client);
+
+#endif // RMT_MGR_H
@@ -0,0 +1,166 @@
+#include "trace.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+static const char *TAG = "TRACE";
+
+#define TRACE_RING_MASK (TRACE_RING_SIZE - 1)
+#define TRACE_LINE_MAX 128
+
+typedef struct {
+    atomic_uint_fast32_t seq;   // Write index + 1 once the record is complete, 0 while written
+    uint32_t ts_us;
+    uint16_t event;
+    uint16_t reserved;
+    uint32_t args[TRACE_MAX_ARGS];
+} trace_record_t;
+
+typedef struct {
+    uint8_t module;
+    uint8_t level;
+    const char *fmt;
+} trace_desc_t;
+
+#define TRACE_MOD_TAG(name, tag) tag,
+static const char *const trace_tags[TRACE_MOD_COUNT] = {
+    TRACE_MODULES(TRACE_MOD_TAG)
+};
+#undef TRACE_MOD_TAG
+
+#define TRACE_EV_DESC(name, mod, lvl, format) [TRACE_EV_##name] = {.module = TRACE_MOD_##mod, .level = lvl, .fmt = format},
+static const trace_desc_t trace_events[TRACE_EV_COUNT] = {
+    TRACE_EVENTS(TRACE_EV_DESC)
+};
+#undef TRACE_EV_DESC
+
+static trace_record_t trace_ring[TRACE_RING_SIZE];
+static atomic_uint_fast32_t trace_head = 0;         // Next write index (producers)
+static uint32_t trace_tail = 0;                     // Next read index (drain task only)
+static atomic_uint_fast32_t trace_lost = 0;
+static volatile uint8_t trace_levels[TRACE_MOD_COUNT];
+static StaticTask_t trace_task_buf;
+static StackType_t trace_task_stack[TRACE_TASK_STACK];
+
+_Static_assert((TRACE_RING_SIZE & TRACE_RING_MASK) == 0, "TRACE_RING_SIZE must be a power of two");
+_Static_assert(TRACE_MOD_COUNT * TRACE_LEVEL_BITS <= 32, "Packed trace levels must fit in 32 bits");
+
+// ====== Drain Task ======
+
+static void trace_print(const trace_record_t *rec)
+{
+    const trace_desc_t *desc = &trace_events[rec->event];
+    char line[TRACE_LINE_MAX];
+
+    snprintf(line, sizeof(line), desc->fmt,
+             rec->args[0], rec->args[1], rec->args[2], rec->args[3], rec->args[4]);
+    ESP_LOG_LEVEL((esp_log_level_t)desc->level, trace_tags[desc->module], "[%" PRIu32 ".%03" PRIu32 " ms] %s",
+                  rec->ts_us / 1000, rec->ts_us % 1000, line);
+}
+
+static void trace_task(void *pvParameters)
+{
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(TRACE_DRAIN_PERIOD_MS));
+
+        uint32_t head = atomic_load_explicit(&trace_head, memory_order_acquire);
+        if (head - trace_tail > TRACE_RING_SIZE) {
+            // Producers lapped us: the oldest records are gone
+            atomic_fetch_add(&trace_lost, head - trace_tail - TRACE_RING_SIZE);
+            trace_tail = head - TRACE_RING_SIZE;
+        }
+
+        while (trace_tail != head) {
+            trace_record_t *slot = &trace_ring[trace_tail & TRACE_RING_MASK];
+            uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+            if (seq != trace_tail + 1) {
+                if (seq == 0 || seq < trace_tail + 1) {
+                    break;      // Still being written, retry next period
+                }
+                atomic_fetch_add(&trace_lost, 1);   // Overwritten by a newer record
+                trace_tail++;
+                continue;
+            }
+
+            trace_record_t copy = *slot;
+            if (atomic_load_explicit(&slot->seq, memory_order_acquire) == seq) {
+                trace_print(&copy);
+            } else {
+                atomic_fetch_add(&trace_lost, 1);
+            }
+            trace_tail++;
+        }
+    }
+}
+
+// ====== Public API ======
+void trace_init(void)
+{
+    for (int i = 0; i < TRACE_MOD_COUNT; i++) {
+        trace_levels[i] = ESP_LOG_INFO;
+    }
+
+    if (xTaskCreateStatic(trace_task, "Trace", TRACE_TASK_STACK, NULL, TRACE_TASK_PRIORITY,
+                          trace_task_stack, &trace_task_buf) == NULL) {
+        ESP_LOGE(TAG, "Failed to create trace drain task");
+        abort();
+    }
+    ESP_LOGI(TAG, "Trace ring: %d records, drained every %d ms", TRACE_RING_SIZE, TRACE_DRAIN_PERIOD_MS);
+}
+
+void trace_write(trace_event_t event, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3, uint32_t a4)
+{
+    const trace_desc_t *desc = &trace_events[event];
+    if (desc->level > trace_levels[desc->module]) {
+        return;
+    }
+
+    uint32_t index = atomic_fetch_add_explicit(&trace_head, 1, memory_order_relaxed);
+    trace_record_t *slot = &trace_ring[index & TRACE_RING_MASK];
+
+    atomic_store_explicit(&slot->seq, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->ts_us = (uint32_t)esp_timer_get_time();
+    slot->event = event;
+    slot->args[0] = a0;
+    slot->args[1] = a1;
+    slot->args[2] = a2;
+    slot->args[3] = a3;
+    slot->args[4] = a4;
+    atomic_store_explicit(&slot->seq, index + 1, memory_order_release);
+}
+
+void trace_set_level(trace_module_t module, esp_log_level_t level)
+{
+    if (module < TRACE_MOD_COUNT) {
+        trace_levels[module] = level;
+        // The drain prints through ESP_LOG: keep the tag's log level in step
+        esp_log_level_set(trace_tags[module], level);
+    }
+}
+
+uint32_t trace_get_levels(void)
+{
+    uint32_t packed = 0;
+    for (int i = 0; i < TRACE_MOD_COUNT; i++) {
+        packed |= (uint32_t)(trace_levels[i] & 0x0F) << (i * TRACE_LEVEL_BITS);
+    }
+    return packed;
+}
+
+void trace_set_levels(uint32_t packed)
+{
+    for (int i = 0; i < TRACE_MOD_COUNT; i++) {
+        uint8_t level = (packed >> (i * TRACE_LEVEL_BITS)) & 0x0F;
+        trace_set_level((trace_module_t)i, level > ESP_LOG_VERBOSE ? ESP_LOG_VERBOSE : (esp_log_level_t)level);
+    }
+    ESP_LOGI(TAG, "Trace levels set to 0x%06" PRIx32, trace_get_levels());
+}
+
+uint32_t trace_dropped(void)
+{
+    return atomic_load(&trace_lost);
+}
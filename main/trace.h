@@ -0,0 +1,95 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <inttypes.h>
+#include "esp_log.h"
+
+/*
+Binary trace for the command hot path. A call records an event ID, a
+timestamp and up to TRACE_MAX_ARGS raw 32-bit arguments into a lock-free
+ring (one atomic add, no formatting, no lock, callable from ISRs). A low-priority
+drain task formats the records later and prints them through ESP_LOG with
+the module's tag. Verbosity is set per module at runtime.
+*/
+
+// ====== Trace Configuration ======
+#define TRACE_RING_SIZE 128            // Records, power of two
+#define TRACE_MAX_ARGS 5
+#define TRACE_DRAIN_PERIOD_MS 50
+#define TRACE_TASK_STACK 3072
+#define TRACE_TASK_PRIORITY 1          // Only above idle: printing never delays real work
+#define TRACE_LEVEL_BITS 4             // Packed levels: 4 bits per module
+
+// Modules: name = log tag of the module emitting the events
+#define TRACE_MODULES(X) \
+    X(ZIGBEE,  "ZIGBEE")  \
+    X(BUTTONS, "BUTTONS") \
+    X(PRESS,   "PRESS")   \
+    X(RF,      "RF_TX")   \
+    X(CAME,    "CAME433") \
+    X(LATENCY, "LATENCY")
+
+// Events: name, module, level, format (one uint32_t per conversion)
+#define TRACE_EVENTS(X) \
+    X(ZCL_CMD,        ZIGBEE,  ESP_LOG_DEBUG, "Command received: cluster=0x%04" PRIx32 ", cmd=0x%02" PRIx32 ", endpoint=%" PRIu32) \
+    X(ON_OFF_CMD,     ZIGBEE,  ESP_LOG_INFO,  "On/Off command (on/toggle) on endpoint %" PRIu32) \
+    X(ATTR_WRITE,     ZIGBEE,  ESP_LOG_DEBUG, "Attribute write: cluster=0x%04" PRIx32 ", attr=0x%04" PRIx32 ", endpoint=%" PRIu32) \
+    X(ON_OFF_WRITE,   ZIGBEE,  ESP_LOG_INFO,  "On/Off value changed on endpoint %" PRIu32) \
+    X(ON_OFF_RESET,   ZIGBEE,  ESP_LOG_DEBUG, "EP%" PRIu32 " on_off attribute reset to false") \
+    X(PRESS_EVENT,    ZIGBEE,  ESP_LOG_INFO,  "EP%" PRIu32 " press event #%" PRIu32 " sent") \
+    X(ACTION_TIME,    ZIGBEE,  ESP_LOG_DEBUG, "Action 0x%" PRIx32 " handled in %" PRIu32 " us") \
+    X(BUTTON_CLICK,   BUTTONS, ESP_LOG_INFO,  "Button EP%" PRIu32 " clicked (protocol %" PRIu32 ", code 0x%06" PRIX32 ")") \
+    X(CODE_CLICK,     BUTTONS, ESP_LOG_INFO,  "EP%" PRIu32 " sends code book entry %" PRIu32 " (code 0x%06" PRIX32 ")") \
+    X(DUP_TSN,        PRESS,   ESP_LOG_DEBUG, "EP%" PRIu32 ": duplicate trigger dropped (tsn %" PRIu32 ")") \
+    X(MERGED,         PRESS,   ESP_LOG_DEBUG, "EP%" PRIu32 ": press merged into the active burst") \
+    X(CAME_SEND,      CAME,    ESP_LOG_INFO,  "TX%" PRIu32 ": sending protocol %" PRIu32 " code: 0x%06" PRIX32 " (%" PRIu32 " repeats)") \
+    X(CAME_SEQUENCE,  CAME,    ESP_LOG_INFO,  "TX%" PRIu32 ": sending a %" PRIu32 "-step sequence (%" PRIu32 " us on air)") \
+    X(RF_DONE,        RF,      ESP_LOG_INFO,  "EP%" PRIu32 " RF done: 0x%" PRIx32 ", queued %" PRIu32 " us, on air %" PRIu32 " us") \
+    X(RF_THROTTLED,   RF,      ESP_LOG_DEBUG, "TX%" PRIu32 ": duty-cycle budget reached, next burst in %" PRIu32 " ms") \
+    X(RF_DUTY,        RF,      ESP_LOG_DEBUG, "TX%" PRIu32 " duty cycle %" PRIu32 " bp, queue wait avg %" PRIu32 " us / max %" PRIu32 " us, %" PRIu32 " queued") \
+    X(LAT_SAMPLE,     LATENCY, ESP_LOG_DEBUG, "EP%" PRIu32 ": dispatch %" PRIu32 ", queue %" PRIu32 ", start %" PRIu32 ", air %" PRIu32 " us")
+
+#define TRACE_MOD_ENUM(name, tag) TRACE_MOD_##name,
+typedef enum {
+    TRACE_MODULES(TRACE_MOD_ENUM)
+    TRACE_MOD_COUNT
+} trace_module_t;
+#undef TRACE_MOD_ENUM
+
+#define TRACE_EV_ENUM(name, mod, level, fmt) TRACE_EV_##name,
+typedef enum {
+    TRACE_EVENTS(TRACE_EV_ENUM)
+    TRACE_EV_COUNT
+} trace_event_t;
+#undef TRACE_EV_ENUM
+
+// ====== Function Prototypes ======
+void trace_init(void);
+
+/**
+ * @brief Record an event if its module level allows it (any task or ISR)
+ */
+void trace_write(trace_event_t event, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3, uint32_t a4);
+
+#define TRACE0(event) trace_write(TRACE_EV_##event, 0, 0, 0, 0, 0)
+#define TRACE1(event, a0) trace_write(TRACE_EV_##event, (a0), 0, 0, 0, 0)
+#define TRACE2(event, a0, a1) trace_write(TRACE_EV_##event, (a0), (a1), 0, 0, 0)
+#define TRACE3(event, a0, a1, a2) trace_write(TRACE_EV_##event, (a0), (a1), (a2), 0, 0)
+#define TRACE4(event, a0, a1, a2, a3) trace_write(TRACE_EV_##event, (a0), (a1), (a2), (a3), 0)
+#define TRACE5(event, a0, a1, a2, a3, a4) trace_write(TRACE_EV_##event, (a0), (a1), (a2), (a3), (a4))
+
+void trace_set_level(trace_module_t module, esp_log_level_t level);
+
+/**
+ * @brief All module levels packed TRACE_LEVEL_BITS each, module 0 in the low bits
+ */
+uint32_t trace_get_levels(void);
+void trace_set_levels(uint32_t packed);
+
+/**
+ * @brief Records lost because the drain could not keep up
+ */
+uint32_t trace_dropped(void);
+
+#endif // TRACE_H
@@ -0,0 +1,44 @@
+#include "zb_capacity.h"
+#include "diagnostics.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_zigbee_core.h"
+
+static const char *TAG = "ZB_CAP";
+
+static uint32_t heap_before_init = 0;
+static uint32_t stack_heap = 0;
+
+// ====== Public API ======
+void zb_capacity_apply(void)
+{
+    ESP_ERROR_CHECK(esp_zb_overall_network_size_set(ZB_CAP_NETWORK_SIZE));
+    ESP_ERROR_CHECK(esp_zb_io_buffer_size_set(ZB_CAP_IO_BUFFERS));
+    ESP_ERROR_CHECK(esp_zb_scheduler_queue_size_set(ZB_CAP_SCHED_QUEUE));
+    esp_zb_aps_src_binding_table_size_set(ZB_CAP_BINDINGS);
+    esp_zb_aps_dst_binding_table_size_set(ZB_CAP_BINDINGS);
+
+    heap_before_init = esp_get_free_heap_size();
+}
+
+void zb_capacity_report(void)
+{
+    uint32_t heap_after = esp_get_free_heap_size();
+    stack_heap = heap_before_init > heap_after ? heap_before_init - heap_after : 0;
+
+    ESP_LOGI(TAG, "Capacity profile \"%s\": %d children, network size %d, %d IO buffers, "
+             "scheduler queue %d, bindings %d/%d", ZB_CAP_PROFILE_NAME, ZB_CAP_MAX_CHILDREN, ZB_CAP_NETWORK_SIZE,
+             ZB_CAP_IO_BUFFERS, ZB_CAP_SCHED_QUEUE, ZB_CAP_BINDINGS, ZB_CAP_BINDINGS);
+    // The stack allocates all its pools in one go: only the total is measurable from here
+    ESP_LOGI(TAG, "  Zigbee stack pools (esp_zb_init): %lu bytes of heap", (unsigned long)stack_heap);
+    ESP_LOGI(TAG, "  Neighbor snapshot (%d entries): %u bytes", ZB_CAP_TRACK_NEIGHBORS,
+             (unsigned)diagnostics_neighbor_ram());
+    ESP_LOGI(TAG, "  Route snapshot (%d entries): %u bytes", ZB_CAP_TRACK_ROUTES,
+             (unsigned)diagnostics_route_ram());
+    ESP_LOGI(TAG, "  Heap left: %lu bytes", (unsigned long)heap_after);
+}
+
+uint32_t zb_capacity_stack_heap(void)
+{
+    return stack_heap;
+}
@@ -0,0 +1,49 @@
+#ifndef ZB_CAPACITY_H
+#define ZB_CAPACITY_H
+
+#include <stdint.h>
+#include "sdkconfig.h"
+
+/*
+Router capacity profile: one Kconfig choice (ZB433_CAPACITY_*) sizes every
+Zigbee pool consistently, children, network size, buffers, scheduler queue,
+binding tables, and the neighbor/route snapshots the diagnostics keep.
+The stack allocates all its pools in one go inside esp_zb_init(): only
+their total heap is measurable, logged with the configured sizes and the
+RAM of the diagnostics snapshots.
+*/
+
+// ====== Capacity Configuration ======
+#define ZB_CAP_PROFILE_NAME CONFIG_ZB433_CAPACITY_NAME
+#define ZB_CAP_MAX_CHILDREN CONFIG_ZB433_CAPACITY_MAX_CHILDREN
+#define ZB_CAP_NETWORK_SIZE CONFIG_ZB433_CAPACITY_NETWORK_SIZE      // Address/neighbor pool sizing
+#define ZB_CAP_IO_BUFFERS CONFIG_ZB433_CAPACITY_IO_BUFFERS          // NWK/APS frame buffers
+#define ZB_CAP_SCHED_QUEUE CONFIG_ZB433_CAPACITY_SCHED_QUEUE        // Stack scheduler callbacks
+#define ZB_CAP_BINDINGS CONFIG_ZB433_CAPACITY_BINDINGS              // APS source and destination tables
+#define ZB_CAP_TRACK_NEIGHBORS CONFIG_ZB433_CAPACITY_TRACK_NEIGHBORS // Diagnostics snapshot
+#define ZB_CAP_TRACK_ROUTES CONFIG_ZB433_CAPACITY_TRACK_ROUTES
+
+// Table capacities inside the stack, what "table full" is measured against.
+// esp_zb_overall_network_size_set() sizes both the neighbor and the routing
+// table; the children are a share of the neighbor table.
+#define ZB_CAP_STACK_NEIGHBORS ZB_CAP_NETWORK_SIZE
+#define ZB_CAP_STACK_ROUTES ZB_CAP_NETWORK_SIZE
+#define ZB_CAP_STACK_CHILDREN ZB_CAP_MAX_CHILDREN
+
+// ====== Function Prototypes ======
+/**
+ * @brief Size the stack pools from the profile (Zigbee task, right before esp_zb_init)
+ */
+void zb_capacity_apply(void);
+
+/**
+ * @brief Log the total heap taken by esp_zb_init and the snapshot RAM (right after it)
+ */
+void zb_capacity_report(void);
+
+/**
+ * @brief Heap allocated by esp_zb_init() for the stack pools, in bytes
+ */
+uint32_t zb_capacity_stack_heap(void);
+
+#endif // ZB_CAPACITY_H
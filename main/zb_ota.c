@@ -0,0 +1,262 @@
+#include "zb_ota.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_ota_ops.h"
+#include "esp_zigbee_core.h"
+#include "zcl/esp_zigbee_zcl_ota.h"
+#include <inttypes.h>
+#include <string.h>
+
+static const char *TAG = "ZB_OTA";
+
+#define ZB_OTA_TAG_HEADER_SIZE 6           // Sub-element: tag id U16 + length U32, little endian
+#define ZB_OTA_PROGRESS_STEP 10            // Log every 10 %
+
+static esp_ota_handle_t ota_handle = 0;
+static const esp_partition_t *ota_partition = NULL;
+static uint32_t ota_image_size = 0;
+static uint32_t ota_received = 0;
+static uint32_t ota_written = 0;
+static uint8_t ota_progress = 0;
+
+// Sub-element parser, fed block by block (a header may straddle two blocks)
+static uint8_t ota_tag_header[ZB_OTA_TAG_HEADER_SIZE];
+static uint8_t ota_tag_header_len = 0;
+static uint32_t ota_element_left = 0;
+static bool ota_element_write = false;
+
+// ====== Private Functions ======
+static void zb_ota_reset(void)
+{
+    ota_handle = 0;
+    ota_partition = NULL;
+    ota_received = 0;
+    ota_written = 0;
+    ota_progress = 0;
+    ota_tag_header_len = 0;
+    ota_element_left = 0;
+    ota_element_write = false;
+}
+
+static esp_err_t zb_ota_begin(const esp_zb_zcl_ota_upgrade_header_t *header)
+{
+    if (ota_handle != 0) {
+        esp_ota_abort(ota_handle);
+        zb_ota_reset();
+    }
+    if (header->manufacturer_code != ZB_OTA_MANUFACTURER || header->image_type != ZB_OTA_IMAGE_TYPE) {
+        ESP_LOGW(TAG, "Image 0x%04x/0x%04x is not for this device", header->manufacturer_code, header->image_type);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ota_partition = esp_ota_get_next_update_partition(NULL);
+    if (ota_partition == NULL) {
+        ESP_LOGE(TAG, "No OTA partition to write to");
+        return ESP_ERR_NOT_FOUND;
+    }
+    // Sequential writes: sectors are erased one at a time as blocks arrive, never the whole slot at once
+    esp_err_t ret = esp_ota_begin(ota_partition, OTA_WITH_SEQUENTIAL_WRITES, &ota_handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_begin failed: %s", esp_err_to_name(ret));
+        zb_ota_reset();
+        return ret;
+    }
+    ota_image_size = header->image_size;
+    ESP_LOGI(TAG, "Downloading version 0x%08" PRIx32 " (%" PRIu32 " bytes) to %s, %d-byte blocks every %d ms",
+             header->file_version, header->image_size, ota_partition->label, ZB_OTA_BLOCK_SIZE, ZB_OTA_BLOCK_PERIOD_MS);
+    return ESP_OK;
+}
+
+/**
+ * @brief Split one block into sub-element headers and data, write the upgrade image data
+ */
+static esp_err_t zb_ota_receive(const uint8_t *data, uint16_t size)
+{
+    while (size > 0) {
+        if (ota_element_left == 0) {
+            // Collect the next sub-element header
+            uint16_t take = ZB_OTA_TAG_HEADER_SIZE - ota_tag_header_len;
+            take = take < size ? take : size;
+            memcpy(&ota_tag_header[ota_tag_header_len], data, take);
+            ota_tag_header_len += take;
+            data += take;
+            size -= take;
+            if (ota_tag_header_len < ZB_OTA_TAG_HEADER_SIZE) {
+                break;
+            }
+            uint16_t tag = ota_tag_header[0] | (uint16_t)ota_tag_header[1] << 8;
+            ota_element_left = ota_tag_header[2] | (uint32_t)ota_tag_header[3] << 8 |
+                               (uint32_t)ota_tag_header[4] << 16 | (uint32_t)ota_tag_header[5] << 24;
+            ota_element_write = tag == ZB_OTA_TAG_UPGRADE_IMAGE;
+            ota_tag_header_len = 0;
+            if (!ota_element_write) {
+                ESP_LOGI(TAG, "Skipping sub-element 0x%04x (%" PRIu32 " bytes)", tag, ota_element_left);
+            }
+            continue;
+        }
+
+        uint32_t chunk = ota_element_left < size ? ota_element_left : size;
+        if (ota_element_write) {
+            esp_err_t ret = esp_ota_write(ota_handle, data, chunk);
+            if (ret != ESP_OK) {
+                ESP_LOGE(TAG, "esp_ota_write failed at %" PRIu32 ": %s", ota_written, esp_err_to_name(ret));
+                return ret;
+            }
+            ota_written += chunk;
+        }
+        ota_element_left -= chunk;
+        data += chunk;
+        size -= chunk;
+    }
+    return ESP_OK;
+}
+
+static void zb_ota_log_progress(void)
+{
+    if (ota_image_size == 0) {
+        return;
+    }
+    uint8_t percent = (uint8_t)((uint64_t)ota_received * 100 / ota_image_size);
+    if (percent >= ota_progress + ZB_OTA_PROGRESS_STEP) {
+        ota_progress = percent - percent % ZB_OTA_PROGRESS_STEP;
+        ESP_LOGI(TAG, "%d%% (%" PRIu32 "/%" PRIu32 " bytes)", ota_progress, ota_received, ota_image_size);
+    }
+}
+
+/**
+ * @brief Download finished: check the image before it can become the boot partition
+ */
+static esp_err_t zb_ota_verify(void)
+{
+    if (ota_handle == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (ota_element_left != 0 || ota_tag_header_len != 0 || ota_written == 0) {
+        ESP_LOGE(TAG, "Truncated image (%" PRIu32 " bytes written)", ota_written);
+        esp_ota_abort(ota_handle);
+        zb_ota_reset();
+        return ESP_ERR_INVALID_SIZE;
+    }
+    // Checks the app header, segments and SHA-256 (and the signature with secure boot)
+    esp_err_t ret = esp_ota_end(ota_handle);
+    ota_handle = 0;
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Image rejected: %s", esp_err_to_name(ret));
+        zb_ota_reset();
+        return ret;
+    }
+    ESP_LOGI(TAG, "Image verified (%" PRIu32 " bytes)", ota_written);
+    return ESP_OK;
+}
+
+static void zb_ota_reboot_cb(uint8_t param)
+{
+    ESP_LOGW(TAG, "Rebooting into the new firmware");
+    esp_restart();
+}
+
+static esp_err_t zb_ota_apply(void)
+{
+    if (ota_partition == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = esp_ota_set_boot_partition(ota_partition);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "esp_ota_set_boot_partition failed: %s", esp_err_to_name(ret));
+        zb_ota_reset();
+        return ret;
+    }
+    ESP_LOGI(TAG, "Next boot from %s", ota_partition->label);
+    esp_zb_scheduler_alarm(zb_ota_reboot_cb, 0, ZB_OTA_REBOOT_DELAY_MS);
+    return ESP_OK;
+}
+
+// ====== Public API ======
+void zb_ota_add_cluster(esp_zb_cluster_list_t *clusters)
+{
+    esp_zb_ota_cluster_cfg_t ota_cfg = {
+        .ota_upgrade_file_version = ZB_OTA_FILE_VERSION,
+        .ota_upgrade_downloaded_file_ver = ZB_OTA_FILE_VERSION,
+        .ota_upgrade_manufacturer = ZB_OTA_MANUFACTURER,
+        .ota_upgrade_image_type = ZB_OTA_IMAGE_TYPE,
+    };
+    esp_zb_attribute_list_t *ota_attr_list = esp_zb_ota_cluster_create(&ota_cfg);
+
+    esp_zb_zcl_ota_upgrade_client_variable_t client_cfg = {
+        .timer_query = ZB_OTA_QUERY_MIN,
+        .hw_version = ZB_OTA_HW_VERSION,
+        .max_data_size = ZB_OTA_BLOCK_SIZE,
+    };
+    uint16_t server_addr = 0xFFFF;     // Discovered by the stack
+    uint8_t server_endpoint = 0xFF;
+    uint16_t block_period_ms = ZB_OTA_BLOCK_PERIOD_MS;
+    ESP_ERROR_CHECK(esp_zb_ota_cluster_add_attr(ota_attr_list, ESP_ZB_ZCL_ATTR_OTA_UPGRADE_CLIENT_DATA_ID, &client_cfg));
+    ESP_ERROR_CHECK(esp_zb_ota_cluster_add_attr(ota_attr_list, ESP_ZB_ZCL_ATTR_OTA_UPGRADE_SERVER_ADDR_ID, &server_addr));
+    ESP_ERROR_CHECK(esp_zb_ota_cluster_add_attr(ota_attr_list, ESP_ZB_ZCL_ATTR_OTA_UPGRADE_SERVER_ENDPOINT_ID, &server_endpoint));
+    // MinimumBlockPeriod: the server waits this long between two Image Block Responses
+    ESP_ERROR_CHECK(esp_zb_ota_cluster_add_attr(ota_attr_list, ESP_ZB_ZCL_ATTR_OTA_UPGRADE_MIN_BLOCK_PERIOD_ID, &block_period_ms));
+    ESP_ERROR_CHECK(esp_zb_cluster_list_add_ota_cluster(clusters, ota_attr_list, ESP_ZB_ZCL_CLUSTER_CLIENT_ROLE));
+}
+
+esp_err_t zb_ota_handle(const void *message)
+{
+    const esp_zb_zcl_ota_upgrade_value_message_t *msg = message;
+    esp_err_t ret = ESP_OK;
+
+    if (msg->info.status != ESP_ZB_ZCL_STATUS_SUCCESS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    switch (msg->upgrade_status) {
+    case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_START:
+        ret = zb_ota_begin(&msg->ota_header);
+        break;
+    case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_RECEIVE:
+        if (ota_handle == 0) {
+            return ESP_ERR_INVALID_STATE;
+        }
+        // Runs in the Zigbee task between gate commands: one block, straight to flash
+        ota_received += msg->payload_size;
+        if (msg->payload_size > 0 && msg->payload != NULL) {
+            ret = zb_ota_receive(msg->payload, msg->payload_size);
+        }
+        if (ret != ESP_OK) {
+            esp_ota_abort(ota_handle);
+            zb_ota_reset();
+        } else {
+            zb_ota_log_progress();
+        }
+        break;
+    case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_APPLY:
+        ESP_LOGI(TAG, "Download complete (%" PRIu32 " bytes)", ota_received);
+        break;
+    case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_CHECK:
+        ret = zb_ota_verify();
+        break;
+    case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_FINISH:
+        ret = zb_ota_apply();
+        break;
+    case ESP_ZB_ZCL_OTA_UPGRADE_STATUS_ABORT:
+        ESP_LOGW(TAG, "Upgrade aborted by the server after %" PRIu32 " bytes", ota_received);
+        if (ota_handle != 0) {
+            esp_ota_abort(ota_handle);
+        }
+        zb_ota_reset();
+        break;
+    default:
+        break;
+    }
+    return ret;
+}
+
+void zb_ota_confirm_image(void)
+{
+    esp_ota_img_states_t state;
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    if (esp_ota_get_state_partition(running, &state) != ESP_OK || state != ESP_OTA_IMG_PENDING_VERIFY) {
+        return;
+    }
+    if (esp_ota_mark_app_valid_cancel_rollback() == ESP_OK) {
+        ESP_LOGI(TAG, "Firmware in %s confirmed, rollback cancelled", running->label);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef ZB_OTA_H
+#define ZB_OTA_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_zigbee_cluster.h"
+#include "sdkconfig.h"
+
+/*
+Zigbee OTA Upgrade client (cluster 0x0019, first gate endpoint). Image
+blocks are written to the inactive ota_x partition as they arrive, nothing
+is buffered beyond one block. The server is asked for blocks of
+ZB_OTA_BLOCK_SIZE bytes no closer than ZB_OTA_BLOCK_PERIOD_MS apart, so a
+download never saturates the mesh. The image is verified (esp_ota_end)
+before it becomes the boot partition; the new firmware confirms itself once
+it is back on the network, otherwise the bootloader rolls back.
+*/
+
+// ====== OTA Configuration ======
+#define ZB_OTA_MANUFACTURER 0x131B                 // Espressif, the stack's node descriptor code
+#define ZB_OTA_IMAGE_TYPE 0x0433
+#define ZB_OTA_HW_VERSION 1
+#define ZB_OTA_FILE_VERSION CONFIG_ZB433_OTA_FILE_VERSION
+#define ZB_OTA_BLOCK_SIZE CONFIG_ZB433_OTA_BLOCK_SIZE
+#define ZB_OTA_BLOCK_PERIOD_MS CONFIG_ZB433_OTA_BLOCK_PERIOD_MS
+#define ZB_OTA_QUERY_MIN CONFIG_ZB433_OTA_QUERY_MIN    // Query Next Image interval
+#define ZB_OTA_REBOOT_DELAY_MS 2000                // Lets the Upgrade End exchange complete
+#define ZB_OTA_TAG_UPGRADE_IMAGE 0x0000            // Sub-element written to flash; others are skipped
+
+// ====== Function Prototypes ======
+/**
+ * @brief Add the OTA Upgrade client cluster to @p clusters (primary endpoint)
+ */
+void zb_ota_add_cluster(esp_zb_cluster_list_t *clusters);
+
+/**
+ * @brief OTA Upgrade value callback (Zigbee task, ESP_ZB_CORE_OTA_UPGRADE_VALUE_CB_ID)
+ *
+ * @return ESP_OK to continue, an error to make the stack abort the download
+ */
+esp_err_t zb_ota_handle(const void *message);
+
+/**
+ * @brief Confirm a freshly upgraded firmware once it is back on the network (cancels rollback)
+ */
+void zb_ota_confirm_image(void);
+
+#endif // ZB_OTA_H
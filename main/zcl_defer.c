@@ -0,0 +1,141 @@
+#include "zcl_defer.h"
+#include "esp_log.h"
+#include "esp_zigbee_core.h"
+#include "freertos/FreeRTOS.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+
+static const char *TAG = "ZCL_DEFER";
+
+_Static_assert(ZCL_DEFER_SLOTS <= 32, "pending mask is 32 bits");
+
+typedef struct {
+    atomic_uint_fast32_t seq;       // Odd while a producer is copying the value
+    bool used;                      // Key below is set (never released)
+    uint8_t endpoint;
+    uint16_t cluster_id;
+    uint16_t attr_id;
+    uint8_t size;
+    uint8_t value[ZCL_DEFER_VALUE_MAX];
+} zcl_defer_slot_t;
+
+static zcl_defer_slot_t defer_slots[ZCL_DEFER_SLOTS];
+static atomic_uint_fast32_t defer_pending = 0;      // One bit per slot with an unapplied value
+static portMUX_TYPE defer_lock = portMUX_INITIALIZER_UNLOCKED;    // Producers only
+static uint32_t defer_posted = 0;
+static uint32_t defer_applied = 0;
+
+// ====== Private Functions ======
+/**
+ * @brief Slot holding this attribute, claiming a free one if needed (caller holds defer_lock)
+ */
+static int zcl_defer_slot(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id)
+{
+    int free_slot = -1;
+
+    for (int i = 0; i < ZCL_DEFER_SLOTS; i++) {
+        const zcl_defer_slot_t *slot = &defer_slots[i];
+        if (!slot->used) {
+            if (free_slot < 0) {
+                free_slot = i;
+            }
+            continue;
+        }
+        if (slot->endpoint == endpoint && slot->cluster_id == cluster_id && slot->attr_id == attr_id) {
+            return i;
+        }
+    }
+    if (free_slot >= 0) {
+        zcl_defer_slot_t *slot = &defer_slots[free_slot];
+        slot->endpoint = endpoint;
+        slot->cluster_id = cluster_id;
+        slot->attr_id = attr_id;
+        slot->used = true;
+    }
+    return free_slot;
+}
+
+/**
+ * @brief Copy a consistent snapshot of @p slot (Zigbee task, retries while a producer writes)
+ */
+static uint8_t zcl_defer_read(zcl_defer_slot_t *slot, uint8_t *value)
+{
+    uint32_t start;
+    uint8_t size;
+
+    do {
+        start = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        size = slot->size;
+        memcpy(value, slot->value, size);
+        atomic_thread_fence(memory_order_acquire);
+    } while ((start & 1) || atomic_load_explicit(&slot->seq, memory_order_relaxed) != start);
+    return size;
+}
+
+/**
+ * @brief Apply every pending update, then re-arm (Zigbee task, scheduler alarm)
+ *
+ * Polls at ZCL_DEFER_BATCH_MS while updates keep coming, ZCL_DEFER_IDLE_MS
+ * once a drain finds nothing.
+ */
+static void zcl_defer_drain_cb(uint8_t param)
+{
+    uint32_t pending = atomic_exchange(&defer_pending, 0);
+    uint8_t value[ZCL_DEFER_VALUE_MAX];
+
+    esp_zb_scheduler_alarm(zcl_defer_drain_cb, 0, pending != 0 ? ZCL_DEFER_BATCH_MS : ZCL_DEFER_IDLE_MS);
+
+    while (pending != 0) {
+        int i = __builtin_ctz(pending);
+        pending &= pending - 1;
+
+        zcl_defer_slot_t *slot = &defer_slots[i];
+        zcl_defer_read(slot, value);
+        esp_zb_zcl_status_t status = esp_zb_zcl_set_attribute_val(slot->endpoint, slot->cluster_id,
+                                                                  ESP_ZB_ZCL_CLUSTER_SERVER_ROLE,
+                                                                  slot->attr_id, value, false);
+        if (status != ESP_ZB_ZCL_STATUS_SUCCESS) {
+            ESP_LOGW(TAG, "EP%d: attribute 0x%04x/0x%04x update failed (0x%x)",
+                     slot->endpoint, slot->cluster_id, slot->attr_id, status);
+        }
+        defer_applied++;
+    }
+    ESP_LOGD(TAG, "%lu updates posted, %lu applied", (unsigned long)defer_posted, (unsigned long)defer_applied);
+}
+
+// ====== Public API ======
+void zcl_defer_start(void)
+{
+    esp_zb_scheduler_alarm(zcl_defer_drain_cb, 0, ZCL_DEFER_IDLE_MS);
+}
+
+esp_err_t zcl_defer_set(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id, const void *value, size_t size)
+{
+    if (size > ZCL_DEFER_VALUE_MAX) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    // Producers serialize among themselves for the length of one copy; the drain never takes this lock
+    portENTER_CRITICAL(&defer_lock);
+    int i = zcl_defer_slot(endpoint, cluster_id, attr_id);
+    if (i >= 0) {
+        zcl_defer_slot_t *slot = &defer_slots[i];
+        atomic_fetch_add_explicit(&slot->seq, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        slot->size = size;
+        memcpy(slot->value, value, size);
+        atomic_fetch_add_explicit(&slot->seq, 1, memory_order_release);
+        defer_posted++;
+    }
+    portEXIT_CRITICAL(&defer_lock);
+
+    if (i < 0) {
+        ESP_LOGW(TAG, "EP%d: no slot left for attribute 0x%04x/0x%04x", endpoint, cluster_id, attr_id);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Picked up by the next drain; never touches the stack lock
+    atomic_fetch_or(&defer_pending, 1UL << i);
+    return ESP_OK;
+}
@@ -0,0 +1,42 @@
+#ifndef ZCL_DEFER_H
+#define ZCL_DEFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "gates.h"
+
+/*
+Deferred ZCL attribute updates: any task posts the new value of a server
+attribute, the Zigbee task applies it later in one batch. The drain is a
+scheduler alarm armed once by zcl_defer_start() that re-arms itself from
+the Zigbee task, so producers only set a pending bit and never take the
+stack lock. Each attribute has one slot holding only its latest value, so
+repeated updates between two drains coalesce. The Zigbee task reads slots
+under a sequence counter and never waits on a producer.
+*/
+
+// ====== Defer Configuration ======
+#define ZCL_DEFER_SLOTS (GATE_MAX + 4)     // Distinct attributes with an update in flight
+#define ZCL_DEFER_VALUE_MAX 104            // Largest value (octet string length byte included)
+#define ZCL_DEFER_BATCH_MS 20              // Drain period while updates keep coming
+#define ZCL_DEFER_IDLE_MS 250              // Drain period once a drain found nothing (worst added delay)
+
+// ====== Function Prototypes ======
+/**
+ * @brief Arm the self re-arming drain alarm (Zigbee task, once, after the endpoints are registered)
+ */
+void zcl_defer_start(void);
+
+/**
+ * @brief Post a server attribute value, applied in the Zigbee task (any task, never blocks on the drain)
+ *
+ * @p value is copied. A newer post for the same attribute replaces one that
+ * has not been applied yet.
+ *
+ * @return ESP_ERR_INVALID_SIZE if @p size exceeds ZCL_DEFER_VALUE_MAX,
+ *         ESP_ERR_NO_MEM if every slot holds another attribute
+ */
+esp_err_t zcl_defer_set(uint8_t endpoint, uint16_t cluster_id, uint16_t attr_id, const void *value, size_t size);
+
+#endif // ZCL_DEFER_H
@@ -1,10 +1,22 @@
 #include "zigbee.h"
 #include "endpoints.h"
+#include "gates.h"
+#include "press_filter.h"
 #include "led.h"
+#include "diagnostics.h"
+#include "mfr_cluster.h"
+#include "zcl_defer.h"
+#include "trace.h"
+#include "boot_timeline.h"
+#include "nwk_hint.h"
+#include "zb_capacity.h"
+#include "heap_guard.h"
+#include "zb_ota.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/timers.h"
 #include "zcl/esp_zigbee_zcl_command.h"
 #include "aps/esp_zigbee_aps.h"
 #include "zcl/esp_zigbee_zcl_identify.h"
@@ -12,28 +24,41 @@
 
 static const char *TAG = "ZIGBEE";
 
-// Timers pour reset l'état on_off après 5 secondes (debounce)
-static TimerHandle_t reset_timer_ep1 = NULL;
-static TimerHandle_t reset_timer_ep2 = NULL;
+static StaticTask_t zigbee_task_buf;
+static StackType_t zigbee_task_stack[ZIGBEE_TASK_STACK];
+
+#define ZB_RETRY_MIN_MS 100        // First commissioning retry: a rebooted parent may answer quickly
+#define ZB_RETRY_MAX_MS 30000      // Backoff cap (doubling from ZB_RETRY_MIN_MS)
 
 // Identify notify (called by stack on Identify start/stop)
 static void identify_notify_cb(uint8_t identify_on)
 {
     ESP_LOGI(TAG, "Identify notify: %s", identify_on ? "start" : "stop");
     if (identify_on) {
-        led_identify_breathe();
+        // Breathe until the stack reports the end of the identify period
+        led_identify_breathe(0);
     } else {
         led_identify_okay();
     }
 }
 
-// Callback pour reset l'attribut on_off à false après 5 secondes
-static void reset_on_off_timer_callback(TimerHandle_t xTimer)
+/*
+Presses are reported as events (ZB433 "press" notification, mfr_cluster.c):
+one frame per press. The on_off attribute is only kept momentary so reads
+never show a stale "on"; it is cleared as soon as the stack has applied the
+command, and the converter disables its reporting. One alarm per gate at a
+time: a burst of triggers before it runs needs a single clear.
+*/
+static bool on_off_reset_pending[GATE_MAX];    // Zigbee task only
+
+// Scheduler alarm, runs in the Zigbee task right after the On/Toggle command was applied
+static void reset_on_off_cb(uint8_t endpoint)
 {
-    uint8_t endpoint = (uint8_t)pvTimerGetTimerID(xTimer);
-    
-    ESP_LOGI(TAG, "Resetting on_off attribute to false on endpoint %d", endpoint);
-    
+    int index = gates_index(endpoint);
+    if (index >= 0 && index < GATE_MAX) {
+        on_off_reset_pending[index] = false;
+    }
+
     // Remettre l'attribut on_off à false
     uint8_t on_off_value = 0; // false
     esp_err_t ret = esp_zb_zcl_set_attribute_val(
@@ -48,71 +73,102 @@ static void reset_on_off_timer_callback(TimerHandle_t xTimer)
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to reset on_off attribute on endpoint %d: %s", endpoint, esp_err_to_name(ret));
     } else {
-        ESP_LOGI(TAG, "Successfully reset on_off attribute on endpoint %d", endpoint);
+        TRACE1(ON_OFF_RESET, endpoint);
     }
 }
 
-// Fonction pour lancer/relancer le timer de reset (avec debounce)
-static void start_reset_timer(uint8_t endpoint)
+// Trigger the gate mapped to this endpoint (direct-indexed, no per-gate branches)
+static void handle_on_off_trigger(uint8_t endpoint, const press_key_t *key, int64_t arrival_us)
 {
-    TimerHandle_t *timer = (endpoint == BUTTON_1_ENDPOINT) ? &reset_timer_ep1 : &reset_timer_ep2;
-    
-    // Si le timer existe déjà, le relancer (debounce)
-    if (*timer != NULL) {
-        xTimerReset(*timer, 0);
-        ESP_LOGD(TAG, "Reset timer restarted for endpoint %d", endpoint);
-    } else {
-        // Créer le timer s'il n'existe pas encore
-        *timer = xTimerCreate(
-            endpoint == BUTTON_1_ENDPOINT ? "ResetEP1" : "ResetEP2",
-            pdMS_TO_TICKS(5000),  // 5 secondes
-            pdFALSE,              // One-shot timer
-            (void *)(uintptr_t)endpoint,  // Timer ID = endpoint
-            reset_on_off_timer_callback
-        );
-        
-        if (*timer == NULL) {
-            ESP_LOGE(TAG, "Failed to create reset timer for endpoint %d", endpoint);
-            return;
+    if (gates_get(endpoint) == NULL) {
+        ESP_LOGW(TAG, "Unknown endpoint clicked: %d", endpoint);
+        return;
+    }
+
+    // Duplicated deliveries and presses during an active burst cost no airtime (traced by the filter)
+    if (press_filter_check(endpoint, key) == PRESS_ACCEPT) {
+        // Only a press that reached the RF queue is notified
+        if (handle_button_click(endpoint, arrival_us) == ESP_OK) {
+            mfr_cluster_send_press(endpoint);
         }
-        
-        xTimerStart(*timer, 0);
-        ESP_LOGD(TAG, "Reset timer started for endpoint %d", endpoint);
     }
+    // Deferred: the stack writes on_off = true after this callback returns
+    int index = gates_index(endpoint);
+    if (index >= 0 && index < GATE_MAX && !on_off_reset_pending[index]) {
+        on_off_reset_pending[index] = true;
+        esp_zb_scheduler_alarm(reset_on_off_cb, endpoint, 0);
+    }
+}
+
+// Commissioning retries: short first, doubling up to ZB_RETRY_MAX_MS, reset once on the network.
+// The wait is drawn in [delay/2, delay] so routers rebooted together do not beacon in lockstep.
+static uint32_t zb_retry_delay_ms = ZB_RETRY_MIN_MS;
+
+static uint32_t zb_next_retry_ms(void)
+{
+    uint32_t delay = zb_retry_delay_ms;
+    zb_retry_delay_ms = delay * 2 > ZB_RETRY_MAX_MS ? ZB_RETRY_MAX_MS : delay * 2;
+    boot_retry();
+    return delay / 2 + esp_random() % (delay / 2 + 1);
+}
+
+// The network is usable: gates can be controlled from here on
+static void zb_network_ready(void)
+{
+    zb_retry_delay_ms = ZB_RETRY_MIN_MS;
+    nwk_hint_update();
+    if (boot_mark_us(BOOT_MARK_READY) != 0) {
+        return;
+    }
+    boot_mark(BOOT_MARK_READY);
+    ESP_LOGI(TAG, "Network ready %" PRIu32 " ms after boot", boot_mark_us(BOOT_MARK_READY) / 1000);
+    boot_timeline_dump();
+    mfr_cluster_publish_boot_timeline();
+    zb_ota_confirm_image();
+    heap_guard_arm();
 }
 
 // ====== Zigbee Task ======
 // Match working example pattern: all initialization inside task + blocking main loop
 static void zigbee_task(void *pvParameters)
 {
+    boot_mark(BOOT_MARK_ZB_TASK);
     ESP_LOGI(TAG, "Starting Zigbee task...");
 
-    // Initialize Zigbee stack with standard router config (like working example)
+    // Initialize Zigbee stack as a router, tables sized by the capacity profile
     esp_zb_cfg_t zb_cfg = {
         .esp_zb_role = ESP_ZB_DEVICE_TYPE_ROUTER,
         .install_code_policy = false,
         .nwk_cfg.zczr_cfg = {
-            .max_children = 10,
+            .max_children = ZB_CAP_MAX_CHILDREN,
         },
     };
+    zb_capacity_apply();
     esp_zb_init(&zb_cfg);
+    zb_capacity_report();
 
     // Create and register endpoints
     create_endpoints();
+    zcl_defer_start();
 
-    // Register Identify notify handler for both endpoints
-    esp_zb_identify_notify_handler_register(BUTTON_1_ENDPOINT, identify_notify_cb);
-    esp_zb_identify_notify_handler_register(BUTTON_2_ENDPOINT, identify_notify_cb);
+    // Register Identify notify handler of every gate endpoint
+    for (int i = 0; i < gates_count(); i++) {
+        esp_zb_identify_notify_handler_register(gates_endpoint(i), identify_notify_cb);
+    }
 
     // Register action handler
     esp_zb_core_action_handler_register(zb_action_handler);
 
-    // Set channels to scan for networks (use same mask as working example)
-    esp_zb_set_primary_network_channel_set(ESP_ZB_TRANSCEIVER_ALL_CHANNELS_MASK);
+    // Health attributes: default reporting + periodic sampling in this task
+    diagnostics_start();
+
+    // Steering scans the last good channel first, then all channels
+    nwk_hint_apply();
 
     // Start Zigbee stack with autostart=false (commissioning via signal handler)
     ESP_LOGI(TAG, "Starting Zigbee stack (autostart=false)");
     ESP_ERROR_CHECK(esp_zb_start(false));
+    boot_mark(BOOT_MARK_ZB_START);
 
     // Run blocking main loop (like working example)
     ESP_LOGI(TAG, "Entering Zigbee main loop (blocking)");
@@ -124,10 +180,6 @@ void zigbee_init(void)
 {
     ESP_LOGI(TAG, "Initializing Zigbee router...");
 
-    // Enable verbose logging for debugging
-    esp_log_level_set("*", ESP_LOG_DEBUG);
-    esp_log_level_set("ZIGBEE", ESP_LOG_DEBUG);
-
     // Platform configuration for ESP32-C6 (native Zigbee)
     esp_zb_platform_config_t config = {
         .radio_config = {
@@ -140,7 +192,8 @@ void zigbee_init(void)
     ESP_ERROR_CHECK(esp_zb_platform_config(&config));
 
     // Create Zigbee task (all stack init happens inside task, like working example)
-    xTaskCreate(zigbee_task, "Zigbee_main", 4096, NULL, 5, NULL);
+    xTaskCreateStatic(zigbee_task, "Zigbee_main", ZIGBEE_TASK_STACK, NULL, ZIGBEE_TASK_PRIORITY,
+                      zigbee_task_stack, &zigbee_task_buf);
 
     ESP_LOGI(TAG, "Zigbee task created");
 }
@@ -165,25 +218,30 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct)
     switch (sig_type) {
     case ESP_ZB_ZDO_SIGNAL_SKIP_STARTUP:
         ESP_LOGI(TAG, "Initialize Zigbee stack");
+        boot_mark(BOOT_MARK_SKIP_STARTUP);
+        led_set_color(255, 64, 0); // Stack up, waiting for the network
         esp_zb_bdb_start_top_level_commissioning(ESP_ZB_BDB_MODE_INITIALIZATION);
         break;
 
     case ESP_ZB_BDB_SIGNAL_DEVICE_FIRST_START:
     case ESP_ZB_BDB_SIGNAL_DEVICE_REBOOT:
         if (err_status == ESP_OK) {
+            boot_mark(BOOT_MARK_BDB_START);
             ESP_LOGI(TAG, "Device started up in%s factory-reset mode", esp_zb_bdb_is_factory_new() ? "" : " non");
             if (esp_zb_bdb_is_factory_new()) {
                 ESP_LOGI(TAG, "Start network steering");
                 esp_zb_bdb_start_top_level_commissioning(ESP_ZB_BDB_MODE_NETWORK_STEERING);
             } else {
                 ESP_LOGI(TAG, "Device rebooted");
+                // Network parameters restored from zb_storage: commands are accepted right away
+                zb_network_ready();
                 // Keep LED orange until we confirm network connectivity
                 // LED will turn off when we receive NWK_SIGNAL_PERMIT_JOIN_STATUS or DEVICE_ANNCE
             }
         } else {
             ESP_LOGW(TAG, "Device start failed with status: %s, retrying", esp_err_to_name(err_status));
             esp_zb_scheduler_alarm((esp_zb_callback_t)bdb_start_top_level_commissioning_cb,
-                                   ESP_ZB_BDB_MODE_INITIALIZATION, 1000);
+                                   ESP_ZB_BDB_MODE_INITIALIZATION, zb_next_retry_ms());
         }
         break;
 
@@ -196,10 +254,14 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct)
                      extended_pan_id[3], extended_pan_id[2], extended_pan_id[1], extended_pan_id[0],
                      esp_zb_get_pan_id(), esp_zb_get_current_channel(), esp_zb_get_short_address());
             led_off(); // Turn off startup LED when network join successful
+            boot_mark(BOOT_MARK_STEERING);
+            zb_network_ready();
         } else {
-            ESP_LOGI(TAG, "Network steering was not successful (status: %s), retrying", esp_err_to_name(err_status));
+            uint32_t delay_ms = zb_next_retry_ms();
+            ESP_LOGI(TAG, "Network steering was not successful (status: %s), retrying in %" PRIu32 " ms",
+                     esp_err_to_name(err_status), delay_ms);
             esp_zb_scheduler_alarm((esp_zb_callback_t)bdb_start_top_level_commissioning_cb,
-                                   ESP_ZB_BDB_MODE_NETWORK_STEERING, 1000);
+                                   ESP_ZB_BDB_MODE_NETWORK_STEERING, delay_ms);
         }
         break;
 
@@ -234,6 +296,8 @@ void esp_zb_app_signal_handler(esp_zb_app_signal_t *signal_struct)
 // ====== Zigbee Handlers ======
 esp_err_t zb_action_handler(esp_zb_core_action_callback_id_t callback_id, const void *message)
 {
+    // RF work is queued to the RF worker: the stack gets control back in microseconds
+    int64_t entry_us = esp_timer_get_time();
     esp_err_t ret = ESP_OK;
     switch (callback_id) {
     case ESP_ZB_CORE_CMD_CUSTOM_CLUSTER_REQ_CB_ID:
@@ -244,31 +308,27 @@ esp_err_t zb_action_handler(esp_zb_core_action_callback_id_t callback_id, const
             uint16_t cluster = cmd_msg->info.cluster;
             uint8_t command_id = cmd_msg->info.command.id;
             
-            ESP_LOGI(TAG, "Command received: cluster=0x%04x, cmd=0x%02x, endpoint=%d", 
-                     cluster, command_id, endpoint);
+            TRACE3(ZCL_CMD, cluster, command_id, endpoint);
             
             // On/Off cluster: react to on/off/toggle commands
             if (cluster == ESP_ZB_ZCL_CLUSTER_ID_ON_OFF) {
                 if (command_id == ESP_ZB_ZCL_CMD_ON_OFF_ON_ID || 
                     command_id == ESP_ZB_ZCL_CMD_ON_OFF_TOGGLE_ID) {
-                    ESP_LOGI(TAG, "On/Off command (on/toggle) on endpoint %d", endpoint);
-                    
-                    // Gérer le clic selon l'endpoint
-                    if (endpoint == BUTTON_1_ENDPOINT) {
-                        ESP_LOGI(TAG, "Button 1 clicked - Portail Principal");
-                        handle_button_click(BUTTON_1_ENDPOINT);
-                        // Lancer le timer pour reset on_off après 5 secondes (debounce)
-                        start_reset_timer(BUTTON_1_ENDPOINT);
-                    } else if (endpoint == BUTTON_2_ENDPOINT) {
-                        ESP_LOGI(TAG, "Button 2 clicked - Portail Parking");
-                        handle_button_click(BUTTON_2_ENDPOINT);
-                        // Lancer le timer pour reset on_off après 5 secondes (debounce)
-                        start_reset_timer(BUTTON_2_ENDPOINT);
-                    } else {
-                        ESP_LOGW(TAG, "Unknown endpoint clicked: %d", endpoint);
-                    }
+                    TRACE1(ON_OFF_CMD, endpoint);
+                    press_key_t key = {
+                        .has_key = true,
+                        .tsn = cmd_msg->info.header.tsn,
+                        .src_addr = cmd_msg->info.src_address.u.addr_short,
+                    };
+                    handle_on_off_trigger(endpoint, &key, entry_us);
                 }
             }
+
+            // ZB433 cluster: learning, code book and sequence commands
+            if (cluster == ZB433_MFR_CLUSTER_ID) {
+                ret = mfr_cluster_handle_command(endpoint, command_id, cmd_msg->data.value, cmd_msg->data.size,
+                                                 entry_us);
+            }
         }
         break;
         
@@ -277,30 +337,21 @@ esp_err_t zb_action_handler(esp_zb_core_action_callback_id_t callback_id, const
             esp_zb_zcl_set_attr_value_message_t *attr_msg = (esp_zb_zcl_set_attr_value_message_t *)message;
             uint8_t endpoint = attr_msg->info.dst_endpoint;
             
-            ESP_LOGI(TAG, "Attribute write: cluster=0x%04x, attr=0x%04x, endpoint=%d", 
-                     attr_msg->info.cluster, attr_msg->attribute.id, endpoint);
+            TRACE3(ATTR_WRITE, attr_msg->info.cluster, attr_msg->attribute.id, endpoint);
             
             // On/Off cluster: react to on_off attribute writes (fallback)
             if (attr_msg->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_ON_OFF &&
                 attr_msg->attribute.id == ESP_ZB_ZCL_ATTR_ON_OFF_ON_OFF_ID) {
-                ESP_LOGI(TAG, "On/Off value changed on endpoint %d", endpoint);
-                
-                // Gérer le clic selon l'endpoint
-                if (endpoint == BUTTON_1_ENDPOINT) {
-                    ESP_LOGI(TAG, "Button 1 clicked - Portail Principal");
-                    handle_button_click(BUTTON_1_ENDPOINT);
-                    // Lancer le timer pour reset on_off après 5 secondes (debounce)
-                    start_reset_timer(BUTTON_1_ENDPOINT);
-                } else if (endpoint == BUTTON_2_ENDPOINT) {
-                    ESP_LOGI(TAG, "Button 2 clicked - Portail Parking");
-                    handle_button_click(BUTTON_2_ENDPOINT);
-                    // Lancer le timer pour reset on_off après 5 secondes (debounce)
-                    start_reset_timer(BUTTON_2_ENDPOINT);
-                } else {
-                    ESP_LOGW(TAG, "Unknown endpoint clicked: %d", endpoint);
-                }
+                TRACE1(ON_OFF_WRITE, endpoint);
+                press_key_t key = {.has_key = false};
+                handle_on_off_trigger(endpoint, &key, entry_us);
             }
             
+            // ZB433 cluster: runtime configuration (trace levels)
+            if (attr_msg->info.cluster == ZB433_MFR_CLUSTER_ID) {
+                mfr_cluster_handle_write(endpoint, attr_msg->attribute.id, attr_msg->attribute.data.value);
+            }
+
             // Identify cluster: react to identify_time writes and play LED effect
             if (attr_msg->info.cluster == ESP_ZB_ZCL_CLUSTER_ID_IDENTIFY &&
                 attr_msg->attribute.id == ESP_ZB_ZCL_ATTR_IDENTIFY_IDENTIFY_TIME_ID) {
@@ -311,16 +362,23 @@ esp_err_t zb_action_handler(esp_zb_core_action_callback_id_t callback_id, const
                 }
                 ESP_LOGI(TAG, "Identify requested on EP%d for %u s (attr write)", endpoint, (unsigned)identify_seconds);
                 if (identify_seconds > 0) {
-                    led_identify_breathe();
+                    led_identify_breathe(identify_seconds * 1000u);
                 } else {
                     led_identify_okay();
                 }
             }
         }
         break;
+
+    case ESP_ZB_CORE_OTA_UPGRADE_VALUE_CB_ID:
+        // Firmware blocks go straight to the inactive OTA slot, between gate commands
+        ret = zb_ota_handle(message);
+        break;
+
     default:
         ESP_LOGD(TAG, "Receive Zigbee action(0x%x) callback", callback_id);
         break;
     }
+    TRACE2(ACTION_TIME, callback_id, (uint32_t)(esp_timer_get_time() - entry_us));
     return ret;
 }
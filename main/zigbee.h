@@ -12,6 +12,8 @@
 
 // ====== Zigbee Configuration ======
 #define ESP_ZB_AF_HA_PROFILE_ID 0x0104
+#define ZIGBEE_TASK_STACK 4096
+#define ZIGBEE_TASK_PRIORITY 5
 
 // ====== Function Prototypes ======
 void zigbee_init(void);
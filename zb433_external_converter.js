@@ -3,6 +3,188 @@ const exposes = require('zigbee-herdsman-converters/lib/exposes');
 const e = exposes.presets;
 const reporting = require('zigbee-herdsman-converters/lib/reporting');
 const {fromZigbee, toZigbee} = require('zigbee-herdsman-converters');
+const utils = require('zigbee-herdsman-converters/lib/utils');
+const {Zcl} = require('zigbee-herdsman');
+
+// Cluster fabricant 0xFC00 (mfr_cluster.h) : diagnostics sans equivalent ZCL standard
+const LATENCY_SEGMENTS = ['dispatch', 'queue', 'start', 'air', 'total', 'wake'];
+
+const fzLatency = {
+  cluster: 'zb433Diagnostics',
+  type: ['attributeReport', 'readResponse'],
+  convert: (model, msg, publish, options, meta) => {
+    if (msg.data.latency === undefined) return;
+    // Rapport (latency.h) : version, uint32 echantillons, puis {p50, p95, p99, max} en us par segment
+    // v1 : 5 segments, v2 : + 'wake' (reprise de la frequence CPU, gestion d'energie)
+    const buf = Buffer.from(msg.data.latency);
+    const segments = LATENCY_SEGMENTS.slice(0, buf[0] === 1 ? 5 : buf[0] === 2 ? 6 : 0);
+    if (segments.length === 0 || buf.length < 5 + segments.length * 16) return;
+    const latency = {samples: buf.readUInt32LE(1)};
+    segments.forEach((segment, i) => {
+      const offset = 5 + i * 16;
+      latency[segment] = {
+        p50_ms: buf.readUInt32LE(offset) / 1000,
+        p95_ms: buf.readUInt32LE(offset + 4) / 1000,
+        p99_ms: buf.readUInt32LE(offset + 8) / 1000,
+        max_ms: buf.readUInt32LE(offset + 12) / 1000,
+      };
+    });
+    return {
+      [utils.postfixWithEndpointName('latency', msg, model, meta)]: latency,
+      [utils.postfixWithEndpointName('latency_p95', msg, model, meta)]: latency.total.p95_ms,
+    };
+  },
+};
+
+// Appui (mfr_cluster.h, ZB433_MFR_CMD_PRESS_ID) : une trame par appui accepte, pas d'etat on_off a remettre a zero
+const fzPress = {
+  cluster: 'zb433Diagnostics',
+  type: ['commandPress'],
+  convert: (model, msg, publish, options, meta) => {
+    if (utils.hasAlreadyProcessedMessage(msg, model)) return;
+    return {action: `press_${utils.getEndpointName(msg, model, meta)}`, press_count: msg.data.count};
+  },
+};
+
+// Chronologie du demarrage (boot_timeline.h) : us depuis le boot, 0 = etape non atteinte
+const BOOT_MARKS = [
+  'app_start', 'led_init', 'nvs_init', 'gates_init', 'came_init', 'rf_tx_init',
+  'zb_task', 'zb_start', 'skip_startup', 'bdb_start', 'steering', 'ready',
+];
+
+const fzBootTimeline = {
+  cluster: 'zb433Diagnostics',
+  type: ['attributeReport', 'readResponse'],
+  convert: (model, msg, publish, options, meta) => {
+    if (msg.data.bootTimeline === undefined) return;
+    const buf = Buffer.from(msg.data.bootTimeline);
+    if (buf.length < 4 || buf[0] !== 1) return;
+    const timeline = {retries: buf.readUInt16LE(2)};
+    BOOT_MARKS.slice(0, buf[1]).forEach((mark, i) => {
+      if (buf.length >= 8 + i * 4) timeline[`${mark}_ms`] = buf.readUInt32LE(4 + i * 4) / 1000;
+    });
+    return {boot_timeline: timeline};
+  },
+};
+
+const tzBootTimeline = {
+  key: ['boot_timeline'],
+  convertGet: async (entity, key, meta) => {
+    await meta.device.getEndpoint(1).read('zb433Diagnostics', ['bootTimeline']);
+  },
+};
+
+// Sante du routeur (EP1) : cluster Diagnostics standard + attributs fabricant
+const fzHealth = {
+  cluster: 'zb433Diagnostics',
+  type: ['attributeReport', 'readResponse'],
+  convert: (model, msg, publish, options, meta) => {
+    const map = {
+      rfFramesSent: 'rf_frames_sent', rfFramesDropped: 'rf_frames_dropped', rfQueueDepth: 'rf_queue_depth',
+      heapFree: 'heap_free', heapMinFree: 'heap_min_free', zigbeeStackFree: 'zigbee_stack_free',
+      parentChanges: 'parent_changes', routeChanges: 'route_changes',
+      neighbors: 'neighbors', children: 'children', routes: 'routes', tableFull: 'table_full',
+      zigbeeHeap: 'zigbee_heap', lateAllocs: 'late_allocs',
+      codebookCount: 'codebook_count', codebookGeneration: 'codebook_generation',
+    };
+    const result = {};
+    for (const [attr, key] of Object.entries(map)) {
+      if (msg.data[attr] !== undefined) result[key] = msg.data[attr];
+    }
+    return result;
+  },
+};
+
+const fzDiagnostics = {
+  cluster: 'haDiagnostic',
+  type: ['attributeReport', 'readResponse'],
+  convert: (model, msg, publish, options, meta) => {
+    const map = {
+      numberOfResets: 'resets', neighborAdded: 'neighbor_added', neighborRemoved: 'neighbor_removed',
+    };
+    const result = {};
+    for (const [attr, key] of Object.entries(map)) {
+      if (msg.data[attr] !== undefined) result[key] = msg.data[attr];
+    }
+    return result;
+  },
+};
+
+const tzLatency = {
+  key: ['latency_p95'],
+  convertGet: async (entity, key, meta) => {
+    await entity.read('zb433Diagnostics', ['latency']);
+  },
+};
+
+// Apprentissage 433MHz : le routeur ecoute la telecommande pendant 'timeout' secondes
+const tzLearn = {
+  key: ['learn'],
+  convertSet: async (entity, key, value, meta) => {
+    // {"learn": {"tx": 1}} associe le portail au second emetteur, sinon l'emetteur actuel est garde
+    const tx = (typeof value === 'object' && value.tx !== undefined) ? value.tx : 0xff;
+    await entity.command('zb433Diagnostics', 'learn', {timeout: 30, tx}, {disableDefaultResponse: false});
+  },
+};
+
+// Carnet de codes (codebook.h) : ecrit dans la banque inactive par paquets, active au commit
+const CODEBOOK_ENTRIES_PER_WRITE = 8;   // 8 x 8 octets : tient dans une trame ZCL
+
+const crc32 = (buf) => {
+  let crc = 0xffffffff;
+  for (const byte of buf) {
+    crc ^= byte;
+    for (let i = 0; i < 8; i++) crc = (crc >>> 1) ^ (0xedb88320 & -(crc & 1));
+  }
+  return (crc ^ 0xffffffff) >>> 0;
+};
+
+// Entree : {protocol, code, repeats?, te_us?} -> 8 octets little endian (codebook_entry_t)
+const encodeCodebook = (entries) => {
+  const buf = Buffer.alloc(entries.length * 8);
+  entries.forEach((entry, i) => {
+    buf.writeUInt8(entry.protocol, i * 8);
+    buf.writeUInt8(entry.repeats || 0, i * 8 + 1);
+    buf.writeUInt16LE(entry.te_us || 0, i * 8 + 2);
+    buf.writeUInt32LE(entry.code >>> 0, i * 8 + 4);
+  });
+  return buf;
+};
+
+const tzCodebook = {
+  key: ['codebook', 'send_code'],
+  convertSet: async (entity, key, value, meta) => {
+    if (key === 'send_code') {
+      await entity.command('zb433Diagnostics', 'sendCode', {index: value}, {disableDefaultResponse: false});
+      return;
+    }
+    const buf = encodeCodebook(value);
+    const ep1 = meta.device.getEndpoint(1);
+    await ep1.command('zb433Diagnostics', 'codebookBegin', {count: value.length}, {disableDefaultResponse: false});
+    for (let first = 0; first < value.length; first += CODEBOOK_ENTRIES_PER_WRITE) {
+      const chunk = buf.subarray(first * 8, Math.min(value.length, first + CODEBOOK_ENTRIES_PER_WRITE) * 8);
+      await ep1.command('zb433Diagnostics', 'codebookWrite', {first, entries: [...chunk]}, {disableDefaultResponse: false});
+    }
+    await ep1.command('zb433Diagnostics', 'codebookCommit', {crc: crc32(buf)}, {disableDefaultResponse: false});
+    await ep1.read('zb433Diagnostics', ['codebookCount', 'codebookGeneration']);
+  },
+};
+
+// Scene : [{endpoint, code?, repeats?, gap_ms?}] -> une seule transaction RMT (6 octets par etape)
+const tzSequence = {
+  key: ['sequence'],
+  convertSet: async (entity, key, value, meta) => {
+    const steps = Buffer.alloc(value.length * 6);
+    value.forEach((step, i) => {
+      steps.writeUInt8(step.endpoint, i * 6);
+      steps.writeUInt16LE(step.code !== undefined ? step.code : 0xffff, i * 6 + 1);
+      steps.writeUInt8(step.repeats || 0, i * 6 + 3);
+      steps.writeUInt16LE(step.gap_ms || 0, i * 6 + 4);
+    });
+    await meta.device.getEndpoint(1).command('zb433Diagnostics', 'sequence',
+      {count: value.length, steps: [...steps]}, {disableDefaultResponse: false});
+  },
+};
 
 module.exports = [{
   fingerprint: [
@@ -14,6 +196,44 @@ module.exports = [{
   description: 'CAME 433 TX Router',
   extend: [
     m.deviceEndpoints({endpoints: {portail_principal: 1, portail_parking: 2}}),
+    m.deviceAddCustomCluster('zb433Diagnostics', {
+      ID: 0xfc00,
+      attributes: {
+        latency: {ID: 0x0000, type: Zcl.DataType.OCTET_STR},
+        rfFramesSent: {ID: 0x0010, type: Zcl.DataType.UINT32},
+        rfFramesDropped: {ID: 0x0011, type: Zcl.DataType.UINT32},
+        rfQueueDepth: {ID: 0x0012, type: Zcl.DataType.UINT8},
+        heapFree: {ID: 0x0013, type: Zcl.DataType.UINT32},
+        heapMinFree: {ID: 0x0014, type: Zcl.DataType.UINT32},
+        zigbeeStackFree: {ID: 0x0015, type: Zcl.DataType.UINT32},
+        parentChanges: {ID: 0x0016, type: Zcl.DataType.UINT16},
+        routeChanges: {ID: 0x0017, type: Zcl.DataType.UINT16},
+        neighbors: {ID: 0x0018, type: Zcl.DataType.UINT16},
+        children: {ID: 0x0019, type: Zcl.DataType.UINT16},
+        routes: {ID: 0x001A, type: Zcl.DataType.UINT16},
+        tableFull: {ID: 0x001B, type: Zcl.DataType.UINT16},
+        zigbeeHeap: {ID: 0x001C, type: Zcl.DataType.UINT32},
+        lateAllocs: {ID: 0x001D, type: Zcl.DataType.UINT32},
+        codebookCount: {ID: 0x0021, type: Zcl.DataType.UINT16},
+        codebookGeneration: {ID: 0x0022, type: Zcl.DataType.UINT32},
+        bootTimeline: {ID: 0x0023, type: Zcl.DataType.OCTET_STR},
+      },
+      commands: {
+        learn: {ID: 0x00, parameters: [{name: 'timeout', type: Zcl.DataType.UINT16}, {name: 'tx', type: Zcl.DataType.UINT8}]},
+        sendCode: {ID: 0x01, parameters: [{name: 'index', type: Zcl.DataType.UINT16}]},
+        codebookBegin: {ID: 0x02, parameters: [{name: 'count', type: Zcl.DataType.UINT16}]},
+        codebookWrite: {ID: 0x03, parameters: [
+          {name: 'first', type: Zcl.DataType.UINT16}, {name: 'entries', type: Zcl.BuffaloZclDataType.LIST_UINT8},
+        ]},
+        codebookCommit: {ID: 0x04, parameters: [{name: 'crc', type: Zcl.DataType.UINT32}]},
+        sequence: {ID: 0x05, parameters: [
+          {name: 'count', type: Zcl.DataType.UINT8}, {name: 'steps', type: Zcl.BuffaloZclDataType.LIST_UINT8},
+        ]},
+      },
+      commandsResponse: {
+        press: {ID: 0x00, parameters: [{name: 'count', type: Zcl.DataType.UINT16}]},
+      },
+    }),
     // Ne pas utiliser m.onOff() pour éviter les switches automatiques
   ],
   exposes: [
@@ -23,11 +243,56 @@ module.exports = [{
       .withEndpoint('portail_principal').withDescription('Commande du portail Principal'),
     e.enum('portail_parking', exposes.access.SET, ['press'])
       .withEndpoint('portail_parking').withDescription('Commande du portail Parking'),
+    // Evenement par appui (remplace le rapport on_off + remise a zero)
+    e.action(['press_portail_principal', 'press_portail_parking']),
+    // Latence commande -> fin d'emission RF (p95, ms) ; le detail par etape est publie dans 'latency'
+    e.numeric('latency_p95', exposes.access.STATE_GET).withUnit('ms')
+      .withEndpoint('portail_principal').withDescription('Latence p95 commande -> RF'),
+    e.numeric('latency_p95', exposes.access.STATE_GET).withUnit('ms')
+      .withEndpoint('portail_parking').withDescription('Latence p95 commande -> RF'),
+    // Necessite un recepteur 433MHz (CONFIG_ZB433_RX_GPIO)
+    e.enum('learn', exposes.access.SET, ['start'])
+      .withEndpoint('portail_principal').withDescription('Apprendre le code de la telecommande (30 s)'),
+    e.enum('learn', exposes.access.SET, ['start'])
+      .withEndpoint('portail_parking').withDescription('Apprendre le code de la telecommande (30 s)'),
+    // Carnet de codes : envoi d'une entree avec les reglages du portail, chargement en bloc sur EP1
+    e.numeric('send_code', exposes.access.SET).withEndpoint('portail_principal')
+      .withDescription('Envoyer l\'entree N du carnet de codes'),
+    e.numeric('send_code', exposes.access.SET).withEndpoint('portail_parking')
+      .withDescription('Envoyer l\'entree N du carnet de codes'),
+    e.numeric('codebook_count', exposes.access.STATE).withDescription('Codes dans le carnet'),
+    e.numeric('codebook_generation', exposes.access.STATE).withDescription('Version du carnet de codes'),
+    e.numeric('rf_frames_sent', exposes.access.STATE).withDescription('Salves 433MHz emises'),
+    e.numeric('rf_frames_dropped', exposes.access.STATE).withDescription('Salves refusees (file pleine) ou en echec'),
+    e.numeric('rf_queue_depth', exposes.access.STATE).withDescription('Salves en attente de temps d\'antenne'),
+    e.numeric('heap_free', exposes.access.STATE).withUnit('B').withDescription('Heap libre'),
+    e.numeric('heap_min_free', exposes.access.STATE).withUnit('B').withDescription('Heap libre minimum depuis le boot'),
+    e.numeric('zigbee_stack_free', exposes.access.STATE).withUnit('B').withDescription('Marge de pile de la tache Zigbee_main'),
+    e.numeric('parent_changes', exposes.access.STATE).withDescription('Changements de parent'),
+    e.numeric('route_changes', exposes.access.STATE).withDescription('Routes ajoutees ou modifiees'),
+    e.numeric('neighbors', exposes.access.STATE).withDescription('Entrees de la table des voisins'),
+    e.numeric('children', exposes.access.STATE).withDescription('Enfants rattaches au routeur'),
+    e.numeric('routes', exposes.access.STATE).withDescription('Entrees de la table de routage'),
+    e.numeric('table_full', exposes.access.STATE).withDescription('Tables pleines (voisins, enfants, routes) depuis le boot'),
+    e.numeric('zigbee_heap', exposes.access.STATE).withUnit('B').withDescription('Heap pris par les tables de la pile Zigbee'),
+    e.numeric('late_allocs', exposes.access.STATE)
+      .withDescription('Allocations heap apres le demarrage (mode zero-heap, doit rester a 0)'),
+    e.numeric('resets', exposes.access.STATE).withDescription('Nombre de redemarrages'),
+    e.numeric('neighbor_added', exposes.access.STATE).withDescription('Voisins ajoutes'),
+    e.numeric('neighbor_removed', exposes.access.STATE).withDescription('Voisins perdus'),
   ],
+  fromZigbee: [fzPress, fzLatency, fzHealth, fzDiagnostics, fzBootTimeline],
+  // Client OTA (zb_ota.c) : image 0x131B/0x0433 servie par l'index OTA de Z2M
+  ota: true,
   meta: {
     multiEndpoint: true,
   },
   toZigbee: [
+    tzLatency,
+    tzLearn,
+    tzCodebook,
+    tzBootTimeline,
+    tzSequence,
     {
       key: ['portail_principal', 'portail_parking', 'state'],  // Gérer les deux endpoints et 'state' pour masquer les switches
       convertSet: async (entity, key, value, meta) => {
@@ -62,10 +327,26 @@ module.exports = [{
   ],
   configure: async (device, coordinatorEndpoint, logger) => {
     const ep1 = device.getEndpoint(1), ep2 = device.getEndpoint(2);
-    // Bind les clusters On/Off
-    await reporting.bind(ep1, coordinatorEndpoint, ['genOnOff']);
-    await reporting.bind(ep2, coordinatorEndpoint, ['genOnOff']);
-    await reporting.onOff(ep1);
-    await reporting.onOff(ep2);
+    // Les appuis arrivent en evenements (fzPress) : couper le reporting on_off des appareils deja appaires
+    // (intervalle max 0xFFFF = pas de rapport, ZCL 2.5.7.1.6)
+    const noReport = [{attribute: 'onOff', minimumReportInterval: 0, maximumReportInterval: 0xffff, reportableChange: 0}];
+    await ep1.configureReporting('genOnOff', noReport);
+    await ep2.configureReporting('genOnOff', noReport);
+    // Sante du routeur : reporting pousse par le device (pas de polling)
+    await reporting.bind(ep1, coordinatorEndpoint, ['haDiagnostic', 'zb433Diagnostics']);
+    // Les notifications press suivent la table de liaison : chaque endpoint de portail lie son cluster 0xFC00
+    await reporting.bind(ep2, coordinatorEndpoint, ['zb433Diagnostics']);
+    const report = (attribute, reportableChange) =>
+      ({attribute, minimumReportInterval: 60, maximumReportInterval: 3600, reportableChange});
+    await ep1.configureReporting('haDiagnostic', [
+      report('numberOfResets', 1), report('neighborAdded', 1), report('neighborRemoved', 1),
+    ]);
+    await ep1.configureReporting('zb433Diagnostics', [
+      report('rfFramesSent', 10), report('rfFramesDropped', 1), report('rfQueueDepth', 1),
+      report('heapFree', 4096), report('heapMinFree', 1024), report('zigbeeStackFree', 64),
+      report('parentChanges', 1), report('routeChanges', 1),
+      report('neighbors', 1), report('children', 1), report('routes', 1), report('tableFull', 1),
+    ]);
+    await ep1.read('zb433Diagnostics', ['zigbeeHeap']);
   },
 }];